@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <print>
+#include <string_view>
+#include <vector>
+
+namespace fae::benchmarks
+{
+    /* keeps the compiler from optimizing away the computation of value */
+    template <typename t_value>
+    inline auto do_not_optimize(const t_value& value) noexcept -> void
+    {
+#if defined(_MSC_VER)
+        static const volatile void* sink = nullptr;
+        sink = &value;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    /*
+    times body, which does operations of the measured thing, samples times (after one warm up run)
+    prints & returns the median time per operation, in nanoseconds
+    */
+    template <typename t_body>
+    auto run(std::string_view name, std::size_t operations, t_body&& body, std::size_t samples = 15) -> double
+    {
+        body();
+        auto times = std::vector<double>(samples);
+        for (auto& time : times)
+        {
+            const auto begin = std::chrono::steady_clock::now();
+            body();
+            time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / static_cast<double>(operations);
+        }
+        std::ranges::sort(times);
+        const auto median = times[times.size() / 2];
+        std::println("{:<64} {:>12.2f} ns/op {:>16.0f} op/s", name, median, median > 0.0 ? 1e9 / median : 0.0);
+        return median;
+    }
+}
@@ -0,0 +1,85 @@
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <print>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "fae/ecs_world.hpp"
+#include "fae/job_system.hpp"
+#include "fae/math.hpp"
+
+namespace
+{
+    struct velocity
+    {
+        fae::vec3 value{ 1.f, 0.f, 0.f };
+    };
+
+    auto work(float value) noexcept -> float
+    {
+        return std::sqrt(value) * std::sin(value) + std::cos(value);
+    }
+}
+
+auto main() -> int
+{
+    auto jobs = fae::job_system{};
+    std::println("{} workers", jobs.worker_count());
+
+    // fork/join overhead, chunks that do nothing
+    constexpr std::size_t calls = 1'000;
+    for (const std::size_t chunks : { 1, 8, 64, 512 })
+    {
+        fae::benchmarks::run(std::format("parallel_for of {} empty chunks", chunks), calls, [&]
+            {
+                for (std::size_t i = 0; i < calls; ++i)
+                {
+                    jobs.parallel_for(chunks, 1, [](std::size_t begin, std::size_t end)
+                        { fae::benchmarks::do_not_optimize(begin + end); });
+                }
+            });
+    }
+
+    auto values = std::vector<float>(std::size_t{ 1 } << 22, 2.f);
+    fae::benchmarks::run(std::format("serial loop over {} floats", values.size()), values.size(), [&]
+        {
+            for (auto& value : values)
+            {
+                value = work(value);
+            }
+            fae::benchmarks::do_not_optimize(values.front());
+        });
+    for (const std::size_t grain : { 256, 4'096, 65'536 })
+    {
+        fae::benchmarks::run(std::format("parallel_for over {} floats, grain {}", values.size(), grain), values.size(), [&]
+            {
+                jobs.parallel_for(values.size(), grain, [&](std::size_t begin, std::size_t end)
+                    {
+                        for (auto i = begin; i < end; ++i)
+                        {
+                            values[i] = work(values[i]);
+                        } });
+                fae::benchmarks::do_not_optimize(values.front());
+            });
+    }
+
+    for (const std::size_t count : { 100'000, 1'000'000 })
+    {
+        auto world = fae::ecs_world{ .jobs = &jobs };
+        auto ids = std::vector<fae::entity>(count);
+        world.registry.create(ids.begin(), ids.end());
+        world.registry.insert<fae::transform>(ids.begin(), ids.end(), fae::transform{});
+        world.registry.insert<velocity>(ids.begin(), ids.end(), velocity{});
+
+        auto move = [](fae::entity, fae::transform& transform, const velocity& velocity)
+        {
+            transform.position += velocity.value;
+            transform.rotation = fae::math::normalize(transform.rotation * fae::math::angleAxis(0.01f, velocity.value));
+        };
+        fae::benchmarks::run(std::format("entt view each, {} entities", count), count, [&]
+            { world.registry.view<fae::transform, const velocity>().each(move); });
+        fae::benchmarks::run(std::format("par_each, {} entities", count), count, [&]
+            { world.par_each<fae::transform, const velocity>(move); });
+    }
+}
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <format>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fae/logging.hpp"
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    /* not a deferred log argument, so log calls format it themselves */
+    struct position
+    {
+        float x = 0.f;
+        float y = 0.f;
+        float z = 0.f;
+    };
+
+    constexpr std::size_t batch_size = 256;
+    constexpr std::size_t batches = 200;
+
+    /*
+    prints the mean, 99th percentile & worst time of one call, in nanoseconds
+    logs are flushed between batches (untimed), so calls measure queueing & not waiting for a full queue
+    */
+    template <typename t_call>
+    auto measure_calls(std::string_view name, t_call&& call) -> void
+    {
+        auto times = std::vector<double>{};
+        times.reserve(batch_size * batches);
+        for (std::size_t batch = 0; batch < batches; ++batch)
+        {
+            for (std::size_t i = 0; i < batch_size; ++i)
+            {
+                const auto begin = clock::now();
+                call(i);
+                const auto end = clock::now();
+                times.push_back(std::chrono::duration<double, std::nano>(end - begin).count());
+            }
+            fae::flush_logs();
+        }
+
+        auto mean = 0.0;
+        for (auto time : times)
+        {
+            mean += time / static_cast<double>(times.size());
+        }
+        std::ranges::sort(times);
+        std::println(stderr, "{:<64} {:>9.1f} ns mean {:>9.1f} ns p99 {:>9.1f} ns worst", name, mean, times[times.size() * 99 / 100], times.back());
+    }
+}
+
+template <>
+struct std::formatter<position> : std::formatter<float>
+{
+    auto format(const position& position, auto& ctx) const
+    {
+        return std::format_to(ctx.out(), "({}, {}, {})", position.x, position.y, position.z);
+    }
+};
+
+// the written log lines go to stdout & the results to stderr, run with stdout redirected (e.g. > /dev/null) to only see the results
+auto main() -> int
+{
+    if constexpr (!fae::is_log_level_enabled(fae::log_level::info))
+    {
+        // release builds compile log calls out, build with RelWithDebInfo instead
+        std::println(stderr, "info logs are disabled in this build, nothing to measure");
+        return 0;
+    }
+
+    const auto path = std::string{ "assets/models/character.glb" };
+
+    measure_calls("log_info(literal)", [](std::size_t)
+        { fae::log_info("frame done"); });
+    measure_calls("log_info(format, int, float)", [](std::size_t i)
+        { fae::log_info("entity {} moved {:.2f}", i, 1.5f); });
+    measure_calls("log_info(format, std::string)", [&](std::size_t)
+        { fae::log_info("loaded {}", path); });
+    measure_calls("log_info(format, user type) (formatted by the call)", [](std::size_t i)
+        { fae::log_info("entity at {}", position{ .x = static_cast<float>(i) }); });
+    measure_calls("std::println(stdout, format, int, float) (reference)", [](std::size_t i)
+        { std::println("entity {} moved {:.2f}", i, 1.5f); });
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "fae/ecs_world.hpp"
+#include "fae/transform_hierarchy.hpp"
+
+namespace
+{
+    // stand ins for model & visibility, which the benchmark does not need a renderer for
+    struct drawable
+    {
+        std::uint64_t mesh = 0;
+        std::uint64_t material = 0;
+    };
+
+    struct visible
+    {
+        bool value = true;
+    };
+
+    auto mix(std::uint64_t value) noexcept -> std::uint64_t
+    {
+        value += 0x9e3779b97f4a7c15ull;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+    /* a random order of the entities that changes with seed */
+    auto shuffled_key(fae::entity id, std::uint64_t seed) noexcept -> std::uint64_t
+    {
+        return mix(static_cast<std::uint64_t>(entt::to_integral(id)) ^ seed);
+    }
+
+    /* like fae::benchmarks::run, but setup runs untimed before every sample */
+    template <typename t_setup, typename t_body>
+    auto run_with_setup(std::string_view name, std::size_t operations, t_setup&& setup, t_body&& body, std::size_t samples = 15) -> void
+    {
+        auto times = std::vector<double>(samples);
+        for (auto& time : times)
+        {
+            setup();
+            const auto begin = std::chrono::steady_clock::now();
+            body();
+            time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / static_cast<double>(operations);
+        }
+        std::ranges::sort(times);
+        const auto median = times[times.size() / 2];
+        std::println("{:<64} {:>12.2f} ns/op {:>16.0f} op/s", name, median, median > 0.0 ? 1e9 / median : 0.0);
+    }
+}
+
+// what extract_render_snapshot does when the model group has to follow the global_transform pool again
+auto main() -> int
+{
+    for (const std::size_t count : { 100'000, 1'000'000 })
+    {
+        auto world = fae::ecs_world{};
+        auto& registry = world.registry;
+        auto group = registry.group<drawable, visible>();
+        const auto ids = world.spawn_batch(count, fae::global_transform{}, drawable{}, visible{});
+        // the global_transform pool in an order unrelated to creation, like one sorted by depth
+        registry.sort<fae::global_transform>([&](const fae::entity lhs, const fae::entity rhs)
+            { return shuffled_key(lhs, 1) < shuffled_key(rhs, 1); });
+        const auto& globals = registry.storage<fae::global_transform>();
+        auto index_of = [&](fae::entity id)
+        { return globals.index(id); };
+
+        auto seed = std::uint64_t{ 2 };
+        auto shuffle_group = [&]
+        {
+            ++seed;
+            group.sort([&](const fae::entity lhs, const fae::entity rhs)
+                { return shuffled_key(lhs, seed) < shuffled_key(rhs, seed); });
+        };
+        auto sort_group = [&]
+        {
+            group.sort([&](const fae::entity lhs, const fae::entity rhs)
+                { return index_of(lhs) < index_of(rhs); });
+        };
+        auto walk = [&]
+        {
+            auto sum = 0.f;
+            for (auto [id, item, visibility] : group.each())
+            {
+                if (visibility.value)
+                {
+                    sum += globals.get(id).matrix[3][0];
+                }
+            }
+            fae::benchmarks::do_not_optimize(sum);
+        };
+
+        run_with_setup(std::format("sort model group like global_transform, {} models", count), count, shuffle_group, sort_group);
+        run_with_setup(std::format("walk models & global_transform, unsorted, {} models", count), count, shuffle_group, walk);
+        run_with_setup(std::format("walk models & global_transform, sorted, {} models", count), count, [&]
+            {
+                shuffle_group();
+                sort_group();
+            },
+            walk);
+        fae::benchmarks::do_not_optimize(ids.data());
+    }
+}
@@ -0,0 +1,72 @@
+#include <cstddef>
+#include <format>
+
+#include "benchmark.hpp"
+#include "fae/ecs_world.hpp"
+#include "fae/math.hpp"
+
+namespace
+{
+    struct velocity
+    {
+        fae::vec3 value{ 1.f, 0.f, 0.f };
+    };
+
+    struct hidden
+    {
+    };
+}
+
+auto main() -> int
+{
+    for (const std::size_t count : { 10'000, 100'000, 1'000'000 })
+    {
+        auto world = fae::ecs_world{};
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto entity = world.create_entity();
+            entity
+                .set_component<fae::transform>(fae::transform{})
+                .set_component<velocity>(velocity{});
+            if (i % 4 == 0)
+            {
+                world.registry.emplace<hidden>(entity.id);
+            }
+        }
+
+        fae::benchmarks::run(std::format("query<transform, velocity>() (copied), {} entities", count), count, [&]
+            {
+                for (auto& [entity, transform, velocity] : world.query<fae::transform, const velocity>())
+                {
+                    transform.position += velocity.value;
+                }
+            });
+        fae::benchmarks::run(std::format("query_frame<transform, velocity>() (copied), {} entities", count), count, [&]
+            {
+                world.frame_memory.next_frame();
+                for (auto& [entity, transform, velocity] : world.query_frame<fae::transform, const velocity>())
+                {
+                    transform.position += velocity.value;
+                }
+            });
+        fae::benchmarks::run(std::format("view<transform, velocity>(), {} entities", count), count, [&]
+            {
+                for (auto [entity, transform, velocity] : world.view<fae::transform, const velocity>())
+                {
+                    transform.position += velocity.value;
+                }
+            });
+        fae::benchmarks::run(std::format("view<transform, velocity>(exclude<hidden>), {} entities", count), count, [&]
+            {
+                for (auto [entity, transform, velocity] : world.view<fae::transform, const velocity>(entt::exclude<hidden>))
+                {
+                    transform.position += velocity.value;
+                }
+            });
+        fae::benchmarks::run(std::format("entt view each (baseline), {} entities", count), count, [&]
+            {
+                world.registry.view<fae::transform, const velocity>().each([](fae::transform& transform, const velocity& velocity)
+                    { transform.position += velocity.value; });
+            });
+    }
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <memory_resource>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "fae/rendering/render_thread.hpp"
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    /* stands in for simulating a frame or submitting one, which the benchmark does not need a gpu for */
+    auto busy_for(std::chrono::microseconds duration) -> void
+    {
+        const auto end = clock::now() + duration;
+        while (clock::now() < end)
+        {
+        }
+    }
+
+    /* prints the mean & 99th percentile time of a frame that simulates for simulate & then hands a submission of submit to the render thread */
+    auto run_frames(std::string_view name, bool pipelined, std::chrono::microseconds simulate, std::chrono::microseconds submit) -> void
+    {
+        constexpr std::size_t frames = 500;
+        auto render_thread = fae::render_thread{ pipelined };
+        auto times = std::vector<double>(frames);
+        for (auto& time : times)
+        {
+            const auto begin = clock::now();
+            busy_for(simulate);
+            render_thread.wait();
+            render_thread.submit([submit](std::pmr::memory_resource&)
+                { busy_for(submit); });
+            time = std::chrono::duration<double, std::micro>(clock::now() - begin).count();
+        }
+        render_thread.wait();
+
+        auto mean = 0.0;
+        for (auto time : times)
+        {
+            mean += time / static_cast<double>(times.size());
+        }
+        std::ranges::sort(times);
+        std::println("{:<64} {:>9.1f} us mean {:>9.1f} us p99", name, mean, times[times.size() * 99 / 100]);
+    }
+}
+
+// with a core free for the render thread, a pipelined frame takes about the longer of the two costs instead of their sum
+auto main() -> int
+{
+    using std::chrono::microseconds;
+    for (const auto [simulate, submit] : { std::pair{ 2000, 2000 }, std::pair{ 3000, 1000 }, std::pair{ 1000, 3000 } })
+    {
+        for (const auto pipelined : { false, true })
+        {
+            run_frames(std::format("simulate {} us, submit {} us, {}", simulate, submit, pipelined ? "pipelined" : "not pipelined"), pipelined, microseconds(simulate), microseconds(submit));
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "fae/ecs_world.hpp"
+#include "fae/run_condition.hpp"
+#include "fae/scheduler.hpp"
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    struct frame
+    {
+        fae::ecs_world& ecs_world;
+    };
+
+    struct settings
+    {
+        std::size_t system_count = 8;
+        /* work done by each system every time it runs */
+        std::chrono::microseconds system_cost{ 100 };
+        /* frames are paced to this period, the throttled rates below are relative to it */
+        std::chrono::microseconds frame_period{ 1000 };
+        std::size_t frames = 2000;
+    };
+
+    auto busy_for(std::chrono::microseconds duration) -> void
+    {
+        const auto end = clock::now() + duration;
+        while (clock::now() < end)
+        {
+        }
+    }
+
+    /*
+    prints the mean, 99th percentile & worst time of invoking the scheduler's frame, in microseconds
+    make_condition is called per system, so staggered systems each get their own phase
+    */
+    template <typename t_make_condition>
+    auto run_frames(std::string_view name, const settings& settings, t_make_condition&& make_condition) -> void
+    {
+        auto world = fae::ecs_world{};
+        auto scheduler = fae::scheduler{};
+        for (std::size_t i = 0; i < settings.system_count; ++i)
+        {
+            scheduler.add_system<frame>([&](const frame&)
+                { busy_for(settings.system_cost); },
+                make_condition());
+        }
+
+        auto times = std::vector<double>(settings.frames);
+        for (auto& time : times)
+        {
+            const auto begin = clock::now();
+            scheduler.invoke(frame{ .ecs_world = world });
+            const auto end = clock::now();
+            time = std::chrono::duration<double, std::micro>(end - begin).count();
+            while (clock::now() < begin + settings.frame_period)
+            {
+            }
+        }
+
+        auto mean = 0.0;
+        for (auto time : times)
+        {
+            mean += time / static_cast<double>(times.size());
+        }
+        std::ranges::sort(times);
+        std::println("{:<64} {:>9.1f} us mean {:>9.1f} us p99 {:>9.1f} us worst", name, mean, times[times.size() * 99 / 100], times.back());
+    }
+}
+
+auto main() -> int
+{
+    const auto settings = ::settings{};
+    // 200hz with 1ms frames runs every system on one frame in five
+    run_frames("8 systems, every frame", settings, []
+        { return fae::run_condition{}; });
+    run_frames("8 systems, at_hz(200)", settings, []
+        { return fae::run_condition{}.at_hz(200.0); });
+    run_frames("8 systems, at_hz(200).staggered()", settings, []
+        { return fae::run_condition{}.at_hz(200.0).staggered(); });
+}
@@ -0,0 +1,53 @@
+#include <cstddef>
+#include <cstdint>
+#include <format>
+
+#include "benchmark.hpp"
+#include "fae/scheduler.hpp"
+
+namespace
+{
+    struct tick
+    {
+        std::uint64_t* counter = nullptr;
+    };
+
+    auto count_tick(const tick& step) -> void
+    {
+        ++*step.counter;
+    }
+}
+
+auto main() -> int
+{
+    auto counter = std::uint64_t{ 0 };
+    constexpr std::size_t invokes = 10'000;
+
+    for (const std::size_t system_count : { 0, 1, 16, 256 })
+    {
+        auto functions = fae::scheduler{};
+        auto lambdas = fae::scheduler{};
+        for (std::size_t i = 0; i < system_count; ++i)
+        {
+            functions.add_system<tick>(count_tick);
+            lambdas.add_system<tick>([offset = i](const tick& step)
+                { *step.counter += offset; });
+        }
+
+        fae::benchmarks::run(std::format("invoke, {} function systems", system_count), invokes, [&]
+            {
+                for (std::size_t i = 0; i < invokes; ++i)
+                {
+                    functions.invoke(tick{ .counter = &counter });
+                }
+            });
+        fae::benchmarks::run(std::format("invoke, {} capturing lambda systems", system_count), invokes, [&]
+            {
+                for (std::size_t i = 0; i < invokes; ++i)
+                {
+                    lambdas.invoke(tick{ .counter = &counter });
+                }
+            });
+    }
+    fae::benchmarks::do_not_optimize(counter);
+}
@@ -0,0 +1,73 @@
+#include <cstddef>
+#include <format>
+
+#include "benchmark.hpp"
+#include "fae/ecs_world.hpp"
+#include "fae/math.hpp"
+#include "fae/prefab.hpp"
+
+namespace
+{
+    struct velocity
+    {
+        fae::vec3 value{ 1.f, 0.f, 0.f };
+    };
+
+    struct health
+    {
+        float value = 100.f;
+    };
+
+    struct enemy
+    {
+    };
+}
+
+// every sample spawns into a new world (its construction & destruction are timed too, the same for every variant)
+auto main() -> int
+{
+    for (const std::size_t count : { 1'000, 100'000, 1'000'000 })
+    {
+        fae::benchmarks::run(std::format("create_entity + set_component, {} entities", count), count, [&]
+            {
+                auto world = fae::ecs_world{};
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    auto entity = world.create_entity();
+                    entity
+                        .set_component<fae::transform>(fae::transform{})
+                        .set_component<velocity>(velocity{})
+                        .set_component<health>(health{});
+                    world.registry.emplace<enemy>(entity.id);
+                }
+                fae::benchmarks::do_not_optimize(world.registry.storage<health>().size());
+            });
+        fae::benchmarks::run(std::format("spawn_batch(count, components...), {} entities", count), count, [&]
+            {
+                auto world = fae::ecs_world{};
+                const auto ids = world.spawn_batch(count, fae::transform{}, velocity{}, health{}, enemy{});
+                fae::benchmarks::do_not_optimize(ids.data());
+            });
+
+        const auto prefab = fae::prefab{}
+                                .with(fae::transform{})
+                                .with(velocity{})
+                                .with(health{})
+                                .with(enemy{});
+        fae::benchmarks::run(std::format("spawn_batch(prefab, count), {} entities", count), count, [&]
+            {
+                auto world = fae::ecs_world{};
+                const auto ids = world.spawn_batch(prefab, count);
+                fae::benchmarks::do_not_optimize(ids.data());
+            });
+        fae::benchmarks::run(std::format("spawn(prefab) per entity, {} entities", count), count, [&]
+            {
+                auto world = fae::ecs_world{};
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    [[maybe_unused]] auto entity = world.spawn(prefab);
+                }
+                fae::benchmarks::do_not_optimize(world.registry.storage<health>().size());
+            });
+    }
+}
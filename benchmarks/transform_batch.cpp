@@ -0,0 +1,79 @@
+#include <cstddef>
+#include <format>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "fae/math.hpp"
+#include "fae/transform_batch.hpp"
+
+// op/s is matrices per second
+auto main() -> int
+{
+    auto random = std::mt19937(42);
+    auto value = std::uniform_real_distribution<float>(-1.f, 1.f);
+    for (const std::size_t count : { 1'000, 100'000, 1'000'000 })
+    {
+        auto transforms = std::vector<fae::transform>(count);
+        for (auto& transform : transforms)
+        {
+            transform.position = { value(random), value(random), value(random) };
+            transform.rotation = fae::math::normalize(fae::quat(value(random), value(random), value(random), 1.f));
+            transform.scale = { 1.f + value(random), 1.f, 1.f };
+        }
+        auto soa_floats = std::vector<std::vector<float>>(10, std::vector<float>(count));
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& transform = transforms[i];
+            const float components[] = {
+                transform.position.x, transform.position.y, transform.position.z,
+                transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w,
+                transform.scale.x, transform.scale.y, transform.scale.z
+            };
+            for (std::size_t component = 0; component < 10; ++component)
+            {
+                soa_floats[component][i] = components[component];
+            }
+        }
+        const auto soa = fae::transform_soa{
+            .position_x = soa_floats[0].data(),
+            .position_y = soa_floats[1].data(),
+            .position_z = soa_floats[2].data(),
+            .rotation_x = soa_floats[3].data(),
+            .rotation_y = soa_floats[4].data(),
+            .rotation_z = soa_floats[5].data(),
+            .rotation_w = soa_floats[6].data(),
+            .scale_x = soa_floats[7].data(),
+            .scale_y = soa_floats[8].data(),
+            .scale_z = soa_floats[9].data(),
+            .count = count,
+        };
+        auto out = std::vector<fae::mat4>(count);
+
+        fae::benchmarks::run(std::format("translate * rotate * scale (glm), {} transforms", count), count, [&]
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const auto& transform = transforms[i];
+                    out[i] = fae::math::translate(fae::mat4{ 1.f }, transform.position) * fae::math::mat4_cast(transform.rotation) * fae::math::scale(fae::mat4{ 1.f }, transform.scale);
+                }
+                fae::benchmarks::do_not_optimize(out.data());
+            });
+        fae::benchmarks::run(std::format("compose_trs_scalar, {} transforms", count), count, [&]
+            {
+                fae::compose_trs_scalar(transforms, out);
+                fae::benchmarks::do_not_optimize(out.data());
+            });
+        fae::benchmarks::run(std::format("compose_trs (packed), {} transforms", count), count, [&]
+            {
+                fae::compose_trs(std::span<const fae::transform>(transforms), out);
+                fae::benchmarks::do_not_optimize(out.data());
+            });
+        fae::benchmarks::run(std::format("compose_trs (structure of arrays), {} transforms", count), count, [&]
+            {
+                fae::compose_trs(soa, out);
+                fae::benchmarks::do_not_optimize(out.data());
+            });
+    }
+}
@@ -214,6 +214,7 @@ auto fps_control_active_camera(const fae::update_step& step) noexcept -> void
                 camera_transform.position = { 0.f, 0.f, 0.f };
                 look_angle_radians = { 0.f, 0.f };
             }
+            camera_entity.mark_changed<fae::transform>();
         });
 }
 
@@ -279,10 +280,13 @@ auto lock_mouse(const fae::update_step& step) noexcept -> void
 
 auto rotate_system(const fae::update_step& step) noexcept -> void
 {
-    auto& time = step.global_entity.get_or_set_component<fae::time>(fae::time{});
-    for (auto& [entity, transform, rotate] : step.ecs_world.query<fae::transform, const rotate>())
+    const auto delta = step.global_entity.get_or_set_component<fae::time>(fae::time{}).delta();
+    step.ecs_world.par_each<fae::transform, const rotate>([delta](fae::entity, fae::transform& transform, const rotate& rotate)
+        { transform.rotation *= fae::math::angleAxis(fae::math::radians(rotate.speed) * delta, rotate.axis); });
+    // flagged after the parallel loop, flagging is not thread safe
+    for (auto entity : step.ecs_world.registry.view<const fae::transform, const rotate>())
     {
-        transform.rotation *= fae::math::angleAxis(fae::math::radians(rotate.speed) * time.delta(), rotate.axis);
+        step.ecs_world.registry.patch<fae::transform>(entity);
     }
 }
 
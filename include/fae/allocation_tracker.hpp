@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace fae
+{
+    struct application;
+    struct pre_update_step;
+
+    struct allocation_stats
+    {
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t frees = 0;
+    };
+
+    /*
+    heap allocations (global operator new & delete) since the last collect_allocations, a resource
+    the vectors keep their capacity, so collecting does not allocate once every thread & tag was seen
+    */
+    struct allocation_report
+    {
+        struct thread
+        {
+            /* slot of the thread, in the order threads first allocated (0 is usually the main thread), reused once a thread exits */
+            std::size_t index = 0;
+            allocation_stats stats{};
+        };
+
+        struct tag
+        {
+            std::string_view name{};
+            allocation_stats stats{};
+        };
+
+        std::uint64_t frame = 0;
+        allocation_stats total{};
+        /* only the threads & tags that allocated */
+        std::vector<thread> threads{};
+        std::vector<tag> tags{};
+    };
+
+    /*
+    counting is opt in, the global operator new & delete are only replaced when built with FAE_TRACK_ALLOCATIONS (cmake option)
+    without it nothing is counted & reports stay empty
+    counters are per thread (no locks or read-modify-writes on the allocation path), merged when collected
+    up to 128 threads at a time are counted, a thread's slot is freed when it exits (what it frees while exiting is not counted)
+    */
+    [[nodiscard]] constexpr auto is_tracking_allocations() noexcept -> bool
+    {
+#ifdef FAE_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /* writes the allocations since the last call to report */
+    auto collect_allocations(allocation_report& report) noexcept -> void;
+
+    /*
+    allocations of the calling thread are counted under tag while the scope lives (scopes nest, the innermost one counts)
+    tags are compared by content, pass string literals (or strings that outlive the tracking)
+    e.g. [[maybe_unused]] auto allocations = allocation_scope("rendering");
+    */
+    struct allocation_scope
+    {
+#ifdef FAE_TRACK_ALLOCATIONS
+        explicit allocation_scope(const char* tag) noexcept;
+        ~allocation_scope();
+#else
+        explicit constexpr allocation_scope([[maybe_unused]] const char* tag) noexcept
+        {
+        }
+#endif
+        allocation_scope(const allocation_scope&) = delete;
+        auto operator=(const allocation_scope&) -> allocation_scope& = delete;
+
+#ifdef FAE_TRACK_ALLOCATIONS
+      private:
+        const char* m_previous;
+#endif
+    };
+
+    /*
+    collects an allocation_report every frame (in pre update, so a report covers one whole frame)
+    & optionally expects steady state frames not to allocate, logging the tags that did
+    */
+    struct allocation_tracking_plugin
+    {
+        /* frames to warm up (fill caches, arenas & pools) before every frame is expected to be allocation free, 0 to not expect it */
+        std::uint32_t zero_allocation_after_frames = 0;
+
+        auto init(application& app) const noexcept -> void;
+    };
+
+    /* expectations of allocation_tracking_plugin, a resource */
+    struct allocation_budget
+    {
+        std::uint32_t warmup_frames = 0;
+        /* frames that allocated after the warmup */
+        std::uint64_t violations = 0;
+    };
+
+    auto track_frame_allocations(const pre_update_step& step) noexcept -> void;
+}
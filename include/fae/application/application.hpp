@@ -5,6 +5,8 @@
 
 #include "fae/ecs_world.hpp"
 #include "fae/event.hpp"
+#include "fae/event_channel.hpp"
+#include "fae/job_system.hpp"
 #include "fae/asset_manager.hpp"
 #include "fae/scheduler.hpp"
 #include "fae/ecs_world.hpp"
@@ -35,15 +37,24 @@ namespace fae
     struct application
     {
         bool is_running{};
+        /* worker threads shared by the scheduler & parallel ecs iteration, reconfigure with jobs.configure(...) */
+        job_system jobs{};
         asset_manager assets{};
-        scheduler scheduler{};
-        ecs_world ecs_world{};
+        scheduler scheduler{ jobs };
+        ecs_world ecs_world{ .jobs = &jobs };
         std::unordered_set<std::type_index> plugins{};
-        entity_commands global_entity = ecs_world.create_entity();
+        /* its components are ecs_world.resources, get them with ecs_world.resources.get<t>() where it matters (e.g. per draw) */
+        entity_commands global_entity{
+            .id = ecs_world.registry.create(),
+            .registry = ecs_world.registry,
+            .resources = &ecs_world.resources,
+        };
 
         auto step() -> void;
         ;
         auto run() -> void;
+        /* runs fixed_update_step as many times as the time resource's accumulator allows, called by step() between pre_update_step & update_step */
+        auto run_fixed_steps() -> void;
 
         template <typename t_component>
         [[maybe_unused]] inline auto set_global_component(t_component&& value) noexcept -> application&
@@ -52,15 +63,62 @@ namespace fae
             return *this;
         }
 
-        template <typename t_arg>
+        template <typename t_arg, typename t_system>
+            requires std::invocable<t_system&, const t_arg&>
         [[maybe_unused]] inline auto
-        add_system(const typename event<t_arg>::t_listener& system) noexcept
+        add_system(t_system&& system) noexcept
             -> application&
         {
-            scheduler.add_system<t_arg>(system);
+            scheduler.add_system<t_arg>(std::forward<t_system>(system));
             return *this;
         }
 
+        /* systems with declared access may run in parallel with the other systems of their step they do not conflict with */
+        template <typename t_arg, typename t_system>
+            requires std::invocable<t_system&, const t_arg&>
+        [[maybe_unused]] inline auto
+        add_system(t_system&& system, system_access access) noexcept
+            -> application&
+        {
+            scheduler.add_system<t_arg>(std::forward<t_system>(system), std::move(access));
+            return *this;
+        }
+
+        /* the system only runs when condition holds, e.g. run_condition{}.every(std::chrono::milliseconds(100)).staggered() */
+        template <typename t_arg, typename t_system>
+            requires std::invocable<t_system&, const t_arg&>
+        [[maybe_unused]] inline auto
+        add_system(t_system&& system, run_condition condition) noexcept
+            -> application&
+        {
+            scheduler.add_system<t_arg>(std::forward<t_system>(system), std::move(condition));
+            return *this;
+        }
+
+        template <typename t_arg, typename t_system>
+            requires std::invocable<t_system&, const t_arg&>
+        [[maybe_unused]] inline auto
+        add_system(t_system&& system, system_access access, run_condition condition) noexcept
+            -> application&
+        {
+            scheduler.add_system<t_arg>(std::forward<t_system>(system), std::move(access), std::move(condition));
+            return *this;
+        }
+
+        /* adds an event_channel<t_event> to the global entity, swapped at the start of every frame */
+        template <typename t_event>
+        [[maybe_unused]] inline auto add_event_channel() noexcept -> application&
+        {
+            if (global_entity.has_components<event_channel<t_event>>())
+            {
+                return *this;
+            }
+            global_entity.set_component<event_channel<t_event>>(event_channel<t_event>{});
+            return add_system<pre_update_step>([](const pre_update_step& step)
+                { step.global_entity.use_component<event_channel<t_event>>([](event_channel<t_event>& channel)
+                      { channel.update(); }); });
+        }
+
         [[maybe_unused]] inline auto
         add_plugin(const plugin auto& plugin) noexcept -> application&
         {
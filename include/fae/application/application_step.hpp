@@ -38,6 +38,14 @@ namespace fae
         scheduler& scheduler;
         ecs_world& ecs_world;
     };
+    /* runs 0 or more times per frame at time::fixed_delta intervals (if there is a time resource), for simulation that should not depend on frame rate */
+    struct fixed_update_step
+    {
+        entity_commands& global_entity;
+        asset_manager& assets;
+        scheduler& scheduler;
+        ecs_world& ecs_world;
+    };
     struct update_step
     {
         entity_commands& global_entity;
@@ -8,37 +8,66 @@
 #include <filesystem>
 
 #include "fae/core/optional_reference.hpp"
+#include "fae/filesystem/virtual_file_system.hpp"
 
 namespace fae
 {
+    /* loads from a real filesystem path */
     template <typename t_asset>
-    concept asset = requires(const std::filesystem::path& path) {
+    concept file_asset = requires(const std::filesystem::path& path) {
         { t_asset::load(path) } -> std::same_as<std::optional<t_asset>>;
     };
 
+    /* loads through the virtual file system (so also from mounted archives) */
+    template <typename t_asset>
+    concept virtual_file_asset = requires(const std::filesystem::path& path, const virtual_file_system& vfs) {
+        { t_asset::load(path, vfs) } -> std::same_as<std::optional<t_asset>>;
+    };
+
+    template <typename t_asset>
+    concept asset = file_asset<t_asset> || virtual_file_asset<t_asset>;
+
     struct asset_manager
     {
+        /* FAE_ASSET_DIR is mounted at the root, mount archives over it (e.g. vfs.mount_archive("", "assets.pak", 1)) to ship packed assets */
+        virtual_file_system vfs;
+
+        asset_manager()
+        {
+            vfs.mount_directory("", FAE_ASSET_DIR);
+        }
+
         template <asset t_asset>
         [[nodiscard]] auto load(const std::filesystem::path& path) noexcept
             -> optional_reference<t_asset>
         {
-            auto resolved_path = resolve_path(path);
-            if (m_assets.find(resolved_path) != m_assets.end())
+            auto key = std::filesystem::path(normalize_asset_path(path));
+            if (m_assets.find(key) != m_assets.end())
             {
-                return optional_reference<t_asset>(std::any_cast<t_asset&>(m_assets.at(resolved_path)));
+                return optional_reference<t_asset>(std::any_cast<t_asset&>(m_assets.at(key)));
             }
 
-            auto maybe_asset = t_asset::load(resolved_path);
+            auto maybe_asset = [&]
+            {
+                if constexpr (virtual_file_asset<t_asset>)
+                {
+                    return t_asset::load(path, vfs);
+                }
+                else
+                {
+                    return t_asset::load(resolve_path(path));
+                }
+            }();
             if (maybe_asset)
             {
-                auto asset = *maybe_asset;
-                m_assets.insert_or_assign(resolved_path, std::any(std::forward<t_asset&&>(asset)));
-                return optional_reference<t_asset>(std::any_cast<t_asset&>(m_assets.at(resolved_path)));
+                m_assets.insert_or_assign(key, std::any(std::move(*maybe_asset)));
+                return optional_reference<t_asset>(std::any_cast<t_asset&>(m_assets.at(key)));
             }
 
             return std::nullopt;
         }
 
+        /* the path on disk under FAE_ASSET_DIR, bypassing any mounted archives */
         [[nodiscard]] auto resolve_path(const std::filesystem::path& path) const noexcept
             -> std::filesystem::path
         {
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <deque>
+#include <type_traits>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "fae/core/dense_type_index.hpp"
+#include "fae/entity.hpp"
+
+namespace fae
+{
+    /* when a tracked component was added & last changed, stored next to it as its own component */
+    template <typename t_component>
+    struct change_ticks
+    {
+        std::uint64_t added = 0;
+        std::uint64_t changed = 0;
+    };
+
+    /* ticks of the system running on this thread, set by the scheduler around every system it runs (& by par_each in its chunks) */
+    struct system_ticks
+    {
+        /* the world's tick when the system last started, changes after it are new to the system (0 before its first run) */
+        std::uint64_t last_run = 0;
+        std::uint64_t this_run = 0;
+
+        [[nodiscard]] static auto current() noexcept -> system_ticks&
+        {
+            thread_local auto ticks = system_ticks{};
+            return ticks;
+        }
+    };
+
+    /*
+    query filter: entities whose t_component was added after since
+    by default since the system running on the constructing thread last ran, pass since explicitly from threads the scheduler did not start (e.g. jobs)
+    */
+    template <typename t_component>
+    struct added
+    {
+        using component_type = std::remove_const_t<t_component>;
+
+        std::uint64_t since = system_ticks::current().last_run;
+
+        [[nodiscard]] static auto tick_of(const change_ticks<component_type>& ticks) noexcept -> std::uint64_t
+        {
+            return ticks.added;
+        }
+    };
+
+    /* query filter: entities whose t_component was added or changed (replaced, patched or marked changed) after since, defaults as added's */
+    template <typename t_component>
+    struct changed
+    {
+        using component_type = std::remove_const_t<t_component>;
+
+        std::uint64_t since = system_ticks::current().last_run;
+
+        [[nodiscard]] static auto tick_of(const change_ticks<component_type>& ticks) noexcept -> std::uint64_t
+        {
+            return ticks.changed;
+        }
+    };
+
+    template <typename t_filter>
+    concept change_filter = requires(const t_filter& filter, const change_ticks<typename t_filter::component_type>& ticks) {
+        { filter.since } -> std::convertible_to<std::uint64_t>;
+        { t_filter::tick_of(ticks) } -> std::same_as<std::uint64_t>;
+    };
+
+    /*
+    stamps tracked components with the world's tick through entt's on_construct & on_update signals (& on_destroy for last_change)
+    so changes are seen when made through emplace/replace/patch (set_component, patch_component, mark_changed), not through plain references
+    */
+    struct change_tracker
+    {
+        std::atomic<std::uint64_t> tick = 1;
+
+        template <typename t_component>
+        auto track(entity_registry_t& registry) -> void
+        {
+            const auto index = dense_type_index<change_tracker, t_component>();
+            if (index < m_tracked.size() && m_tracked[index])
+            {
+                return;
+            }
+            if (index >= m_tracked.size())
+            {
+                m_tracked.resize(index + 1, false);
+            }
+            m_tracked[index] = true;
+            while (m_last_changes.size() < m_tracked.size())
+            {
+                m_last_changes.emplace_back(0);
+            }
+
+            auto& ticks = registry.storage<change_ticks<t_component>>();
+            const auto now = tick.load(std::memory_order_relaxed);
+            for (auto id : registry.view<t_component>())
+            {
+                if (!ticks.contains(id))
+                {
+                    ticks.emplace(id, change_ticks<t_component>{ .added = now, .changed = now });
+                    m_last_changes[index].store(now, std::memory_order_relaxed);
+                }
+            }
+            registry.on_construct<t_component>().template connect<&change_tracker::on_construct<t_component>>(*this);
+            registry.on_update<t_component>().template connect<&change_tracker::on_update<t_component>>(*this);
+            registry.on_destroy<t_component>().template connect<&change_tracker::on_destroy<t_component>>(*this);
+        }
+
+        /* tick of the last time any t_component was added, changed or removed (0 if never or if t_component is not tracked) */
+        template <typename t_component>
+        [[nodiscard]] auto last_change() const noexcept -> std::uint64_t
+        {
+            const auto index = dense_type_index<change_tracker, t_component>();
+            return index < m_last_changes.size() ? m_last_changes[index].load(std::memory_order_relaxed) : 0;
+        }
+
+      private:
+        std::vector<bool> m_tracked{};
+        /* by dense_type_index<change_tracker, t>(), a deque so growing it does not move the atomics */
+        std::deque<std::atomic<std::uint64_t>> m_last_changes{};
+
+        template <typename t_component>
+        auto record_change() noexcept -> void
+        {
+            m_last_changes[dense_type_index<change_tracker, t_component>()].store(tick.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        template <typename t_component>
+        auto on_construct(entity_registry_t& registry, entity id) -> void
+        {
+            const auto now = tick.load(std::memory_order_relaxed);
+            registry.emplace_or_replace<change_ticks<t_component>>(id, change_ticks<t_component>{ .added = now, .changed = now });
+            record_change<t_component>();
+        }
+
+        template <typename t_component>
+        auto on_update(entity_registry_t& registry, entity id) -> void
+        {
+            if (auto* ticks = registry.try_get<change_ticks<t_component>>(id))
+            {
+                ticks->changed = tick.load(std::memory_order_relaxed);
+            }
+            record_change<t_component>();
+        }
+
+        template <typename t_component>
+        auto on_destroy([[maybe_unused]] entity_registry_t& registry, [[maybe_unused]] entity id) -> void
+        {
+            record_change<t_component>();
+        }
+    };
+
+    /*
+    marks a system as running on this thread for the duration of the scope
+    the world's tick moves on, so anything changed from now on is newer than this run
+    */
+    struct system_tick_scope
+    {
+        system_tick_scope(change_tracker& tracker, std::uint64_t& last_run) noexcept
+            : m_last_run(last_run), m_previous(system_ticks::current())
+        {
+            system_ticks::current() = system_ticks{
+                .last_run = last_run,
+                .this_run = tracker.tick.fetch_add(1, std::memory_order_relaxed),
+            };
+        }
+
+        system_tick_scope(const system_tick_scope&) = delete;
+        auto operator=(const system_tick_scope&) -> system_tick_scope& = delete;
+
+        ~system_tick_scope()
+        {
+            m_last_run = system_ticks::current().this_run;
+            system_ticks::current() = m_previous;
+        }
+
+      private:
+        std::uint64_t& m_last_run;
+        system_ticks m_previous;
+    };
+}
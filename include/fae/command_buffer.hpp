@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "fae/entity.hpp"
+
+namespace fae
+{
+    struct command_buffer;
+
+    /* entity a command refers to, either an existing one or one spawned by the same buffer when it is applied */
+    struct command_target
+    {
+        static constexpr auto no_spawn = static_cast<std::uint32_t>(-1);
+
+        entity id = entt::null;
+        std::uint32_t spawn_index = no_spawn;
+    };
+
+    /* records commands for one entity, e.g. commands.spawn().set_component(transform{}).set_component(model{ ... }) */
+    struct deferred_entity
+    {
+        command_buffer& buffer;
+        command_target target;
+
+        template <typename t_component>
+        [[maybe_unused]] inline auto set_component(t_component&& value) -> deferred_entity&;
+
+        template <typename t_component>
+        [[maybe_unused]] inline auto remove_component() -> deferred_entity&;
+
+        inline auto destroy() -> void;
+    };
+
+    /*
+    structural changes (spawning, setting & removing components, destroying) recorded now & applied later, in bulk, at a sync point
+    so systems can make them while other systems iterate the registry, see ecs_world::commands()
+    */
+    struct command_buffer
+    {
+        command_buffer() = default;
+        command_buffer(const command_buffer&) = delete;
+        auto operator=(const command_buffer&) -> command_buffer& = delete;
+
+        ~command_buffer()
+        {
+            clear();
+        }
+
+        /* the entity is created when the buffer is applied */
+        [[nodiscard]] inline auto spawn() -> deferred_entity
+        {
+            auto lock = std::scoped_lock(m_mutex);
+            return deferred_entity{ .buffer = *this, .target = command_target{ .spawn_index = m_spawn_count++ } };
+        }
+
+        [[nodiscard]] inline auto get_entity(entity id) -> deferred_entity
+        {
+            return deferred_entity{ .buffer = *this, .target = command_target{ .id = id } };
+        }
+
+        template <typename t_component>
+        auto set_component(command_target target, t_component&& value) -> void
+        {
+            using t_value = std::remove_cvref_t<t_component>;
+            auto lock = std::scoped_lock(m_mutex);
+            auto* payload = new (allocate(sizeof(t_value), alignof(t_value))) t_value(std::forward<t_component>(value));
+            m_commands.push_back(command{
+                .target = target,
+                .pool = entt::type_hash<t_value>::value(),
+                .apply = [](entity_registry_t& registry, entity id, void* payload)
+                {
+                    if constexpr (std::is_empty_v<t_value>)
+                    {
+                        registry.emplace_or_replace<t_value>(id);
+                    }
+                    else
+                    {
+                        registry.emplace_or_replace<t_value>(id, std::move(*static_cast<t_value*>(payload)));
+                    }
+                },
+                .destroy = std::is_trivially_destructible_v<t_value> ? nullptr : +[](void* payload)
+                { static_cast<t_value*>(payload)->~t_value(); },
+                .payload = payload,
+            });
+        }
+
+        template <typename t_component>
+        auto remove_component(command_target target) -> void
+        {
+            using t_value = std::remove_cvref_t<t_component>;
+            auto lock = std::scoped_lock(m_mutex);
+            m_commands.push_back(command{
+                .target = target,
+                .pool = entt::type_hash<t_value>::value(),
+                .apply = [](entity_registry_t& registry, entity id, void*)
+                { registry.remove<t_value>(id); },
+                .destroy = nullptr,
+                .payload = nullptr,
+            });
+        }
+
+        /* destroyed after every other command of the sync point is applied */
+        auto destroy(command_target target) -> void
+        {
+            auto lock = std::scoped_lock(m_mutex);
+            m_destroyed.push_back(target);
+        }
+
+        [[nodiscard]] auto empty() const noexcept -> bool
+        {
+            return m_spawn_count == 0 && m_commands.empty() && m_destroyed.empty();
+        }
+
+        /* drops every recorded command, keeps the memory for the next ones */
+        auto clear() -> void;
+
+      private:
+        friend struct command_buffers;
+
+        struct command
+        {
+            command_target target;
+            /* commands are applied grouped by component pool */
+            entt::id_type pool;
+            void (*apply)(entity_registry_t& registry, entity id, void* payload);
+            void (*destroy)(void* payload);
+            void* payload;
+        };
+
+        static constexpr std::size_t chunk_size = 16 * 1024;
+
+        std::mutex m_mutex;
+        std::vector<command> m_commands{};
+        std::vector<command_target> m_destroyed{};
+        std::uint32_t m_spawn_count = 0;
+        /* ids of the spawned entities while the buffer is being applied */
+        std::vector<entity> m_spawned{};
+        /* payloads are bump allocated from chunks reused across sync points, bigger ones get their own allocation */
+        std::vector<std::unique_ptr<std::byte[]>> m_chunks{};
+        std::vector<std::unique_ptr<std::byte[]>> m_oversized{};
+        std::size_t m_chunk_index = 0;
+        std::size_t m_chunk_offset = 0;
+
+        auto allocate(std::size_t size, std::size_t alignment) -> void*;
+        [[nodiscard]] auto resolve(const command_target& target) const noexcept -> entity;
+    };
+
+    /* one command buffer per thread, applied together */
+    struct command_buffers
+    {
+        /* the buffer of a thread slot (see job_system::current_thread_slot), fetch it once per system or chunk rather than per entity */
+        [[nodiscard]] auto for_thread(std::size_t slot) -> command_buffer&;
+
+        /*
+        applies & clears every buffer: spawns first, then the component commands grouped by pool (in recorded order within a pool), then the destroys
+        commands on entities that are no longer valid are skipped
+        */
+        auto apply(entity_registry_t& registry, std::pmr::memory_resource* memory = std::pmr::get_default_resource()) -> void;
+
+      private:
+        struct pending_command
+        {
+            const command_buffer* buffer;
+            const command_buffer::command* command;
+        };
+
+        std::mutex m_mutex;
+        std::vector<std::unique_ptr<command_buffer>> m_buffers{};
+        std::vector<pending_command> m_pending{};
+        std::vector<entity> m_destroyed{};
+    };
+
+    template <typename t_component>
+    inline auto deferred_entity::set_component(t_component&& value) -> deferred_entity&
+    {
+        buffer.set_component(target, std::forward<t_component>(value));
+        return *this;
+    }
+
+    template <typename t_component>
+    inline auto deferred_entity::remove_component() -> deferred_entity&
+    {
+        buffer.remove_component<t_component>(target);
+        return *this;
+    }
+
+    inline auto deferred_entity::destroy() -> void
+    {
+        buffer.destroy(target);
+    }
+}
@@ -3,11 +3,17 @@
 #include "api.hpp"
 #include "byte.hpp"
 #include "deleter.hpp"
+#include "dense_type_index.hpp"
+#include "erased_ptr.hpp"
 #include "enum.hpp"
 #include "exit.hpp"
+#include "free_list_allocator.hpp"
 #include "inocopy.hpp"
 #include "inomove.hpp"
+#include "linear_arena.hpp"
+#include "lz4.hpp"
 #include "match.hpp"
 #include "offset_of.hpp"
 #include "optional_reference.hpp"
+#include "unique_id.hpp"
 #include "vector.hpp"
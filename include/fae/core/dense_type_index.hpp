@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+#include <entt/core/type_info.hpp>
+
+namespace fae
+{
+    /*
+    the dense index of a type within its family, both given by their entt::type_hash
+    indices are handed out by a single table in the fae library, so every module (dll or executable) agrees on them
+    */
+    [[nodiscard]] auto register_dense_type_index(entt::id_type family, entt::id_type type) -> std::size_t;
+
+    /*
+    dense index per type within a family (0, 1, 2, ... in the order the types are first used), to look types up in flat tables
+    e.g. dense_type_index<resources, time>() is time's slot in the resource table
+    */
+    template <typename t_family, typename t>
+    [[nodiscard]] inline auto dense_type_index() -> std::size_t
+    {
+        // cached per module, the table is only looked up the first time
+        static const auto index = register_dense_type_index(entt::type_hash<t_family>::value(), entt::type_hash<t>::value());
+        return index;
+    }
+}
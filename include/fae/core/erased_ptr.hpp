@@ -0,0 +1,17 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+namespace fae
+{
+    /* owning type erased pointer, deletes through the type it was made with */
+    using erased_ptr = std::unique_ptr<void, void (*)(void*)>;
+
+    template <typename t, typename... t_args>
+    [[nodiscard]] auto make_erased(t_args&&... args) -> erased_ptr
+    {
+        return erased_ptr(new t(std::forward<t_args>(args)...), [](void* object)
+            { delete static_cast<t*>(object); });
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <optional>
+
+namespace fae
+{
+    /*
+    best fit range allocator, hands out offsets into a linear range of `capacity` units (e.g. elements of a gpu buffer)
+    free blocks are kept sorted by offset and coalesced with their neighbours when freed
+    */
+    struct free_list_allocator
+    {
+        struct allocation
+        {
+            std::size_t offset = 0;
+            std::size_t size = 0;
+        };
+
+        constexpr free_list_allocator() noexcept = default;
+        explicit free_list_allocator(std::size_t capacity) noexcept : m_capacity(capacity)
+        {
+            reset();
+        }
+
+        [[nodiscard]] auto allocate(std::size_t size) noexcept -> std::optional<allocation>
+        {
+            if (size == 0)
+            {
+                return allocation{ .offset = 0, .size = 0 };
+            }
+
+            auto best = m_free_blocks.end();
+            for (auto it = m_free_blocks.begin(); it != m_free_blocks.end(); ++it)
+            {
+                if (it->second >= size && (best == m_free_blocks.end() || it->second < best->second))
+                {
+                    best = it;
+                    if (it->second == size)
+                    {
+                        break;
+                    }
+                }
+            }
+            if (best == m_free_blocks.end())
+            {
+                return std::nullopt;
+            }
+
+            const auto result = allocation{ .offset = best->first, .size = size };
+            const auto remaining = best->second - size;
+            m_free_blocks.erase(best);
+            if (remaining > 0)
+            {
+                m_free_blocks.emplace(result.offset + size, remaining);
+            }
+            m_used += size;
+            return result;
+        }
+
+        auto free(const allocation& value) noexcept -> void
+        {
+            if (value.size == 0)
+            {
+                return;
+            }
+
+            auto offset = value.offset;
+            auto size = value.size;
+            auto next = m_free_blocks.lower_bound(offset);
+            if (next != m_free_blocks.begin())
+            {
+                auto previous = std::prev(next);
+                if (previous->first + previous->second == offset)
+                {
+                    offset = previous->first;
+                    size += previous->second;
+                    m_free_blocks.erase(previous);
+                }
+            }
+            if (next != m_free_blocks.end() && offset + size == next->first)
+            {
+                size += next->second;
+                m_free_blocks.erase(next);
+            }
+            m_free_blocks.emplace(offset, size);
+            m_used -= value.size;
+        }
+
+        auto reset() noexcept -> void
+        {
+            m_free_blocks.clear();
+            if (m_capacity > 0)
+            {
+                m_free_blocks.emplace(0, m_capacity);
+            }
+            m_used = 0;
+        }
+
+        [[nodiscard]] constexpr auto capacity() const noexcept -> std::size_t
+        {
+            return m_capacity;
+        }
+
+        [[nodiscard]] constexpr auto used() const noexcept -> std::size_t
+        {
+            return m_used;
+        }
+
+        [[nodiscard]] constexpr auto available() const noexcept -> std::size_t
+        {
+            return m_capacity - m_used;
+        }
+
+        [[nodiscard]] auto free_block_count() const noexcept -> std::size_t
+        {
+            return m_free_blocks.size();
+        }
+
+        [[nodiscard]] auto largest_free_block() const noexcept -> std::size_t
+        {
+            std::size_t largest = 0;
+            for (const auto& [offset, size] : m_free_blocks)
+            {
+                largest = std::max(largest, size);
+            }
+            return largest;
+        }
+
+        /* 0 when all free space is contiguous, approaching 1 as it gets split into small blocks */
+        [[nodiscard]] auto fragmentation() const noexcept -> float
+        {
+            const auto free_space = available();
+            if (free_space == 0)
+            {
+                return 0.f;
+            }
+            return 1.f - static_cast<float>(largest_free_block()) / static_cast<float>(free_space);
+        }
+
+      private:
+        std::size_t m_capacity = 0;
+        std::size_t m_used = 0;
+        std::map<std::size_t, std::size_t> m_free_blocks{};
+    };
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace fae
+{
+    /*
+    bump allocator as a std::pmr::memory_resource: allocating moves an offset forward, deallocating does nothing & reset() frees everything at once
+    memory comes from upstream in blocks that are kept across resets, so once a reset arena has one block big enough nothing is allocated from upstream anymore
+    not thread safe, use one arena per thread (see frame_arena)
+    e.g. auto arena = linear_arena{};
+         auto values = std::pmr::vector<int>(&arena);
+    */
+    struct linear_arena final : std::pmr::memory_resource
+    {
+        static constexpr std::size_t default_block_size = 64 * 1024;
+
+        explicit linear_arena(std::size_t block_size = default_block_size, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+            : m_block_size(block_size > 0 ? block_size : default_block_size), m_upstream(upstream)
+        {
+        }
+
+        linear_arena(const linear_arena&) = delete;
+        auto operator=(const linear_arena&) -> linear_arena& = delete;
+
+        ~linear_arena() override
+        {
+            release();
+        }
+
+        /* frees every allocation, if they needed more than one block the blocks are merged into one big enough for all of them */
+        auto reset() -> void
+        {
+            if (m_block > 0)
+            {
+                std::size_t total = 0;
+                for (const auto& block : m_blocks)
+                {
+                    total += block.size;
+                }
+                release();
+                m_blocks.push_back(block{ .data = static_cast<std::byte*>(m_upstream->allocate(total, block_alignment)), .size = total });
+            }
+            m_block = 0;
+            m_offset = 0;
+            m_used = 0;
+        }
+
+        /* returns every block to upstream */
+        auto release() noexcept -> void
+        {
+            for (const auto& block : m_blocks)
+            {
+                m_upstream->deallocate(block.data, block.size, block_alignment);
+            }
+            m_blocks.clear();
+            m_block = 0;
+            m_offset = 0;
+            m_used = 0;
+        }
+
+        /* bytes handed out since the last reset */
+        [[nodiscard]] auto bytes_used() const noexcept -> std::size_t
+        {
+            return m_used;
+        }
+
+        [[nodiscard]] auto capacity() const noexcept -> std::size_t
+        {
+            std::size_t total = 0;
+            for (const auto& block : m_blocks)
+            {
+                total += block.size;
+            }
+            return total;
+        }
+
+      private:
+        static constexpr std::size_t block_alignment = alignof(std::max_align_t);
+
+        struct block
+        {
+            std::byte* data;
+            std::size_t size;
+        };
+
+        std::size_t m_block_size;
+        std::pmr::memory_resource* m_upstream;
+        std::vector<block> m_blocks{};
+        /* block allocations are made from & the offset of its free space */
+        std::size_t m_block = 0;
+        std::size_t m_offset = 0;
+        std::size_t m_used = 0;
+
+        auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override
+        {
+            while (true)
+            {
+                if (m_block < m_blocks.size())
+                {
+                    const auto& current = m_blocks[m_block];
+                    const auto address = reinterpret_cast<std::uintptr_t>(current.data) + m_offset;
+                    const auto aligned_offset = m_offset + ((alignment - address % alignment) % alignment);
+                    if (aligned_offset + bytes <= current.size)
+                    {
+                        m_offset = aligned_offset + bytes;
+                        m_used += bytes;
+                        return current.data + aligned_offset;
+                    }
+                    if (m_block + 1 < m_blocks.size())
+                    {
+                        ++m_block;
+                        m_offset = 0;
+                        continue;
+                    }
+                }
+                const auto size = std::max(m_block_size, bytes + alignment);
+                m_blocks.push_back(block{ .data = static_cast<std::byte*>(m_upstream->allocate(size, block_alignment)), .size = size });
+                m_block = m_blocks.size() - 1;
+                m_offset = 0;
+            }
+        }
+
+        auto do_deallocate([[maybe_unused]] void* pointer, [[maybe_unused]] std::size_t bytes, [[maybe_unused]] std::size_t alignment) -> void override
+        {
+        }
+
+        [[nodiscard]] auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override
+        {
+            return this == &other;
+        }
+    };
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "byte.hpp"
+
+namespace fae
+{
+    /*
+    lz4 block format (no frame header), compatible with LZ4_compress_default / LZ4_decompress_safe
+    the compressor is the plain greedy single hash table variant, fast but not the densest
+    */
+    namespace lz4
+    {
+        namespace detail
+        {
+            inline constexpr std::size_t min_match = 4;
+            /* the last match must start at least this many bytes before the end of the input */
+            inline constexpr std::size_t match_safe_distance = 12;
+            /* the last bytes of the input are always literals */
+            inline constexpr std::size_t last_literals = 5;
+            inline constexpr std::size_t max_offset = 65535;
+            inline constexpr std::size_t hash_log = 12;
+
+            [[nodiscard]] inline auto read_u32(const byte* data) noexcept -> std::uint32_t
+            {
+                std::uint32_t value;
+                std::memcpy(&value, data, sizeof(value));
+                return value;
+            }
+
+            [[nodiscard]] inline auto hash(std::uint32_t sequence) noexcept -> std::size_t
+            {
+                return (sequence * 2654435761u) >> (32 - hash_log);
+            }
+
+            inline auto write_length(std::vector<byte>& output, std::size_t length) -> void
+            {
+                while (length >= 255)
+                {
+                    output.push_back(255);
+                    length -= 255;
+                }
+                output.push_back(static_cast<byte>(length));
+            }
+
+            inline auto write_sequence(std::vector<byte>& output, std::span<const byte> literals, std::size_t offset, std::size_t match_length) -> void
+            {
+                const auto literal_token = std::min<std::size_t>(literals.size(), 15);
+                const auto match_token = match_length == 0 ? 0 : std::min<std::size_t>(match_length - min_match, 15);
+                output.push_back(static_cast<byte>(literal_token << 4 | match_token));
+                if (literal_token == 15)
+                {
+                    write_length(output, literals.size() - 15);
+                }
+                output.insert(output.end(), literals.begin(), literals.end());
+                if (match_length == 0)
+                {
+                    return;
+                }
+                output.push_back(static_cast<byte>(offset & 0xff));
+                output.push_back(static_cast<byte>(offset >> 8));
+                if (match_token == 15)
+                {
+                    write_length(output, match_length - min_match - 15);
+                }
+            }
+        }
+
+        /* worst case compressed size for an input of `size` bytes */
+        [[nodiscard]] constexpr auto compress_bound(std::size_t size) noexcept -> std::size_t
+        {
+            return size + size / 255 + 16;
+        }
+
+        [[nodiscard]] inline auto compress(std::span<const byte> input) -> std::vector<byte>
+        {
+            using namespace detail;
+
+            auto output = std::vector<byte>{};
+            output.reserve(compress_bound(input.size()));
+
+            const auto* data = input.data();
+            const auto size = input.size();
+            std::size_t anchor = 0;
+            if (size > match_safe_distance)
+            {
+                auto table = std::array<std::uint32_t, std::size_t{ 1 } << hash_log>{};
+                const auto match_limit = size - match_safe_distance;
+                const auto end_of_matches = size - last_literals;
+                std::size_t position = 0;
+                while (position < match_limit)
+                {
+                    const auto sequence = read_u32(data + position);
+                    auto& slot = table[hash(sequence)];
+                    const std::size_t candidate = slot;
+                    slot = static_cast<std::uint32_t>(position);
+                    if (candidate >= position || position - candidate > max_offset || read_u32(data + candidate) != sequence)
+                    {
+                        ++position;
+                        continue;
+                    }
+
+                    auto match_start = position;
+                    auto reference = candidate;
+                    while (match_start > anchor && reference > 0 && data[match_start - 1] == data[reference - 1])
+                    {
+                        --match_start;
+                        --reference;
+                    }
+                    auto match_end = position + min_match;
+                    while (match_end < end_of_matches && data[match_end] == data[reference + (match_end - match_start)])
+                    {
+                        ++match_end;
+                    }
+
+                    write_sequence(output, input.subspan(anchor, match_start - anchor), match_start - reference, match_end - match_start);
+                    anchor = match_end;
+                    position = match_end;
+                }
+            }
+            write_sequence(output, input.subspan(anchor), 0, 0);
+            return output;
+        }
+
+        /* decompresses into exactly `output.size()` bytes, fails on malformed or truncated input */
+        [[nodiscard]] inline auto decompress(std::span<const byte> input, std::span<byte> output) noexcept -> bool
+        {
+            std::size_t in = 0, out = 0;
+            auto read_length = [&](std::size_t length) -> std::optional<std::size_t>
+            {
+                if (length != 15)
+                {
+                    return length;
+                }
+                byte next;
+                do
+                {
+                    if (in >= input.size())
+                    {
+                        return std::nullopt;
+                    }
+                    next = input[in++];
+                    length += next;
+                } while (next == 255);
+                return length;
+            };
+
+            while (in < input.size())
+            {
+                const auto token = input[in++];
+                const auto literal_length = read_length(token >> 4);
+                if (!literal_length || *literal_length > input.size() - in || *literal_length > output.size() - out)
+                {
+                    return false;
+                }
+                std::copy_n(input.begin() + in, *literal_length, output.begin() + out);
+                in += *literal_length;
+                out += *literal_length;
+                if (in == input.size())
+                {
+                    break;
+                }
+
+                if (input.size() - in < 2)
+                {
+                    return false;
+                }
+                const auto offset = static_cast<std::size_t>(input[in]) | static_cast<std::size_t>(input[in + 1]) << 8;
+                in += 2;
+                const auto match_length = read_length(token & 0x0f);
+                if (offset == 0 || offset > out || !match_length || *match_length + detail::min_match > output.size() - out)
+                {
+                    return false;
+                }
+                // byte by byte since the match may overlap the bytes it produces
+                for (std::size_t i = 0; i < *match_length + detail::min_match; ++i, ++out)
+                {
+                    output[out] = output[out - offset];
+                }
+            }
+            return out == output.size();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace fae
+{
+    /*
+    process wide unique id of an object, to key caches on instead of its address
+    kept when the object is moved (e.g. when a component pool is packed or sorted), copies & moved from objects get a new one
+    */
+    struct unique_id
+    {
+        unique_id() noexcept : m_value(next())
+        {
+        }
+
+        unique_id(const unique_id&) noexcept : m_value(next())
+        {
+        }
+
+        unique_id(unique_id&& other) noexcept : m_value(other.m_value)
+        {
+            other.m_value = next();
+        }
+
+        auto operator=(const unique_id& other) noexcept -> unique_id&
+        {
+            if (this != &other)
+            {
+                m_value = next();
+            }
+            return *this;
+        }
+
+        auto operator=(unique_id&& other) noexcept -> unique_id&
+        {
+            if (this != &other)
+            {
+                m_value = other.m_value;
+                other.m_value = next();
+            }
+            return *this;
+        }
+
+        [[nodiscard]] constexpr auto get() const noexcept -> std::uint64_t
+        {
+            return m_value;
+        }
+
+      private:
+        std::uint64_t m_value;
+
+        [[nodiscard]] static auto next() noexcept -> std::uint64_t
+        {
+            static auto counter = std::atomic<std::uint64_t>{ 1 };
+            return counter.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "fae/time.hpp"
+#include "fae/transform_hierarchy.hpp"
 #include "fae/input.hpp"
 #include "fae/windowing.hpp"
 #include "fae/rendering/rendering.hpp"
@@ -14,6 +15,7 @@ namespace fae
     struct default_plugins
     {
         time_plugin time_plugin{};
+        transform_hierarchy_plugin transform_hierarchy_plugin{};
         input_plugin input_plugin{};
         windowing_plugin windowing_plugin{};
         rendering_plugin rendering_plugin{};
@@ -1,18 +1,40 @@
 #pragma once
 
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <span>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
-#include <stack>
 
 #include <entt/entt.hpp>
 
+#include "fae/change_detection.hpp"
+#include "fae/command_buffer.hpp"
 #include "fae/entity.hpp"
+#include "fae/frame_arena.hpp"
+#include "fae/job_system.hpp"
+#include "fae/prefab.hpp"
+#include "fae/profiler.hpp"
+#include "fae/query_view.hpp"
 
 namespace fae
 {
     struct ecs_world
     {
         entt::registry registry{};
+        /* runs par_each, serial when null */
+        job_system* jobs = nullptr;
+        /* structural changes recorded by systems, applied at the application's sync points (between steps) */
+        command_buffers deferred_commands{};
+        /* global state, also reachable through application::global_entity */
+        fae::resources resources{};
+        /* world tick & the change ticks of the components passed to track_changes */
+        change_tracker changes{};
+        /* per frame temporaries, moved on to the next frame by the application at the start of every step */
+        frame_arena frame_memory{};
 
         [[nodiscard]] inline constexpr auto create_entity() noexcept -> fae::entity_commands
         {
@@ -22,6 +44,50 @@ namespace fae
             };
         }
 
+        /*
+        creates ids.size() entities (written to ids) that all get a copy of each of components
+        one range create for the entities & one reserve + range insert per component, instead of one emplace per entity & component
+        e.g. auto ids = std::vector<entity>(100'000);
+             ecs_world.spawn_batch(ids, transform{}, model{ ... });
+        */
+        template <typename... t_components>
+        [[maybe_unused]] inline auto spawn_batch(std::span<entity> ids, const t_components&... components) -> void
+        {
+            reserve_entities(ids.size());
+            registry.create(ids.begin(), ids.end());
+            (insert_batch<t_components>(ids, components), ...);
+        }
+
+        template <typename... t_components>
+        [[nodiscard]] inline auto spawn_batch(std::size_t count, const t_components&... components) -> std::vector<entity>
+        {
+            auto ids = std::vector<entity>(count);
+            spawn_batch(std::span<entity>(ids), components...);
+            return ids;
+        }
+
+        /* creates ids.size() instances of the prefab (written to ids) */
+        [[maybe_unused]] inline auto spawn_batch(const prefab& prefab, std::span<entity> ids) -> void
+        {
+            reserve_entities(ids.size());
+            registry.create(ids.begin(), ids.end());
+            prefab.instantiate(registry, ids);
+        }
+
+        [[nodiscard]] inline auto spawn_batch(const prefab& prefab, std::size_t count) -> std::vector<entity>
+        {
+            auto ids = std::vector<entity>(count);
+            spawn_batch(prefab, std::span<entity>(ids));
+            return ids;
+        }
+
+        [[nodiscard]] inline auto spawn(const prefab& prefab) -> fae::entity_commands
+        {
+            auto id = registry.create();
+            prefab.instantiate(registry, std::span<const entity>(&id, 1));
+            return get_entity(id);
+        }
+
         [[nodiscard]] inline constexpr auto get_entity(entity id) noexcept -> fae::entity_commands
         {
             return fae::entity_commands{
@@ -30,6 +96,32 @@ namespace fae
             };
         }
 
+        /*
+        command buffer of the calling thread, its commands are applied at the next sync point
+        use it instead of create_entity()/set_component()/destroy() while other systems may iterate (systems with declared access, par_each)
+        */
+        [[nodiscard]] inline auto commands() -> command_buffer&
+        {
+            return deferred_commands.for_thread(jobs ? jobs->current_thread_slot() : 0);
+        }
+
+        /* a sync point, called by the application between steps */
+        inline auto apply_commands() -> void
+        {
+            FAE_PROFILE_SCOPE("apply_commands");
+            deferred_commands.apply(registry, frame_allocator());
+        }
+
+        /*
+        frame arena of the calling thread, what is allocated from it stays valid until the end of the next frame
+        e.g. auto ids = std::pmr::vector<entity>(ecs_world.frame_allocator());
+        */
+        [[nodiscard]] inline auto frame_allocator() -> std::pmr::memory_resource*
+        {
+            return &frame_memory.for_thread(jobs ? jobs->current_thread_slot() : 0);
+        }
+
+        /* copies every match into a vector, prefer view() which does not allocate */
         template <typename... t_args>
         [[nodiscard]] inline constexpr auto query() noexcept -> std::vector<std::tuple<fae::entity_commands, t_args&...>>
         {
@@ -39,20 +131,160 @@ namespace fae
             return query_results;
         }
 
-        [[nodiscard]] auto entities() noexcept -> std::vector<fae::entity_commands>
+        /* like query(), into memory from the frame arena of the calling thread (valid until the end of the next frame) */
+        template <typename... t_args>
+        [[nodiscard]] inline auto query_frame() -> std::pmr::vector<std::tuple<fae::entity_commands, t_args&...>>
+        {
+            return query_into<t_args...>(*frame_allocator());
+        }
+
+        /* like query(), into memory from the given resource (e.g. a linear_arena) */
+        template <typename... t_args>
+        [[nodiscard]] inline auto query_into(std::pmr::memory_resource& memory) -> std::pmr::vector<std::tuple<fae::entity_commands, t_args&...>>
+        {
+            auto query_results = std::pmr::vector<std::tuple<fae::entity_commands, t_args&...>>(&memory);
+            registry.view<t_args...>().each([&](auto entity, auto&... args)
+                { query_results.emplace_back(fae::entity_commands{ .id = entity, .registry = registry }, args...); });
+            return query_results;
+        }
+
+        /*
+        lazy query over the entities that have all of t_args (& none of the excluded ones)
+        e.g. for (auto [entity, transform, model] : ecs_world.view<transform, const model>(entt::exclude<hidden>))
+        */
+        template <typename... t_args, typename... t_exclude>
+        [[nodiscard]] inline auto view(entt::exclude_t<t_exclude...> exclude = entt::exclude_t{}) noexcept
+        {
+            return make_query_view(registry.view<t_args...>(exclude).each(), registry);
+        }
+
+        /*
+        view() of only the entities that pass a change filter, i.e. changed or added since the running system last ran
+        e.g. for (auto [entity, transform] : ecs_world.view<const transform>(changed<transform>{}))
+        t_filter's component must be tracked (see track_changes)
+        */
+        template <typename... t_args, change_filter t_filter, typename... t_exclude>
+        [[nodiscard]] inline auto view(t_filter filter, entt::exclude_t<t_exclude...> exclude = entt::exclude_t{}) noexcept
+        {
+            auto& ticks = registry.storage<change_ticks<typename t_filter::component_type>>();
+            return make_filtered_query_view(registry.view<t_args...>(exclude).each(), registry, [&ticks, since = filter.since](entity id)
+                { return ticks.contains(id) && t_filter::tick_of(ticks.get(id)) > since; });
+        }
+
+        /* starts recording when t_components are added & changed, for the changed<t> & added<t> filters */
+        template <typename... t_components>
+        [[maybe_unused]] inline auto track_changes() -> ecs_world&
+        {
+            (changes.track<t_components>(registry), ...);
+            return *this;
+        }
+
+        /* same as view() over an entt group, which owns (keeps packed together) the t_owned components */
+        template <typename... t_owned, typename... t_get, typename... t_exclude>
+        [[nodiscard]] inline auto group(entt::get_t<t_get...> get = entt::get_t{}, entt::exclude_t<t_exclude...> exclude = entt::exclude_t{}) noexcept
+        {
+            return make_query_view(registry.group<t_owned...>(get, exclude).each(), registry);
+        }
+
+        /*
+        calls fn(entity, t_components&...) for every entity that has all of t_components, split over the job system in chunks of grain entities
+        walks the smallest of the storages & skips the entities missing any of the others, empty (tag) components filter but are not passed
+        fn runs concurrently on different entities, so it must not add or remove components or entities (defer those until after the call)
+        e.g. ecs_world.par_each<transform, const velocity>([&](entity, transform& transform, const velocity& velocity) { ... });
+        */
+        template <typename... t_components, typename t_fn>
+        auto par_each(const t_fn& fn, std::size_t grain = 256) -> void
+        {
+            static_assert(sizeof...(t_components) > 0, "par_each needs at least one component");
+            // looked up (& created if missing) here on the calling thread, the workers only read them
+            auto storages = std::forward_as_tuple(registry.storage<std::remove_const_t<t_components>>()...);
+            const entt::sparse_set* leading = nullptr;
+            std::apply([&](const auto&... storage)
+                { ((leading = !leading || storage.size() < leading->size() ? &storage : leading), ...); },
+                storages);
+            const auto* ids = leading->data();
+            // chunks run on other threads, which get the ticks of the calling system for the changed<t> & added<t> filters fn builds
+            const auto ticks = system_ticks::current();
+            auto each_in = [&](std::size_t begin, std::size_t end)
+            {
+                const auto previous_ticks = std::exchange(system_ticks::current(), ticks);
+                for (auto i = begin; i < end; ++i)
+                {
+                    const auto id = ids[i];
+                    if (id == entt::tombstone)
+                    {
+                        continue;
+                    }
+                    [&]<std::size_t... t_index>(std::index_sequence<t_index...>)
+                    {
+                        if (!(std::get<t_index>(storages).contains(id) && ...))
+                        {
+                            return;
+                        }
+                        std::apply(fn, std::tuple_cat(std::tuple<entity>(id), component_of<t_components>(std::get<t_index>(storages), id)...));
+                    }(std::index_sequence_for<t_components...>{});
+                }
+                system_ticks::current() = previous_ticks;
+            };
+            if (jobs)
+            {
+                jobs->parallel_for(leading->size(), grain, each_in);
+            }
+            else
+            {
+                each_in(0, leading->size());
+            }
+        }
+
+        /* lazy, in creation order */
+        [[nodiscard]] auto entities() noexcept
+        {
+            auto view = registry.view<entt::entity>();
+            using iterator_t = std::reverse_iterator<decltype(view.begin())>;
+            return entity_view<iterator_t>{
+                .first = iterator_t(view.end()),
+                .last = iterator_t(view.begin()),
+                .registry = &registry,
+            };
+        }
+
+      private:
+        inline auto reserve_entities(std::size_t count) -> void
+        {
+            auto& entities = registry.storage<entity>();
+            entities.reserve(entities.size() + count);
+        }
+
+        template <typename t_component>
+        inline auto insert_batch(std::span<const entity> ids, const t_component& component) -> void
         {
-            std::vector<fae::entity_commands> entities;
+            auto& storage = registry.storage<t_component>();
+            storage.reserve(storage.size() + ids.size());
+            if constexpr (std::is_empty_v<t_component>)
+            {
+                registry.insert<t_component>(ids.begin(), ids.end());
+            }
+            else
+            {
+                registry.insert<t_component>(ids.begin(), ids.end(), component);
+            }
+        }
 
-            std::stack<fae::entity_commands> entity_stack;
-            for (auto entity : registry.view<entt::entity>())
+        template <typename t_component, typename t_storage>
+        [[nodiscard]] static auto component_of(t_storage& storage, entity id)
+        {
+            if constexpr (std::is_empty_v<t_component>)
+            {
+                return std::tuple<>{};
+            }
+            else if constexpr (std::is_const_v<t_component>)
             {
-                entity_stack.push(fae::entity_commands{ .id = entity, .registry = registry });
+                return std::tuple<t_component&>(std::as_const(storage).get(id));
             }
-            while (!entity_stack.empty()) {
-                entities.push_back(entity_stack.top());
-                entity_stack.pop();
+            else
+            {
+                return std::tuple<t_component&>(storage.get(id));
             }
-            return entities;
         }
     };
 }
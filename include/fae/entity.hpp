@@ -2,11 +2,14 @@
 
 #include <vector>
 #include <string>
+#include <concepts>
+#include <utility>
 #include <functional>
 
 #include <entt/entt.hpp>
 
 #include "fae/core/optional_reference.hpp"
+#include "fae/resources.hpp"
 
 namespace fae
 {
@@ -32,18 +35,23 @@ namespace fae
     {
         entity id;
         entity_registry_t& registry;
+        /* set for application::global_entity, whose "components" are the resources (kept so the entity api keeps working for globals) */
+        fae::resources* resources = nullptr;
 
         template <typename... t_component>
         [[nodiscard]] inline constexpr auto has_components() const noexcept -> bool
         {
+            if (resources)
+            {
+                return (resources->contains<t_component>() && ...);
+            }
             return registry.all_of<t_component...>(id);
         }
 
         template <typename t_component>
         [[nodiscard]] inline constexpr auto get_component() const noexcept -> optional_reference<const t_component>
         {
-
-            auto maybe_component = registry.try_get<const t_component>(id);
+            const auto* maybe_component = resources ? std::as_const(*resources).get<t_component>() : registry.try_get<const t_component>(id);
             if (!maybe_component)
             {
                 return std::nullopt;
@@ -54,8 +62,7 @@ namespace fae
         template <typename t_component>
         [[nodiscard]] inline constexpr auto get_component() noexcept -> optional_reference<t_component>
         {
-
-            auto maybe_component = registry.try_get<t_component>(id);
+            auto* maybe_component = resources ? resources->get<t_component>() : registry.try_get<t_component>(id);
             if (!maybe_component)
             {
                 return std::nullopt;
@@ -66,14 +73,17 @@ namespace fae
         template <typename t_component>
         [[nodiscard]] inline constexpr auto set_and_get_component(t_component&& value) noexcept -> t_component&
         {
-            registry.emplace_or_replace<t_component>(id, std::forward<t_component&&>(value));
-            return registry.get<t_component>(id);
+            if (resources)
+            {
+                return resources->set<t_component>(std::forward<t_component&&>(value));
+            }
+            return registry.emplace_or_replace<t_component>(id, std::forward<t_component&&>(value));
         }
 
         template <typename t_component>
         [[maybe_unused]] inline constexpr auto set_component(t_component&& value) noexcept -> entity_commands&
         {
-            [[maybe_unused]] auto maybe_component = set_and_get_component<t_component>(std::forward<t_component&&>(value));
+            [[maybe_unused]] auto& maybe_component = set_and_get_component<t_component>(std::forward<t_component&&>(value));
             return *this;
         }
 
@@ -89,24 +99,60 @@ namespace fae
             return *component;
         }
 
-        template <typename t_component>
-        [[maybe_unused]] inline constexpr auto use_component(std::function<void(t_component&)> callback) noexcept -> entity_commands&
+        /* calls callback with the component if the entity has it, takes any callable so nothing is type erased or allocated */
+        template <typename t_component, typename t_callback>
+            requires std::invocable<t_callback, t_component&>
+        [[maybe_unused]] inline constexpr auto use_component(t_callback&& callback) noexcept -> entity_commands&
         {
             auto maybe_component = get_component<t_component>();
             if (maybe_component)
             {
-                callback(*maybe_component);
+                std::invoke(std::forward<t_callback>(callback), *maybe_component);
             }
             return *this;
         }
 
-        template <typename t_component>
-        [[maybe_unused]] inline constexpr auto use_component(std::function<void(const t_component&)> callback) const noexcept -> const entity_commands&
+        template <typename t_component, typename t_callback>
+            requires std::invocable<t_callback, const t_component&>
+        [[maybe_unused]] inline constexpr auto use_component(t_callback&& callback) const noexcept -> const entity_commands&
         {
             const auto maybe_component = get_component<const t_component>();
             if (maybe_component)
             {
-                callback(*maybe_component);
+                std::invoke(std::forward<t_callback>(callback), *maybe_component);
+            }
+            return *this;
+        }
+
+        /* calls callback with the component & flags it as changed (for changed<t> filters), does nothing if the entity does not have it */
+        template <typename t_component, typename t_callback>
+            requires std::invocable<t_callback, t_component&>
+        [[maybe_unused]] inline auto patch_component(t_callback&& callback) noexcept -> entity_commands&
+        {
+            if (resources)
+            {
+                use_component<t_component>(std::forward<t_callback>(callback));
+                resources->mark_changed<t_component>();
+                return *this;
+            }
+            if (registry.all_of<t_component>(id))
+            {
+                registry.patch<t_component>(id, std::forward<t_callback>(callback));
+            }
+            return *this;
+        }
+
+        /* flags the component as changed after it was modified through a reference */
+        template <typename t_component>
+        [[maybe_unused]] inline auto mark_changed() noexcept -> entity_commands&
+        {
+            if (resources)
+            {
+                resources->mark_changed<t_component>();
+            }
+            else if (registry.all_of<t_component>(id))
+            {
+                registry.patch<t_component>(id);
             }
             return *this;
         }
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace fae
+{
+    /* position of one reader in an event_channel, every reader sees every event once */
+    template <typename t_event>
+    struct event_reader
+    {
+        /* sequence number of the next event to read */
+        std::size_t cursor = 0;
+    };
+
+    /*
+    queued events, unlike event<t> nothing is called when an event is sent, readers pull the events in a loop whenever they run
+    events live in two buffers (this frame's & the last frame's), update() swaps them once per frame & reuses the older one's memory
+    so an event can be read until the end of the frame after the one it was sent in, readers that fall further behind skip the missed events
+
+    send() & read() are lock free & can be called from any number of threads at once (systems only need reads_resource<event_channel<t>>)
+    update() must not run concurrently with them, add the channel with application::add_event_channel to swap it at the start of each frame
+    */
+    template <typename t_event>
+    struct event_channel
+    {
+        event_channel() : m_state(std::make_unique<state>()) {}
+
+        auto send(t_event&& event) -> void
+        {
+            auto& buffer = m_state->buffers[m_state->current];
+            const auto index = buffer.count.fetch_add(1, std::memory_order_relaxed);
+            auto& slot = buffer.slot_at(index);
+            new (slot.storage) t_event(std::move(event));
+            slot.ready.store(true, std::memory_order_release);
+        }
+
+        auto send(const t_event& event) -> void
+        {
+            send(t_event(event));
+        }
+
+        /* calls fn(const t_event&) for the events reader has not read yet, in the order they were sent, returns how many */
+        template <typename t_fn>
+        auto read(event_reader<t_event>& reader, t_fn&& fn) const -> std::size_t
+        {
+            std::size_t read_count = 0;
+            auto counted_fn = [&](const t_event& event)
+            {
+                ++read_count;
+                fn(event);
+            };
+            const auto& older = m_state->buffers[1 - m_state->current];
+            const auto& newer = m_state->buffers[m_state->current];
+            if (older.read(reader, counted_fn))
+            {
+                newer.read(reader, counted_fn);
+            }
+            return read_count;
+        }
+
+        /* a reader that only sees events sent from now on */
+        [[nodiscard]] auto reader_at_end() const -> event_reader<t_event>
+        {
+            const auto& newer = m_state->buffers[m_state->current];
+            return event_reader<t_event>{ .cursor = newer.first_sequence + newer.count.load(std::memory_order_acquire) };
+        }
+
+        /* events sent this frame & last frame */
+        [[nodiscard]] auto size() const noexcept -> std::size_t
+        {
+            return m_state->buffers[0].count.load(std::memory_order_acquire) + m_state->buffers[1].count.load(std::memory_order_acquire);
+        }
+
+        /* drops last frame's events & starts a new frame, their memory is reused by the new frame's events */
+        auto update() -> void
+        {
+            auto& newer = m_state->buffers[m_state->current];
+            auto& stale = m_state->buffers[1 - m_state->current];
+            stale.clear();
+            stale.first_sequence = newer.first_sequence + newer.count.load(std::memory_order_acquire);
+            m_state->current = 1 - m_state->current;
+        }
+
+        auto clear() -> void
+        {
+            update();
+            update();
+        }
+
+      private:
+        struct slot
+        {
+            alignas(t_event) std::byte storage[sizeof(t_event)];
+            std::atomic<bool> ready = false;
+
+            [[nodiscard]] auto get() const -> const t_event&
+            {
+                return *std::launder(reinterpret_cast<const t_event*>(storage));
+            }
+        };
+
+        /*
+        slots are in chunks that double in size (first_chunk_size, 2 * first_chunk_size, ...), found from the index alone
+        so a chunk never moves once allocated & writers never wait on each other to grow the buffer
+        */
+        struct buffer
+        {
+            static constexpr std::size_t first_chunk_size = 64;
+            static constexpr std::size_t max_chunks = 48;
+
+            std::array<std::atomic<slot*>, max_chunks> chunks{};
+            /* reserved slots, a slot is readable once it is ready */
+            std::atomic<std::size_t> count = 0;
+            std::size_t first_sequence = 0;
+
+            buffer() = default;
+            buffer(const buffer&) = delete;
+            auto operator=(const buffer&) -> buffer& = delete;
+
+            ~buffer()
+            {
+                clear();
+                for (auto& chunk : chunks)
+                {
+                    delete[] chunk.load(std::memory_order_relaxed);
+                }
+            }
+
+            [[nodiscard]] static auto chunk_of(std::size_t index) noexcept -> std::size_t
+            {
+                return static_cast<std::size_t>(std::bit_width(index / first_chunk_size + 1)) - 1;
+            }
+
+            [[nodiscard]] static auto chunk_begin(std::size_t chunk) noexcept -> std::size_t
+            {
+                return first_chunk_size * ((std::size_t{ 1 } << chunk) - 1);
+            }
+
+            [[nodiscard]] static auto chunk_size(std::size_t chunk) noexcept -> std::size_t
+            {
+                return first_chunk_size << chunk;
+            }
+
+            auto slot_at(std::size_t index) -> slot&
+            {
+                const auto chunk = chunk_of(index);
+                auto* slots = chunks[chunk].load(std::memory_order_acquire);
+                if (!slots)
+                {
+                    auto* allocated = new slot[chunk_size(chunk)];
+                    if (chunks[chunk].compare_exchange_strong(slots, allocated, std::memory_order_acq_rel))
+                    {
+                        slots = allocated;
+                    }
+                    else
+                    {
+                        delete[] allocated;
+                    }
+                }
+                return slots[index - chunk_begin(chunk)];
+            }
+
+            /* false if it stopped at an event that is still being written */
+            template <typename t_fn>
+            auto read(event_reader<t_event>& reader, t_fn& fn) const -> bool
+            {
+                const auto end = count.load(std::memory_order_acquire);
+                auto index = reader.cursor > first_sequence ? reader.cursor - first_sequence : 0;
+                while (index < end)
+                {
+                    const auto chunk = chunk_of(index);
+                    const auto* slots = chunks[chunk].load(std::memory_order_acquire);
+                    if (!slots)
+                    {
+                        reader.cursor = first_sequence + index;
+                        return false;
+                    }
+                    const auto chunk_end = std::min(end, chunk_begin(chunk) + chunk_size(chunk));
+                    for (; index < chunk_end; ++index)
+                    {
+                        const auto& slot = slots[index - chunk_begin(chunk)];
+                        if (!slot.ready.load(std::memory_order_acquire))
+                        {
+                            reader.cursor = first_sequence + index;
+                            return false;
+                        }
+                        fn(slot.get());
+                    }
+                }
+                reader.cursor = std::max(reader.cursor, first_sequence + end);
+                return true;
+            }
+
+            /* destroys the events, keeps the chunks */
+            auto clear() -> void
+            {
+                const auto end = count.load(std::memory_order_acquire);
+                for (std::size_t index = 0; index < end; ++index)
+                {
+                    const auto chunk = chunk_of(index);
+                    auto* slots = chunks[chunk].load(std::memory_order_relaxed);
+                    if (!slots)
+                    {
+                        break;
+                    }
+                    auto& slot = slots[index - chunk_begin(chunk)];
+                    if (slot.ready.load(std::memory_order_relaxed))
+                    {
+                        std::launder(reinterpret_cast<t_event*>(slot.storage))->~t_event();
+                        slot.ready.store(false, std::memory_order_relaxed);
+                    }
+                }
+                count.store(0, std::memory_order_release);
+            }
+        };
+
+        struct state
+        {
+            std::array<buffer, 2> buffers{};
+            /* index of the buffer this frame's events are sent to */
+            std::size_t current = 0;
+        };
+
+        /* boxed so the channel can be moved around (e.g. stored as a component) while its buffers stay put */
+        std::unique_ptr<state> m_state;
+    };
+}
@@ -6,14 +6,25 @@
 #include "fae/color.hpp"
 #include "fae/angle.hpp"
 #include "fae/event.hpp"
+#include "fae/event_channel.hpp"
 #include "fae/logging.hpp"
 #include "fae/math.hpp"
+#include "fae/transform_batch.hpp"
 #include "fae/cursor.hpp"
 
 #include "fae/asset_manager.hpp"
+#include "fae/job_system.hpp"
+#include "fae/run_condition.hpp"
 #include "fae/scheduler.hpp"
 
+#include "fae/resources.hpp"
 #include "fae/entity.hpp"
+#include "fae/prefab.hpp"
+#include "fae/command_buffer.hpp"
+#include "fae/frame_arena.hpp"
+#include "fae/allocation_tracker.hpp"
+#include "fae/profiler.hpp"
+#include "fae/flight_recorder.hpp"
 #include "fae/ecs_world.hpp"
 
 #include "fae/application/application.hpp"
@@ -21,6 +32,7 @@
 #include "fae/sdl.hpp"
 #include "fae/webgpu/webgpu.hpp"
 #include "fae/time.hpp"
+#include "fae/transform_hierarchy.hpp"
 #include "fae/input.hpp"
 #include "fae/rendering/rendering.hpp"
 #include "fae/camera.hpp"
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fae/core/byte.hpp"
+#include "fae/filesystem/mapped_file.hpp"
+
+namespace fae
+{
+    /* forward slashes, lexically normal & relative (e.g. "/textures//old/../rock.png" -> "textures/rock.png") */
+    [[nodiscard]] auto normalize_asset_path(const std::filesystem::path& path) -> std::string;
+
+    enum struct archive_compression : std::uint32_t
+    {
+        none,
+        lz4,
+    };
+
+    /*
+    packed asset archive, a single memory mapped file holding many assets
+    layout (little endian):
+        header
+        entry data, each entry either stored raw or compressed
+        table of contents, entries sorted by the hash of their path
+        paths of the entries
+    */
+    struct archive
+    {
+        static constexpr auto magic = std::string_view("FAEPAK\0\0", 8);
+        static constexpr std::uint32_t version = 1;
+
+        struct header
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t entry_count;
+            std::uint64_t toc_offset;
+            std::uint64_t paths_offset;
+        };
+
+        struct entry
+        {
+            std::uint64_t path_hash;
+            std::uint64_t offset;
+            std::uint64_t stored_size;
+            std::uint64_t size;
+            /* relative to header::paths_offset */
+            std::uint32_t path_offset;
+            std::uint32_t path_size;
+            archive_compression compression;
+            std::uint32_t reserved;
+        };
+
+        [[nodiscard]] static auto open(const std::filesystem::path& path) -> std::optional<archive>;
+        /* fnv-1a, over the normalized (forward slashes, relative) path */
+        [[nodiscard]] static auto hash_path(std::string_view path) noexcept -> std::uint64_t;
+
+        /* binary search over the table of contents, nullptr if not found */
+        [[nodiscard]] auto find(std::string_view path) const noexcept -> const entry*;
+        [[nodiscard]] auto entries() const noexcept -> std::span<const entry>;
+        [[nodiscard]] auto path_of(const entry& entry) const noexcept -> std::string_view;
+        /* the bytes as stored in the mapping, only the uncompressed data for archive_compression::none */
+        [[nodiscard]] auto stored_data(const entry& entry) const noexcept -> std::span<const byte>;
+        /* decompresses if needed */
+        [[nodiscard]] auto read(const entry& entry) const -> std::optional<std::vector<byte>>;
+
+      private:
+        mapped_file m_file;
+        std::vector<entry> m_entries;
+        std::uint64_t m_paths_offset = 0;
+    };
+
+    struct archive_writer
+    {
+        /* lz4 entries that would not get any smaller are stored raw */
+        auto add(std::string_view path, std::span<const byte> data, archive_compression compression = archive_compression::lz4) -> void;
+        [[nodiscard]] auto write(const std::filesystem::path& path) const -> bool;
+
+      private:
+        struct pending_entry
+        {
+            std::string path;
+            std::vector<byte> stored;
+            std::uint64_t size;
+            archive_compression compression;
+        };
+        std::vector<pending_entry> m_entries;
+    };
+
+    /*
+    packs every file under directory into an archive at output, paths relative to directory
+    already compressed formats (images, audio) are stored raw, everything else is lz4 compressed
+    */
+    [[nodiscard]] auto pack_directory(const std::filesystem::path& directory, const std::filesystem::path& output) -> bool;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "fae/core/byte.hpp"
+
+namespace fae
+{
+    /*
+    read only memory mapping of a whole file
+    (on the web there is no mmap, so the file is read into memory instead)
+    */
+    struct mapped_file
+    {
+        mapped_file() noexcept = default;
+        mapped_file(const mapped_file&) = delete;
+        auto operator=(const mapped_file&) -> mapped_file& = delete;
+        mapped_file(mapped_file&& other) noexcept;
+        auto operator=(mapped_file&& other) noexcept -> mapped_file&;
+        ~mapped_file();
+
+        [[nodiscard]] static auto open(const std::filesystem::path& path) -> std::optional<mapped_file>;
+
+        [[nodiscard]] auto data() const noexcept -> std::span<const byte>
+        {
+            return { m_data, m_size };
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t
+        {
+            return m_size;
+        }
+
+      private:
+        const byte* m_data = nullptr;
+        std::size_t m_size = 0;
+#if defined(FAE_PLATFORM_WEB)
+        std::vector<byte> m_storage;
+#elif defined(FAE_PLATFORM_WINDOWS)
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#endif
+
+        auto close() noexcept -> void;
+    };
+}
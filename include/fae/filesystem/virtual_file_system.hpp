@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "fae/core/byte.hpp"
+#include "fae/filesystem/archive.hpp"
+
+namespace fae
+{
+    /*
+    contents of a file read through the virtual file system
+    raw archive entries are viewed in place in the mapping (no copy), everything else is owned
+    */
+    struct file_contents
+    {
+        std::span<const byte> view{};
+        std::vector<byte> storage{};
+
+        [[nodiscard]] auto data() const noexcept -> std::span<const byte>
+        {
+            return storage.empty() ? view : std::span<const byte>(storage);
+        }
+
+        [[nodiscard]] auto as_string_view() const noexcept -> std::string_view
+        {
+            const auto bytes = data();
+            return { reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+        }
+    };
+
+    /*
+    resolves asset paths against a set of mounted directories & archives
+    a path is looked up in every mount whose mount point is a prefix of it, highest priority first
+    (the most recent mount wins between equal priorities), so e.g. a patch archive can overlay a base one
+    views into archives stay valid for as long as the archive stays mounted
+    absolute paths are not virtual, they are read from disk as given
+    */
+    struct virtual_file_system
+    {
+        auto mount_directory(std::string_view mount_point, const std::filesystem::path& directory, int priority = 0) -> void;
+        [[nodiscard]] auto mount_archive(std::string_view mount_point, const std::filesystem::path& archive_path, int priority = 0) -> bool;
+        /* removes every mount at that mount point */
+        auto unmount(std::string_view mount_point) -> void;
+
+        [[nodiscard]] auto exists(const std::filesystem::path& path) const -> bool;
+        [[nodiscard]] auto read(const std::filesystem::path& path) const -> std::optional<file_contents>;
+
+      private:
+        struct mount
+        {
+            std::string point;
+            int priority;
+            std::variant<std::filesystem::path, archive> source;
+        };
+        /* sorted by descending priority */
+        std::vector<mount> m_mounts;
+
+        auto add_mount(mount&& mount) -> void;
+    };
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "fae/duration.hpp"
+#include "fae/profiler.hpp"
+
+namespace fae
+{
+    struct application;
+    struct pre_update_step;
+
+    /* counted by the renderer (from any thread), taken by the flight recorder once per frame */
+    auto count_frame_draws(std::uint64_t count) noexcept -> void;
+    auto count_frame_uploaded_bytes(std::uint64_t bytes) noexcept -> void;
+
+    enum struct flight_recorder_format
+    {
+        json,
+        csv,
+    };
+
+    /*
+    the step & system times, draws, uploaded bytes & allocations of the last frames in a fixed ring, a resource (see flight_recorder_plugin)
+    recording costs two clock reads per step & system, nothing is allocated once the ring exists
+    dumps are copied out of the ring & written by a thread of their own (on the calling thread on the web)
+    */
+    struct flight_recorder
+    {
+        /* more steps or systems in a frame are not recorded */
+        static constexpr std::size_t max_steps_per_frame = 32;
+        static constexpr std::size_t max_systems_per_frame = 256;
+
+        struct timing
+        {
+            const profile_zone* zone = nullptr;
+            std::chrono::nanoseconds time{};
+        };
+
+        struct frame
+        {
+            std::uint64_t index = 0;
+            duration time{};
+            std::uint64_t draws = 0;
+            std::uint64_t uploaded_bytes = 0;
+            /* of the last allocation_report, only counted with allocation_tracking_plugin & FAE_TRACK_ALLOCATIONS */
+            std::uint64_t allocations = 0;
+            std::uint64_t allocated_bytes = 0;
+            /* systems of a batch run in parallel, so their slots are claimed atomically */
+            std::atomic<std::uint32_t> step_count = 0;
+            std::atomic<std::uint32_t> system_count = 0;
+            std::array<timing, max_steps_per_frame> steps{};
+            std::array<timing, max_systems_per_frame> systems{};
+        };
+
+        /* the thread dumps are written on, started by the first dump */
+        struct dump_writer
+        {
+            dump_writer() noexcept;
+            dump_writer(dump_writer&&) noexcept;
+            auto operator=(dump_writer&&) noexcept -> dump_writer&;
+            ~dump_writer();
+
+            /* copies the complete frames of recorder & hands them to the thread, false (& nothing is written) while the last dump is still being written */
+            [[nodiscard]] auto try_write(const flight_recorder& recorder, std::filesystem::path path, std::uint64_t hitch) -> bool;
+            /* returns once the dump being written (if any) is written */
+            auto wait() -> void;
+
+          private:
+            struct state;
+            auto stop() noexcept -> void;
+
+            std::unique_ptr<state> m_state;
+        };
+
+        /* frames longer than this are hitches */
+        duration budget = std::chrono::nanoseconds(33'333'333);
+        /* frames recorded after a hitch before the ring is written, so the dump shows what led to it & what followed */
+        std::uint32_t frames_after_hitch = 60;
+        std::filesystem::path directory = "hitches";
+        flight_recorder_format format = flight_recorder_format::json;
+        /* hitches written at most, the rest are only counted */
+        std::uint32_t max_dumps = 16;
+
+        /* the ring, frames[frame_index % frames.size()] is being recorded */
+        std::vector<frame> frames{};
+        std::uint64_t frame_index = 0;
+        std::chrono::steady_clock::time_point frame_start{};
+        std::uint64_t hitches = 0;
+        std::uint32_t dumps = 0;
+        /* frame the pending dump is for & the frame it is written after, 0 if none is pending */
+        std::uint64_t pending_hitch = 0;
+        std::uint64_t pending_dump_frame = 0;
+        /* copying the ring for a dump makes the frame it is copied in slower, that frame is not a hitch */
+        bool is_dump_frame = false;
+        dump_writer writer{};
+
+        /* called by the scheduler for every invoke & system call once it has the recorder (see scheduler::set_flight_recorder) */
+        auto record_step(const profile_zone& step, std::chrono::nanoseconds time) noexcept -> void;
+        auto record_system(const profile_zone& system, std::chrono::nanoseconds time) noexcept -> void;
+
+        /* closes the frame being recorded & starts the next one, handing a dump to the writer when a hitch's window is complete */
+        auto end_frame(std::uint64_t allocations, std::uint64_t allocated_bytes) noexcept -> void;
+
+        /* writes the recorded frames on the calling thread, oldest first, hitch is the frame to point out (0 for none) */
+        [[nodiscard]] auto write(const std::filesystem::path& path, flight_recorder_format file_format, std::uint64_t hitch = 0) const -> bool;
+        /* returns once the dump being written (if any) is on disk */
+        auto wait_for_dumps() -> void;
+    };
+
+    struct flight_recorder_plugin
+    {
+        /* frames kept in the ring */
+        std::size_t frame_count = 300;
+        duration budget = std::chrono::nanoseconds(33'333'333);
+        std::uint32_t frames_after_hitch = 60;
+        std::filesystem::path directory = "hitches";
+        flight_recorder_format format = flight_recorder_format::json;
+        std::uint32_t max_dumps = 16;
+
+        auto init(application& app) const noexcept -> void;
+    };
+
+    auto record_flight_frame(const pre_update_step& step) noexcept -> void;
+}
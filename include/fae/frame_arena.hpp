@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "fae/core/linear_arena.hpp"
+#include "fae/core/unique_id.hpp"
+
+namespace fae
+{
+    /*
+    memory for temporaries that only live for a frame (query results, recorded draws, ...), freed all at once instead of one free per allocation
+    double buffered: what is allocated in a frame stays valid until the end of the next one, while the render thread may still submit it
+    one linear_arena per thread slot (see job_system::current_thread_slot), so systems running in parallel allocate without locking
+    get the calling thread's arena with ecs_world::frame_allocator()
+    */
+    struct frame_arena
+    {
+        /* the arena of a thread slot in the current frame, cached per thread so only its first use in a frame locks */
+        [[nodiscard]] auto for_thread(std::size_t slot) -> linear_arena&;
+
+        /* called by the application at the start of every frame, resets the arenas of two frames ago */
+        auto next_frame() -> void;
+
+        [[nodiscard]] auto frame() const noexcept -> std::uint64_t
+        {
+            return m_frame.load(std::memory_order_acquire);
+        }
+
+        /* bytes allocated in the current frame, over every thread */
+        [[nodiscard]] auto bytes_used() -> std::size_t;
+
+      private:
+        std::mutex m_mutex;
+        std::array<std::vector<std::unique_ptr<linear_arena>>, 2> m_arenas{};
+        std::atomic<std::uint64_t> m_frame = 0;
+        /* tells the thread caches of different frame arenas apart, even one created where another was destroyed */
+        unique_id m_id{};
+
+        [[nodiscard]] auto current_arenas() noexcept -> std::vector<std::unique_ptr<linear_arena>>&
+        {
+            return m_arenas[m_frame.load(std::memory_order_relaxed) % m_arenas.size()];
+        }
+    };
+}
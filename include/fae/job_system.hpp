@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace fae
+{
+    /* number of jobs still running, wait on it to join the jobs it counts */
+    struct job_counter
+    {
+        std::atomic<std::size_t> pending = 0;
+
+        [[nodiscard]] auto is_done() const noexcept -> bool
+        {
+            return pending.load(std::memory_order_acquire) == 0;
+        }
+    };
+
+    struct job_system_settings
+    {
+        /* background workers, the thread that waits on a counter also runs jobs */
+        std::size_t worker_count = default_worker_count();
+        /* pin worker i to core i + 1 (leaving core 0 to the main thread) */
+        bool pin_workers = false;
+
+        [[nodiscard]] static auto default_worker_count() noexcept -> std::size_t
+        {
+#ifdef FAE_PLATFORM_WEB
+            return 0;
+#else
+            const auto hardware_threads = static_cast<std::size_t>(std::thread::hardware_concurrency());
+            return hardware_threads > 1 ? hardware_threads - 1 : 0;
+#endif
+        }
+    };
+
+    /*
+    work stealing job system
+    every worker owns a deque, it pushes & pops its own jobs at the back (lifo, cache warm) while idle workers steal from the front
+    threads that are not workers push into a shared queue
+    jobs reference their callable, which must outlive the wait on their counter (i.e. fork/join, nothing is allocated per job)
+    */
+    struct job_system
+    {
+        explicit job_system(job_system_settings settings = {});
+        job_system(const job_system&) = delete;
+        auto operator=(const job_system&) -> job_system& = delete;
+        ~job_system();
+
+        /* stops & restarts the workers, must not be called while jobs are running */
+        auto configure(job_system_settings settings) -> void;
+        [[nodiscard]] auto settings() const noexcept -> const job_system_settings&;
+        [[nodiscard]] auto worker_count() const noexcept -> std::size_t;
+        /* index of the calling worker, or worker_count() for any other thread (shared) */
+        [[nodiscard]] auto current_thread_slot() const noexcept -> std::size_t;
+
+        /* runs fn() as a job counted by counter */
+        template <typename t_fn>
+        auto run(job_counter& counter, const t_fn& fn) -> void
+        {
+            push(job{
+                .invoke = [](const void* context, std::size_t, std::size_t)
+                { (*static_cast<const t_fn*>(context))(); },
+                .context = &fn,
+                .begin = 0,
+                .end = 1,
+                .grain = 1,
+                .counter = &counter,
+            });
+        }
+
+        /*
+        calls fn(begin, end) over chunks of at most grain indices covering [0, count) & returns once all of them ran
+        ranges are split in halves lazily as they get picked up, so idle workers steal the big halves
+        */
+        template <typename t_fn>
+        auto parallel_for(std::size_t count, std::size_t grain, const t_fn& fn) -> void
+        {
+            if (count == 0)
+            {
+                return;
+            }
+            grain = grain == 0 ? 1 : grain;
+            if (count <= grain || m_workers.empty())
+            {
+                fn(std::size_t{ 0 }, count);
+                return;
+            }
+            auto counter = job_counter{};
+            push(job{
+                .invoke = [](const void* context, std::size_t begin, std::size_t end)
+                { (*static_cast<const t_fn*>(context))(begin, end); },
+                .context = &fn,
+                .begin = 0,
+                .end = count,
+                .grain = grain,
+                .counter = &counter,
+            });
+            wait(counter);
+        }
+
+        /* runs other jobs until counter reaches zero, sleeps while the jobs left run on other threads */
+        auto wait(job_counter& counter) -> void;
+
+      private:
+        struct job
+        {
+            void (*invoke)(const void* context, std::size_t begin, std::size_t end);
+            const void* context;
+            std::size_t begin;
+            std::size_t end;
+            std::size_t grain;
+            job_counter* counter;
+        };
+
+        struct queue
+        {
+            std::mutex mutex;
+            std::deque<job> jobs;
+        };
+
+        job_system_settings m_settings;
+        std::vector<std::jthread> m_workers;
+        /* one per worker & a last shared one for every other thread */
+        std::vector<std::unique_ptr<queue>> m_queues;
+        std::atomic<std::size_t> m_queued = 0;
+        /* jobs finished so far, what waiting threads sleep on */
+        std::atomic<std::uint32_t> m_finished = 0;
+        std::atomic<bool> m_stopping = false;
+
+        auto start() -> void;
+        auto stop() -> void;
+        auto push(job&& job) -> void;
+        [[nodiscard]] auto pop(std::size_t queue_index) -> std::optional<job>;
+        [[nodiscard]] auto steal(std::size_t thief_index) -> std::optional<job>;
+        [[nodiscard]] auto current_queue_index() const noexcept -> std::size_t;
+        /* pops or steals one job & runs it, false if there was none */
+        auto run_one() -> bool;
+        auto execute(job job) -> void;
+        auto work(std::size_t worker_index) -> void;
+    };
+}
@@ -1,12 +1,19 @@
 #pragma once
 
 #include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <format>
-#include <iostream>
-#include <print>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <source_location>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
 
 #include "fae/core/exit.hpp"
 
@@ -18,6 +25,11 @@
 
 #include "fae/config.hpp"
 
+/* log calls below this level (0 debug, 1 info, 2 warning, 3 error, 4 fatal) are compiled out, set with the FAE_LOG_MIN_LEVEL cmake option */
+#ifndef FAE_LOG_MIN_LEVEL
+#define FAE_LOG_MIN_LEVEL 0
+#endif
+
 namespace fae
 {
     enum struct log_level
@@ -90,97 +102,346 @@ namespace fae
         bool show_time = false;
         bool show_source_location = false;
         std::source_location source_location = std::source_location::current();
+        /* the stack trace is only captured (by the log call) when set */
         bool show_stacktrace = false;
-#ifndef FAE_PLATFORM_WEB
-        std::stacktrace stacktrace = std::stacktrace::current();
-#endif
     };
 
-    template <std::formattable<char> t_log_arg>
-    constexpr auto log(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
+    inline constexpr auto min_log_level = static_cast<log_level>(FAE_LOG_MIN_LEVEL);
+
+    /* release builds only keep fatal logs, which exit without writing */
+    [[nodiscard]] constexpr auto is_log_level_enabled(log_level level) noexcept -> bool
+    {
+        return !config::is_release_build && level >= min_log_level;
+    }
+
+    /* blocks until everything logged so far (by any thread) is written */
+    auto flush_logs() noexcept -> void;
+
+    /* a format string checked against the arguments at compile time, remembering where it was written */
+    template <typename... t_args>
+    struct log_format_string
+    {
+        template <typename t>
+            requires std::convertible_to<const t&, std::string_view>
+        consteval log_format_string(const t& text, std::source_location location = std::source_location::current())
+            : format(text), source_location(location)
+        {
+        }
+
+        std::format_string<t_args...> format;
+        std::source_location source_location;
+    };
+
+    /*
+    arguments the logging thread can format from a copy, after the log call returned
+    anything else (views, ranges, types holding references or pointers to what they show) is formatted by the log call itself
+    specialize it for value types of your own that are cheap to copy, e.g. template <> struct fae::is_deferred_log_argument<my_id> : std::true_type {};
+    */
+    template <typename t>
+    struct is_deferred_log_argument : std::bool_constant<std::is_arithmetic_v<t> || std::is_enum_v<t> || std::is_pointer_v<t> || std::is_null_pointer_v<t>>
+    {
+    };
+
+    template <typename t_rep, typename t_period>
+    struct is_deferred_log_argument<std::chrono::duration<t_rep, t_period>> : std::true_type
+    {
+    };
+
+    template <typename t_clock, typename t_duration>
+    struct is_deferred_log_argument<std::chrono::time_point<t_clock, t_duration>> : std::true_type
+    {
+    };
+
+    namespace detail
     {
-        if constexpr (config::is_release_build)
+        /*
+        log calls encode their arguments into a queue of the calling thread, a logging thread formats & writes them (see src/logging.cpp)
+        strings are copied by content (they may be temporaries or buffers that change after the call), deferred arguments by copy construction
+        a call with any other argument formats its message first & queues it as a string
+        */
+        template <typename t>
+        concept log_string = std::convertible_to<const t&, std::string_view>;
+
+        template <typename t>
+        concept deferred_log_argument = log_string<t> || is_deferred_log_argument<std::remove_cvref_t<t>>::value;
+
+        template <typename t>
+        using log_stored_t = std::remove_cvref_t<t>;
+
+        template <typename t>
+        using log_decoded_t = std::conditional_t<log_string<t>, std::string_view, const log_stored_t<t>&>;
+
+        /* a log call as queued, followed by its stack trace & encoded arguments */
+        struct log_record
         {
-            if (options.level == log_level::fatal)
+            /* of the record, its stack trace & arguments, a multiple of alignof(log_record) */
+            std::uint32_t size = 0;
+            /* the end of a queue a record didn't fit in, skipped */
+            bool is_padding = false;
+            bool show_level = true;
+            bool show_time = false;
+            bool show_source_location = false;
+            log_level level = log_level::debug;
+            std::uint32_t line = 0;
+            std::uint32_t stacktrace_size = 0;
+            const char* file = nullptr;
+            std::chrono::system_clock::time_point time{};
+            std::string_view format{};
+            /* appends the formatted message to out & destroys the arguments */
+            auto (*format_arguments)(std::string_view format, const std::byte* arguments, std::string& out) noexcept -> void = nullptr;
+        };
+
+        template <typename t_byte>
+        [[nodiscard]] auto align_log_cursor(t_byte* cursor, std::size_t alignment) noexcept -> t_byte*
+        {
+            const auto address = reinterpret_cast<std::uintptr_t>(cursor);
+            return cursor + (alignment - address % alignment) % alignment;
+        }
+
+        /* upper bound of the bytes value takes once encoded, alignment included */
+        template <typename t>
+        [[nodiscard]] auto encoded_log_size(const t& value) noexcept -> std::size_t
+        {
+            if constexpr (log_string<t>)
             {
-#ifdef FAE_PLATFORM_WEB
-                emscripten_force_exit(exit_failure);
-#endif
-                std::exit(exit_failure);
+                return sizeof(std::uint32_t) + std::string_view(value).size();
+            }
+            else
+            {
+                return sizeof(log_stored_t<t>) + alignof(log_stored_t<t>) - 1;
             }
-            return;
         }
-        std::string result_msg;
-        if (options.show_time)
+
+        template <typename t>
+        auto encode_log_argument(std::byte*& cursor, const t& value) noexcept -> void
         {
-            result_msg += std::format("[{}] ", std::chrono::system_clock::now());
+            if constexpr (log_string<t>)
+            {
+                const auto text = std::string_view(value);
+                const auto size = static_cast<std::uint32_t>(text.size());
+                std::memcpy(cursor, &size, sizeof(size));
+                std::memcpy(cursor + sizeof(size), text.data(), text.size());
+                cursor += sizeof(size) + text.size();
+            }
+            else
+            {
+                cursor = align_log_cursor(cursor, alignof(log_stored_t<t>));
+                ::new (static_cast<void*>(cursor)) log_stored_t<t>(value);
+                cursor += sizeof(log_stored_t<t>);
+            }
         }
-        if (options.show_source_location)
+
+        template <typename t>
+        [[nodiscard]] auto decode_log_argument(const std::byte*& cursor) noexcept -> log_decoded_t<t>
         {
-            result_msg += std::format("[{}:{}] ", options.source_location.file_name(), options.source_location.line());
+            if constexpr (log_string<t>)
+            {
+                auto size = std::uint32_t{};
+                std::memcpy(&size, cursor, sizeof(size));
+                const auto text = std::string_view(reinterpret_cast<const char*>(cursor + sizeof(size)), size);
+                cursor += sizeof(size) + size;
+                return text;
+            }
+            else
+            {
+                cursor = align_log_cursor(cursor, alignof(log_stored_t<t>));
+                const auto* value = std::launder(reinterpret_cast<const log_stored_t<t>*>(cursor));
+                cursor += sizeof(log_stored_t<t>);
+                return *value;
+            }
         }
-        if (options.show_level)
+
+        template <typename t>
+        auto destroy_log_argument(log_decoded_t<t> value) noexcept -> void
         {
-            result_msg += std::format("[{}] ", options.level);
+            if constexpr (!log_string<t> && !std::is_trivially_destructible_v<log_stored_t<t>>)
+            {
+                std::destroy_at(const_cast<log_stored_t<t>*>(&value));
+            }
         }
 
-        result_msg += std::format("{}", msg);
-
-#ifndef FAE_PLATFORM_WEB
-        if (options.show_stacktrace)
+        template <typename... t_args>
+        auto format_log_arguments(std::string_view format, const std::byte* arguments, std::string& out) noexcept -> void
         {
-            result_msg += std::format("\n{}", options.stacktrace);
+            auto cursor = arguments;
+            // braced initialization decodes in order
+            const auto values = std::tuple<log_decoded_t<t_args>...>{ decode_log_argument<t_args>(cursor)... };
+            [&]<std::size_t... i>(std::index_sequence<i...>)
+            {
+                try
+                {
+                    std::vformat_to(std::back_inserter(out), format, std::make_format_args(std::get<i>(values)...));
+                }
+                catch (const std::exception& error)
+                {
+                    out += "[log format error: ";
+                    out += error.what();
+                    out += ']';
+                }
+                (destroy_log_argument<t_args>(std::get<i>(values)), ...);
+            }(std::index_sequence_for<t_args...>{});
         }
+
+        /* space for a record of size bytes in the calling thread's queue, pass it to commit_log_record once written */
+        [[nodiscard]] auto reserve_log_record(std::size_t size) noexcept -> std::byte*;
+        auto commit_log_record(std::byte* record) noexcept -> void;
+
+        template <typename... t_args>
+        auto enqueue_log_record(const log_options& options, std::string_view format, const t_args&... args) noexcept -> void
+        {
+            auto stacktrace = std::string{};
+#ifndef FAE_PLATFORM_WEB
+            if (options.show_stacktrace)
+            {
+                // skips enqueue_log_record & enqueue_log
+                stacktrace = std::to_string(std::stacktrace::current(2));
+            }
 #endif
+            const auto unaligned_size = sizeof(log_record) + stacktrace.size() + (encoded_log_size(args) + ... + std::size_t{ 0 });
+            const auto size = (unaligned_size + alignof(log_record) - 1) / alignof(log_record) * alignof(log_record);
+            auto* memory = reserve_log_record(size);
+            ::new (static_cast<void*>(memory)) log_record{
+                .size = static_cast<std::uint32_t>(size),
+                .show_level = options.show_level,
+                .show_time = options.show_time,
+                .show_source_location = options.show_source_location,
+                .level = options.level,
+                .line = options.source_location.line(),
+                .stacktrace_size = static_cast<std::uint32_t>(stacktrace.size()),
+                .file = options.source_location.file_name(),
+                .time = options.show_time ? std::chrono::system_clock::now() : std::chrono::system_clock::time_point{},
+                .format = format,
+                .format_arguments = &format_log_arguments<t_args...>,
+            };
+            std::memcpy(memory + sizeof(log_record), stacktrace.data(), stacktrace.size());
+            auto* cursor = memory + sizeof(log_record) + stacktrace.size();
+            (encode_log_argument(cursor, args), ...);
+            commit_log_record(memory);
+        }
 
-        std::println("{}", result_msg);
+        template <typename... t_args>
+        auto enqueue_log(const log_options& options, std::string_view format, const t_args&... args) noexcept -> void
+        {
+            if constexpr ((deferred_log_argument<t_args> && ...))
+            {
+                enqueue_log_record(options, format, args...);
+            }
+            else
+            {
+                auto message = std::string{};
+                try
+                {
+                    std::vformat_to(std::back_inserter(message), format, std::make_format_args(args...));
+                }
+                catch (const std::exception& error)
+                {
+                    message += "[log format error: ";
+                    message += error.what();
+                    message += ']';
+                }
+                enqueue_log_record(options, "{}", message);
+            }
+        }
 
-        if (options.level == log_level::fatal)
+        [[noreturn]] inline auto exit_after_fatal_log() noexcept -> void
         {
+            flush_logs();
 #ifdef FAE_PLATFORM_WEB
             emscripten_force_exit(exit_failure);
 #endif
             std::exit(exit_failure);
         }
+
+        template <log_level t_level, typename... t_args>
+        auto log_at_level(log_options options, std::string_view format, const t_args&... args) noexcept -> void
+        {
+            options.level = t_level;
+            if constexpr (is_log_level_enabled(t_level))
+            {
+                enqueue_log(options, format, args...);
+            }
+            if constexpr (t_level == log_level::fatal)
+            {
+                exit_after_fatal_log();
+            }
+        }
+    }
+
+    /*
+    queues msg to be written by the logging thread (the calling thread only copies it, see is_deferred_log_argument), fatal logs are written before exiting
+    messages of one thread are written in order, the ones of different threads in the order they reach the logging thread
+    */
+    template <std::formattable<char> t_log_arg>
+    auto log(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
+    {
+        if (is_log_level_enabled(options.level))
+        {
+            detail::enqueue_log(options, "{}", msg);
+        }
+        if (options.level == log_level::fatal)
+        {
+            detail::exit_after_fatal_log();
+        }
     }
 
     template <typename t_log_arg>
-    constexpr auto log_debug(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
+    auto log_debug(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
+    {
+        detail::log_at_level<log_level::debug>(options, "{}", msg);
+    }
+
+    /* formatted by the logging thread when every argument is deferred, e.g. fae::log_debug("loaded {} in {}", path, elapsed); */
+    template <typename... t_args>
+    auto log_debug(log_format_string<std::type_identity_t<const t_args&>...> format, const t_args&... args) noexcept -> void
     {
-        auto debug_options = options;
-        debug_options.level = log_level::debug;
-        log(msg, debug_options);
+        detail::log_at_level<log_level::debug>(log_options{ .source_location = format.source_location }, format.format.get(), args...);
     }
 
     template <typename t_log_arg>
-    constexpr auto log_info(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
+    auto log_info(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
     {
-        auto info_options = options;
-        info_options.level = log_level::info;
-        log(msg, info_options);
+        detail::log_at_level<log_level::info>(options, "{}", msg);
+    }
+
+    template <typename... t_args>
+    auto log_info(log_format_string<std::type_identity_t<const t_args&>...> format, const t_args&... args) noexcept -> void
+    {
+        detail::log_at_level<log_level::info>(log_options{ .source_location = format.source_location }, format.format.get(), args...);
     }
 
     template <typename t_log_arg>
-    constexpr auto log_warning(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
+    auto log_warning(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
+    {
+        detail::log_at_level<log_level::warning>(options, "{}", msg);
+    }
+
+    template <typename... t_args>
+    auto log_warning(log_format_string<std::type_identity_t<const t_args&>...> format, const t_args&... args) noexcept -> void
     {
-        auto warning_options = options;
-        warning_options.level = log_level::warning;
-        log(msg, warning_options);
+        detail::log_at_level<log_level::warning>(log_options{ .source_location = format.source_location }, format.format.get(), args...);
     }
 
     template <typename t_log_arg>
-    constexpr auto log_error(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
+    auto log_error(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
     {
-        auto error_options = options;
-        error_options.level = log_level::error;
-        log(msg, error_options);
+        detail::log_at_level<log_level::error>(options, "{}", msg);
+    }
+
+    template <typename... t_args>
+    auto log_error(log_format_string<std::type_identity_t<const t_args&>...> format, const t_args&... args) noexcept -> void
+    {
+        detail::log_at_level<log_level::error>(log_options{ .source_location = format.source_location }, format.format.get(), args...);
     }
 
     template <typename t_log_arg>
-    constexpr auto log_fatal(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
+    auto log_fatal(const t_log_arg& msg, const log_options& options = {}) noexcept -> void
+    {
+        detail::log_at_level<log_level::fatal>(options, "{}", msg);
+    }
+
+    template <typename... t_args>
+    auto log_fatal(log_format_string<std::type_identity_t<const t_args&>...> format, const t_args&... args) noexcept -> void
     {
-        auto error_options = options;
-        error_options.level = log_level::fatal;
-        log(msg, error_options);
+        detail::log_at_level<log_level::fatal>(log_options{ .source_location = format.source_location }, format.format.get(), args...);
     }
 }
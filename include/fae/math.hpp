@@ -66,11 +66,28 @@ namespace fae
             return rotation * vec3{ 0.f, 1.f, 0.f };
         }
 
+        /*
+        translate * rotate * scale, composed directly rather than by multiplying the three matrices (same result)
+        the scalar reference of the batched compose_trs kernels (see transform_batch.hpp)
+        */
         [[nodiscard]] inline constexpr auto to_mat4() const noexcept -> mat4
         {
-            return math::translate(mat4{ 1.f }, position) *
-                   math::toMat4(rotation) *
-                   math::scale(mat4{ 1.f }, scale);
+            const auto xx = rotation.x * rotation.x;
+            const auto yy = rotation.y * rotation.y;
+            const auto zz = rotation.z * rotation.z;
+            const auto xz = rotation.x * rotation.z;
+            const auto xy = rotation.x * rotation.y;
+            const auto yz = rotation.y * rotation.z;
+            const auto wx = rotation.w * rotation.x;
+            const auto wy = rotation.w * rotation.y;
+            const auto wz = rotation.w * rotation.z;
+
+            auto result = mat4{ 1.f };
+            result[0] = vec4((1.f - 2.f * (yy + zz)) * scale.x, (2.f * (xy + wz)) * scale.x, (2.f * (xz - wy)) * scale.x, 0.f);
+            result[1] = vec4((2.f * (xy - wz)) * scale.y, (1.f - 2.f * (xx + zz)) * scale.y, (2.f * (yz + wx)) * scale.y, 0.f);
+            result[2] = vec4((2.f * (xz + wy)) * scale.z, (2.f * (yz - wx)) * scale.z, (1.f - 2.f * (xx + yy)) * scale.z, 0.f);
+            result[3] = vec4(position, 1.f);
+            return result;
         }
 
         auto to_bytes() const -> std::array<std::uint8_t, bytes_in_transform>
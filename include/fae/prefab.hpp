@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "fae/core/erased_ptr.hpp"
+#include "fae/entity.hpp"
+
+namespace fae
+{
+    /*
+    a set of components to stamp onto new entities, each instance gets a copy of every component
+    e.g. auto tree = prefab{}.with(transform{}).with(model{ ... });
+         ecs_world.spawn_batch(tree, 10'000);
+    instantiating inserts each component into all the new entities at once (one reserve & one range insert per component)
+    */
+    struct prefab
+    {
+        prefab() = default;
+        prefab(prefab&&) noexcept = default;
+        auto operator=(prefab&&) noexcept -> prefab& = default;
+
+        prefab(const prefab& other)
+        {
+            m_components.reserve(other.m_components.size());
+            for (const auto& component : other.m_components)
+            {
+                m_components.push_back(prefab_component{
+                    .type = component.type,
+                    .insert = component.insert,
+                    .copy = component.copy,
+                    .value = component.copy(component.value.get()),
+                });
+            }
+        }
+
+        auto operator=(const prefab& other) -> prefab&
+        {
+            if (this != &other)
+            {
+                *this = prefab(other);
+            }
+            return *this;
+        }
+
+        /* adds the component to the template, replacing the one of the same type if there is one */
+        template <typename t_component>
+        [[maybe_unused]] auto with(t_component&& component) -> prefab&
+        {
+            using t_value = std::remove_cvref_t<t_component>;
+            auto entry = prefab_component{
+                .type = entt::type_hash<t_value>::value(),
+                .insert = &insert_component<t_value>,
+                .copy = &copy_component<t_value>,
+                .value = make_erased<t_value>(std::forward<t_component>(component)),
+            };
+            auto existing = std::ranges::find(m_components, entry.type, &prefab_component::type);
+            if (existing != m_components.end())
+            {
+                *existing = std::move(entry);
+            }
+            else
+            {
+                m_components.push_back(std::move(entry));
+            }
+            return *this;
+        }
+
+        template <typename t_component>
+        [[nodiscard]] auto has() const noexcept -> bool
+        {
+            return std::ranges::find(m_components, entt::type_hash<std::remove_cvref_t<t_component>>::value(), &prefab_component::type) != m_components.end();
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t
+        {
+            return m_components.size();
+        }
+
+        /* gives every entity in ids (which must exist & not have the components yet) a copy of the components */
+        auto instantiate(entity_registry_t& registry, std::span<const entity> ids) const -> void
+        {
+            for (const auto& component : m_components)
+            {
+                component.insert(registry, ids, component.value.get());
+            }
+        }
+
+      private:
+        struct prefab_component
+        {
+            entt::id_type type;
+            void (*insert)(entity_registry_t& registry, std::span<const entity> ids, const void* value);
+            erased_ptr (*copy)(const void* value);
+            erased_ptr value;
+        };
+
+        std::vector<prefab_component> m_components{};
+
+        template <typename t_component>
+        static auto insert_component(entity_registry_t& registry, std::span<const entity> ids, const void* value) -> void
+        {
+            auto& storage = registry.storage<t_component>();
+            storage.reserve(storage.size() + ids.size());
+            if constexpr (std::is_empty_v<t_component>)
+            {
+                registry.insert<t_component>(ids.begin(), ids.end());
+            }
+            else
+            {
+                registry.insert<t_component>(ids.begin(), ids.end(), *static_cast<const t_component*>(value));
+            }
+        }
+
+        template <typename t_component>
+        [[nodiscard]] static auto copy_component(const void* value) -> erased_ptr
+        {
+            return make_erased<t_component>(*static_cast<const t_component*>(value));
+        }
+    };
+}
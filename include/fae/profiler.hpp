@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#ifdef FAE_PROFILE
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace fae
+{
+    /* static metadata of a profiled scope, zones are recorded by address so it must outlive the profile (see FAE_PROFILE_SCOPE) */
+    struct profile_zone
+    {
+        std::string_view name{};
+        const char* file = "";
+        std::uint32_t line = 0;
+    };
+
+    /*
+    zones are only recorded when built with FAE_PROFILE (cmake option)
+    without it the scope macros expand to nothing & the scheduler's zones are compiled out
+    */
+    [[nodiscard]] constexpr auto is_profiling() noexcept -> bool
+    {
+#ifdef FAE_PROFILE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+#ifdef FAE_PROFILE
+    /* cpu timestamp counter where there is one (converted when exporting), steady_clock nanoseconds otherwise */
+    [[nodiscard]] inline auto profile_timestamp() noexcept -> std::uint64_t
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /* appends to the calling thread's buffer (a ring of the latest zones, nothing is allocated after its first zone) */
+    auto record_profile_zone(const profile_zone& zone, std::uint64_t begin, std::uint64_t end) noexcept -> void;
+
+    struct profile_scope
+    {
+        explicit profile_scope(const profile_zone& zone) noexcept : m_zone(&zone), m_begin(profile_timestamp())
+        {
+        }
+
+        ~profile_scope()
+        {
+            record_profile_zone(*m_zone, m_begin, profile_timestamp());
+        }
+
+        profile_scope(const profile_scope&) = delete;
+        auto operator=(const profile_scope&) -> profile_scope& = delete;
+
+      private:
+        const profile_zone* m_zone;
+        std::uint64_t m_begin;
+    };
+#else
+    struct profile_scope
+    {
+        explicit constexpr profile_scope([[maybe_unused]] const profile_zone& zone) noexcept
+        {
+        }
+
+        profile_scope(const profile_scope&) = delete;
+        auto operator=(const profile_scope&) -> profile_scope& = delete;
+    };
+#endif
+
+    /* a zone named at runtime (e.g. a system), kept until exit, call once per name & keep the result */
+    [[nodiscard]] auto make_profile_zone(std::string name) -> const profile_zone&;
+
+    /*
+    readable name of a function, its symbol where the platform can tell (exported symbols only), its address otherwise
+    an executable's own functions are only named when it exports its symbols (cmake ENABLE_EXPORTS, i.e. -rdynamic)
+    */
+    [[nodiscard]] auto describe_function_address(const void* address) -> std::string;
+
+    /* a zone named after the function at address, made once per function & kept until exit */
+    [[nodiscard]] auto function_profile_zone(const void* address) -> const profile_zone&;
+
+    /*
+    writes the zones recorded so far by every thread (the latest ones, each thread keeps a ring) as chrome trace event json
+    open it with chrome://tracing or https://ui.perfetto.dev
+    e.g. fae::write_chrome_trace("frame.json");
+    */
+    [[nodiscard]] auto write_chrome_trace(const std::filesystem::path& path) -> bool;
+
+    /* forgets the zones recorded so far */
+    auto clear_profile() noexcept -> void;
+}
+
+#define FAE_PROFILE_CONCAT_IMPL(lhs, rhs) lhs##rhs
+#define FAE_PROFILE_CONCAT(lhs, rhs) FAE_PROFILE_CONCAT_IMPL(lhs, rhs)
+
+#ifdef FAE_PROFILE
+/* records the rest of the enclosing scope as a zone, e.g. FAE_PROFILE_SCOPE("upload meshes"); */
+#define FAE_PROFILE_SCOPE(zone_name)                                                                                                                                 \
+    static constexpr auto FAE_PROFILE_CONCAT(fae_profile_zone_, __LINE__) = ::fae::profile_zone{ .name = zone_name, .file = __FILE__, .line = __LINE__ }; \
+    const auto FAE_PROFILE_CONCAT(fae_profile_scope_, __LINE__) = ::fae::profile_scope(FAE_PROFILE_CONCAT(fae_profile_zone_, __LINE__))
+/* FAE_PROFILE_SCOPE named after the enclosing function */
+#define FAE_PROFILE_FUNCTION() FAE_PROFILE_SCOPE(__func__)
+#else
+#define FAE_PROFILE_SCOPE(zone_name) static_cast<void>(0)
+#define FAE_PROFILE_FUNCTION() static_cast<void>(0)
+#endif
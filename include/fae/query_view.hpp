@@ -0,0 +1,187 @@
+#pragma once
+
+#include <iterator>
+#include <tuple>
+#include <utility>
+
+#include <entt/entt.hpp>
+
+#include "fae/entity.hpp"
+
+namespace fae
+{
+    /*
+    lazy range over the matches of an entt view or group, nothing is copied or allocated
+    yields std::tuple<entity_commands, t_components&...> by value, so bind with `auto [entity, a, b]` (not `auto&`)
+    empty (tag) components filter the matches but are not yielded, same as entt's each()
+    */
+    template <typename t_iterator, typename t_sentinel = t_iterator>
+    struct query_view
+    {
+        struct iterator
+        {
+            t_iterator current;
+            entity_registry_t* registry;
+
+            [[nodiscard]] auto operator*() const
+            {
+                return std::apply([this](entity id, auto&&... components)
+                    { return std::tuple<entity_commands, decltype(components)...>(
+                          entity_commands{ .id = id, .registry = *registry },
+                          std::forward<decltype(components)>(components)...); },
+                    *current);
+            }
+
+            auto operator++() -> iterator&
+            {
+                ++current;
+                return *this;
+            }
+
+            [[nodiscard]] auto operator==(const t_sentinel& sentinel) const -> bool
+            {
+                return current == sentinel;
+            }
+        };
+
+        t_iterator first;
+        t_sentinel last;
+        entity_registry_t* registry;
+
+        [[nodiscard]] auto begin() const -> iterator
+        {
+            return iterator{ .current = first, .registry = registry };
+        }
+
+        [[nodiscard]] auto end() const -> t_sentinel
+        {
+            return last;
+        }
+
+        [[nodiscard]] auto empty() const -> bool
+        {
+            return first == last;
+        }
+    };
+
+    /* wraps the iterable returned by an entt view's or group's each() */
+    template <typename t_iterable>
+    [[nodiscard]] auto make_query_view(t_iterable&& iterable, entity_registry_t& registry)
+    {
+        using iterator_t = decltype(iterable.begin());
+        using sentinel_t = decltype(iterable.end());
+        return query_view<iterator_t, sentinel_t>{
+            .first = iterable.begin(),
+            .last = iterable.end(),
+            .registry = &registry,
+        };
+    }
+
+    /* query_view without the matches predicate(entity) rejects, e.g. the entities a change filter (changed<t>, added<t>) leaves out */
+    template <typename t_iterator, typename t_sentinel, typename t_predicate>
+    struct filtered_query_view
+    {
+        struct iterator
+        {
+            typename query_view<t_iterator, t_sentinel>::iterator inner;
+            t_sentinel last;
+            t_predicate predicate;
+
+            [[nodiscard]] auto operator*() const
+            {
+                return *inner;
+            }
+
+            auto operator++() -> iterator&
+            {
+                ++inner;
+                skip_rejected();
+                return *this;
+            }
+
+            [[nodiscard]] auto operator==(const t_sentinel& sentinel) const -> bool
+            {
+                return inner == sentinel;
+            }
+
+            auto skip_rejected() -> void
+            {
+                while (!(inner == last) && !predicate(std::get<0>(*inner.current)))
+                {
+                    ++inner;
+                }
+            }
+        };
+
+        query_view<t_iterator, t_sentinel> matches;
+        t_predicate predicate;
+
+        [[nodiscard]] auto begin() const -> iterator
+        {
+            auto first = iterator{ .inner = matches.begin(), .last = matches.end(), .predicate = predicate };
+            first.skip_rejected();
+            return first;
+        }
+
+        [[nodiscard]] auto end() const -> t_sentinel
+        {
+            return matches.end();
+        }
+
+        [[nodiscard]] auto empty() const -> bool
+        {
+            return begin() == end();
+        }
+    };
+
+    template <typename t_iterable, typename t_predicate>
+    [[nodiscard]] auto make_filtered_query_view(t_iterable&& iterable, entity_registry_t& registry, t_predicate predicate)
+    {
+        auto matches = make_query_view(std::forward<t_iterable>(iterable), registry);
+        return filtered_query_view<decltype(matches.first), decltype(matches.last), t_predicate>{
+            .matches = matches,
+            .predicate = predicate,
+        };
+    }
+
+    /* lazy range of entity_commands over a range of entity ids */
+    template <typename t_iterator>
+    struct entity_view
+    {
+        struct iterator
+        {
+            t_iterator current;
+            entity_registry_t* registry;
+
+            [[nodiscard]] auto operator*() const -> entity_commands
+            {
+                return entity_commands{ .id = *current, .registry = *registry };
+            }
+
+            auto operator++() -> iterator&
+            {
+                ++current;
+                return *this;
+            }
+
+            [[nodiscard]] auto operator==(const iterator& other) const -> bool
+            {
+                return current == other.current;
+            }
+        };
+
+        t_iterator first;
+        t_iterator last;
+        entity_registry_t* registry;
+
+        [[nodiscard]] auto begin() const -> iterator
+        {
+            return iterator{ .current = first, .registry = registry };
+        }
+
+        [[nodiscard]] auto end() const -> iterator
+        {
+            return iterator{ .current = last, .registry = registry };
+        }
+    };
+}
@@ -1,12 +1,19 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <vector>
 #include <filesystem>
 
+#include "fae/core/unique_id.hpp"
 #include "fae/math.hpp"
 
 namespace fae
 {
+    struct virtual_file_system;
+
     struct vertex
     {
         vec3 position;
@@ -15,22 +22,158 @@ namespace fae
         vec2 uv;
     };
 
+    struct bounding_sphere
+    {
+        vec3 center = { 0.f, 0.f, 0.f };
+        float radius = 0.f;
+    };
+
+    /*
+    a level of detail of a mesh, as a range into the mesh's index buffer
+    all levels share the same vertices, level 0 is the full detail mesh
+    */
+    struct mesh_lod
+    {
+        std::uint32_t first_index = 0;
+        std::uint32_t index_count = 0;
+        /* simplification error of this level relative to the mesh bounds radius */
+        float error = 0.f;
+    };
+
     struct mesh
     {
         std::vector<vertex> vertices;
         std::vector<std::uint32_t> indices;
+        std::vector<mesh_lod> lods;
+        bounding_sphere bounds;
+        /* what the gpu geometry is cached by, kept when the mesh (e.g. its model component) is moved */
+        unique_id id{};
 
         static auto load(std::filesystem::path path) -> std::optional<mesh>;
+        static auto load(const std::filesystem::path& path, const virtual_file_system& vfs) -> std::optional<mesh>;
 
         constexpr auto has_indices() const noexcept -> bool
         {
             return !indices.empty();
         }
+
+        [[nodiscard]] constexpr auto lod_count() const noexcept -> std::size_t
+        {
+            return lods.empty() ? 1 : lods.size();
+        }
+
+        /* indices of the given level of detail (clamped to the coarsest level) */
+        [[nodiscard]] constexpr auto lod_indices(std::size_t lod = 0) const noexcept -> std::span<const std::uint32_t>
+        {
+            if (lods.empty())
+            {
+                return indices;
+            }
+            const auto& level = lods[std::min(lod, lods.size() - 1)];
+            return std::span<const std::uint32_t>(indices).subspan(level.first_index, level.index_count);
+        }
+
+        auto compute_bounds() noexcept -> void;
+    };
+
+    struct lod_generation_settings
+    {
+        /* total number of levels to generate, including the full detail level */
+        std::size_t max_lods = 4;
+        /* fraction of triangles each level keeps from the previous one */
+        float reduction = 0.5f;
+        /* largest simplification error allowed, relative to the mesh bounds radius */
+        float max_error = 0.05f;
+        std::size_t min_triangles = 8;
+    };
+
+    /* builds a chain of simplified levels of detail (quadric error metrics edge collapse) into mesh.lods */
+    auto generate_lods(mesh& mesh, const lod_generation_settings& settings = {}) -> void;
+
+    /* exact vertex & index counts of a procedural primitive, known before generating it */
+    struct primitive_size
+    {
+        std::size_t vertex_count = 0;
+        std::size_t index_count = 0;
     };
 
+    /*
+    procedural primitives, generated without any file i/o
+    the write_* functions fill spans of exactly *_size() elements (e.g. to stream into other buffers)
+    primitives are centered on the origin, y up, with outward facing counter clockwise triangles
+    counts below the minimums a primitive needs are clamped up to them, by both *_size() & write_*()
+    */
     namespace meshes
     {
+        constexpr std::uint32_t min_plane_subdivisions = 1;
+        constexpr std::uint32_t min_segments = 3;
+        constexpr std::uint32_t min_uv_sphere_rings = 2;
+        constexpr std::uint32_t min_capsule_rings = 1;
+
+        [[nodiscard]] constexpr auto cube_size() noexcept -> primitive_size
+        {
+            return { .vertex_count = 24, .index_count = 36 };
+        }
+
+        [[nodiscard]] constexpr auto plane_size(std::uint32_t subdivisions = 1) noexcept -> primitive_size
+        {
+            subdivisions = std::max(subdivisions, min_plane_subdivisions);
+            return {
+                .vertex_count = static_cast<std::size_t>(subdivisions + 1) * (subdivisions + 1),
+                .index_count = static_cast<std::size_t>(subdivisions) * subdivisions * 6,
+            };
+        }
+
+        [[nodiscard]] constexpr auto uv_sphere_size(std::uint32_t segments = 32, std::uint32_t rings = 16) noexcept -> primitive_size
+        {
+            segments = std::max(segments, min_segments);
+            rings = std::max(rings, min_uv_sphere_rings);
+            return {
+                .vertex_count = static_cast<std::size_t>(rings + 1) * (segments + 1),
+                .index_count = static_cast<std::size_t>(segments) * (rings - 1) * 6,
+            };
+        }
+
+        [[nodiscard]] constexpr auto icosphere_size(std::uint32_t subdivisions = 2) noexcept -> primitive_size
+        {
+            const auto faces = std::size_t{ 20 } << (2 * subdivisions);
+            return { .vertex_count = faces / 2 + 2, .index_count = faces * 3 };
+        }
+
+        [[nodiscard]] constexpr auto cylinder_size(std::uint32_t segments = 32) noexcept -> primitive_size
+        {
+            segments = std::max(segments, min_segments);
+            return {
+                .vertex_count = static_cast<std::size_t>(segments) * 4 + 4,
+                .index_count = static_cast<std::size_t>(segments) * 12,
+            };
+        }
+
+        [[nodiscard]] constexpr auto capsule_size(std::uint32_t segments = 32, std::uint32_t rings = 8) noexcept -> primitive_size
+        {
+            segments = std::max(segments, min_segments);
+            rings = std::max(rings, min_capsule_rings);
+            return {
+                .vertex_count = static_cast<std::size_t>(rings * 2 + 2) * (segments + 1),
+                .index_count = static_cast<std::size_t>(segments) * rings * 12,
+            };
+        }
+
+        auto write_cube(std::span<vertex> vertices, std::span<std::uint32_t> indices, float size = 1.f) noexcept -> void;
+        /* on the xz plane, facing up */
+        auto write_plane(std::span<vertex> vertices, std::span<std::uint32_t> indices, float size = 1.f, std::uint32_t subdivisions = 1) noexcept -> void;
+        auto write_uv_sphere(std::span<vertex> vertices, std::span<std::uint32_t> indices, float radius = 0.5f, std::uint32_t segments = 32, std::uint32_t rings = 16) noexcept -> void;
+        auto write_icosphere(std::span<vertex> vertices, std::span<std::uint32_t> indices, float radius = 0.5f, std::uint32_t subdivisions = 2) -> void;
+        auto write_cylinder(std::span<vertex> vertices, std::span<std::uint32_t> indices, float radius = 0.5f, float height = 1.f, std::uint32_t segments = 32) noexcept -> void;
+        /* height includes both hemispheres, rings are per hemisphere */
+        auto write_capsule(std::span<vertex> vertices, std::span<std::uint32_t> indices, float radius = 0.5f, float height = 2.f, std::uint32_t segments = 32, std::uint32_t rings = 8) noexcept -> void;
+
         auto cube(float size = 1.f) -> mesh;
+        auto plane(float size = 1.f, std::uint32_t subdivisions = 1) -> mesh;
+        auto uv_sphere(float radius = 0.5f, std::uint32_t segments = 32, std::uint32_t rings = 16) -> mesh;
+        auto icosphere(float radius = 0.5f, std::uint32_t subdivisions = 2) -> mesh;
+        auto cylinder(float radius = 0.5f, float height = 1.f, std::uint32_t segments = 32) -> mesh;
+        auto capsule(float radius = 0.5f, float height = 2.f, std::uint32_t segments = 32, std::uint32_t rings = 8) -> mesh;
     }
     using namespace meshes;
 }
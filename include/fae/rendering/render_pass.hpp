@@ -21,7 +21,9 @@ namespace fae
         struct render_model_args
         {
             const model& model;
-            const transform& transform;
+            /* world space, from the model's global_transform */
+            const mat4& world_matrix;
+            std::size_t lod = 0;
         };
         std::function<void(const render_model_args& args)> render_model;
     };
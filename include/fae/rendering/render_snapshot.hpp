@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "fae/entity.hpp"
+#include "fae/lighting.hpp"
+#include "fae/math.hpp"
+
+namespace fae
+{
+    struct model;
+
+    /*
+    what rendering needs from one simulated frame, copied out of the ecs by extract_render_snapshot at the end of post update
+    models are drawn from it & the gpu work of the frame only reads it (not live components), so it can run on the render thread
+    */
+    struct render_snapshot
+    {
+        struct draw
+        {
+            /* the model component, only read while recording the frame (right after extraction, before anything is spawned or destroyed) */
+            const model* model = nullptr;
+            mat4 world_matrix{ 1.f };
+            std::size_t lod = 0;
+        };
+        std::vector<draw> draws{};
+
+        bool has_camera = false;
+        vec3 camera_position{ 0.f, 0.f, 0.f };
+        mat4 view{ 1.f };
+        mat4 projection{ 1.f };
+
+        ambient_light_info ambient_lights{};
+        directional_light_info directional_lights{};
+        /* scaled time since start, in seconds */
+        float elapsed = 0.f;
+
+        auto clear() noexcept -> void
+        {
+            draws.clear();
+            has_camera = false;
+        }
+    };
+
+    /*
+    two snapshots, a resource: extraction fills the back one while the render thread may still be submitting the front one
+    update_rendering publishes the back snapshot once the render thread is done with the front one
+    */
+    struct render_snapshots
+    {
+        [[nodiscard]] auto front() noexcept -> render_snapshot&
+        {
+            return m_snapshots[m_front];
+        }
+
+        [[nodiscard]] auto back() noexcept -> render_snapshot&
+        {
+            return m_snapshots[1 - m_front];
+        }
+
+        /* the back snapshot becomes the front one */
+        auto publish() noexcept -> void
+        {
+            m_front = 1 - m_front;
+        }
+
+      private:
+        std::array<render_snapshot, 2> m_snapshots{};
+        std::size_t m_front = 0;
+    };
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <memory_resource>
+
+namespace fae
+{
+    /*
+    runs the gpu submission of a frame (uniform uploads, encoding, submit & present) on its own thread, a resource
+    so the main thread starts simulating the next frame while the last one is submitted, at most one frame is in flight
+    wait() before touching the gpu device from the main thread (recording a frame, resizing the surface, ...)
+    without a thread (not pipelined, or on the web) frames are submitted right away on the calling thread
+    */
+    struct render_thread
+    {
+        explicit render_thread(bool pipelined = true);
+        render_thread(render_thread&&) noexcept;
+        auto operator=(render_thread&&) noexcept -> render_thread&;
+        ~render_thread();
+
+        /*
+        waits for the frame in flight, then hands submit_frame to the thread
+        it gets the thread's arena for its temporaries, reset before every frame
+        */
+        auto submit(std::function<void(std::pmr::memory_resource&)> submit_frame) -> void;
+        /* returns once the frame in flight (if any) was submitted */
+        auto wait() -> void;
+
+        [[nodiscard]] auto is_pipelined() const noexcept -> bool;
+
+      private:
+        struct state;
+        auto stop() noexcept -> void;
+
+        std::unique_ptr<state> m_state;
+    };
+}
@@ -1,17 +1,24 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
+#include <vector>
 
 #include "material.hpp"
 #include "mesh.hpp"
 #include "model.hpp"
 #include "render_pass.hpp"
 #include "render_pipeline.hpp"
+#include "render_snapshot.hpp"
+#include "render_thread.hpp"
 #include "renderer.hpp"
 #include "texture.hpp"
 #include "webgpu_renderer.hpp"
 
+#include "fae/entity.hpp"
+
 namespace fae
 {
     struct application;
@@ -19,7 +26,8 @@ namespace fae
     struct asset_manager;
     struct scheduler;
     struct ecs_world;
-    struct update_step;
+    struct post_update_step;
+    struct stop_step;
     struct window_resized;
 
     struct render_step
@@ -41,12 +49,99 @@ namespace fae
         bool visible = true;
     };
 
+    /*
+    screen space level of detail selection for models with generated lods
+    thresholds are projected bounds diameters in pixels, one per coarser level
+    */
+    struct lod_settings
+    {
+        std::vector<float> screen_size_thresholds = { 256.f, 128.f, 64.f, 32.f };
+        /* fraction by which a threshold has to be crossed before switching levels (avoids popping) */
+        float hysteresis = 0.1f;
+    };
+
+    /* level of detail currently selected for a model, added by select_lods */
+    struct lod_state
+    {
+        std::size_t level = 0;
+    };
+
+    /* marks a model that never moves after being spawned, so it can be merged into a static batch */
+    struct static_geometry
+    {
+    };
+
+    /* added to static models once they are merged, the batch entity draws them from then on */
+    struct static_batched
+    {
+        entity batch;
+    };
+
+    /* a merged mesh of static models sharing a material & spatial cell */
+    struct static_batch
+    {
+        std::size_t source_count = 0;
+    };
+
+    /*
+    batches to dissolve, a resource filled from the registry's signals when a batched model, its transform or its visibility is replaced or destroyed
+    (& by build_static_batches when a source's global_transform moved with its parents)
+    build_static_batches destroys them & batches their remaining sources again (components changed in place are not noticed, set them instead)
+    */
+    struct stale_static_batches
+    {
+        std::vector<entity> batches{};
+
+        auto mark_source(entity_registry_t& registry, entity id) -> void;
+        /* only hiding a source changes its batch */
+        auto mark_hidden_source(entity_registry_t& registry, entity id) -> void;
+        auto mark_unbatched_source(entity_registry_t& registry, entity id) -> void;
+        auto mark_batch(entity_registry_t& registry, entity id) -> void;
+    };
+
+    /*
+    bookkeeping of extract_render_snapshot, a resource
+    models are owned by an entt group with their visibility (packed together, visibility is added to models that lack it)
+    & kept in the order of their global_transforms, so extraction walks the model, visibility & global_transform pools front to back
+    */
+    struct render_order
+    {
+        /* transform_hierarchy::order the models were last sorted by */
+        std::uint64_t hierarchy_order = 0;
+        /* set from the registry's signals when an entity joins or leaves the model group, the next extraction sorts again */
+        bool needs_sort = true;
+
+        auto mark_unsorted([[maybe_unused]] entity_registry_t& registry, [[maybe_unused]] entity id) noexcept -> void
+        {
+            needs_sort = true;
+        }
+    };
+
+    struct static_batching_settings
+    {
+        /* size of the world space grid cells batches are split by, so they can still be culled */
+        float cell_size = 64.f;
+    };
+
     struct rendering_plugin
     {
+        /* submit frames on a render thread while the next one is simulated, instead of at the end of each frame */
+        bool pipelined = true;
+        /* how often lod levels are selected again (every frame if not positive), models keep their level in between */
+        float lod_hz = 10.f;
+
         auto init(application& app) const noexcept -> void;
     };
 
-    auto update_rendering(const update_step& step) noexcept -> void;
+    /* after propagate_transforms, sources are batched with their world matrices */
+    auto build_static_batches(const post_update_step& step) noexcept -> void;
+    /* picks the lod_state of visible models with lods, at rendering_plugin::lod_hz */
+    auto select_lods(const post_update_step& step) noexcept -> void;
+    /* copies what the frame draws into the back render snapshot, after transforms are propagated */
+    auto extract_render_snapshot(const post_update_step& step) noexcept -> void;
+    auto update_rendering(const post_update_step& step) noexcept -> void;
+    /* waits for the last frame to be submitted, before the window & device go away */
+    auto finish_rendering(const stop_step& step) noexcept -> void;
     auto render_models(const render_step& step) noexcept -> void;
     auto resize_active_render_passes(const window_resized& e) noexcept -> void;
 }
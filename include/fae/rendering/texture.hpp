@@ -1,19 +1,26 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <vector>
 #include <filesystem>
 
 #include "fae/color.hpp"
+#include "fae/core/unique_id.hpp"
 
 namespace fae
 {
+    struct virtual_file_system;
+
     struct texture
     {
         std::size_t width;
         std::size_t height;
         std::vector<color> data;
+        /* what the gpu texture is cached by, kept when the texture (e.g. its model component) is moved */
+        unique_id id{};
 
         static auto load(std::filesystem::path path) -> std::optional<texture>;
+        static auto load(const std::filesystem::path& path, const virtual_file_system& vfs) -> std::optional<texture>;
     };
 }
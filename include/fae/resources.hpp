@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "fae/core/dense_type_index.hpp"
+#include "fae/core/erased_ptr.hpp"
+
+namespace fae
+{
+    /*
+    global state, at most one value per type (time, webgpu, renderer, active_camera, ...)
+    every type gets a dense slot the first time it is used, so get<t>() is a bounds check & one indexed load
+    values never move once set (replacing one reconstructs it in place), so pointers to them stay valid until removed
+    every value has a version, bumped when it is set or marked changed, for run conditions like run_condition::when_resource_changed
+    set & remove while no system runs (plugin init, sync points), get can be called from any thread
+    */
+    struct resources
+    {
+        template <typename t>
+        [[nodiscard]] inline auto get() noexcept -> t*
+        {
+            const auto index = slot_index<t>();
+            return index < m_slots.size() ? static_cast<t*>(m_slots[index]) : nullptr;
+        }
+
+        template <typename t>
+        [[nodiscard]] inline auto get() const noexcept -> const t*
+        {
+            const auto index = slot_index<t>();
+            return index < m_slots.size() ? static_cast<const t*>(m_slots[index]) : nullptr;
+        }
+
+        /* 0 if the resource was never set */
+        template <typename t>
+        [[nodiscard]] inline auto version() const noexcept -> std::uint64_t
+        {
+            const auto index = slot_index<t>();
+            return index < m_versions.size() ? m_versions[index] : 0;
+        }
+
+        /* after modifying the resource through a pointer or reference */
+        template <typename t>
+        [[maybe_unused]] inline auto mark_changed() noexcept -> void
+        {
+            const auto index = slot_index<t>();
+            if (index < m_versions.size() && m_slots[index])
+            {
+                ++m_versions[index];
+            }
+        }
+
+        template <typename t>
+        [[nodiscard]] inline auto contains() const noexcept -> bool
+        {
+            return get<t>() != nullptr;
+        }
+
+        template <typename t>
+        [[maybe_unused]] inline auto set(t&& value) -> std::remove_cvref_t<t>&
+        {
+            using t_value = std::remove_cvref_t<t>;
+            const auto index = slot_index<t_value>();
+            if (index >= m_slots.size())
+            {
+                m_slots.resize(index + 1, nullptr);
+                m_versions.resize(index + 1, 0);
+                while (m_owners.size() <= index)
+                {
+                    m_owners.emplace_back(nullptr, nullptr);
+                }
+            }
+            ++m_versions[index];
+            if (auto* existing = static_cast<t_value*>(m_slots[index]))
+            {
+                // replaced in place, things may hold on to the resource's address
+                if constexpr (std::is_assignable_v<t_value&, t&&>)
+                {
+                    *existing = std::forward<t>(value);
+                }
+                else
+                {
+                    // built before the old value is destroyed, value may refer to it (e.g. set(*get<t>()))
+                    auto replacement = t_value(std::forward<t>(value));
+                    existing->~t_value();
+                    new (existing) t_value(std::move(replacement));
+                }
+                return *existing;
+            }
+            m_owners[index] = make_erased<t_value>(std::forward<t>(value));
+            m_slots[index] = m_owners[index].get();
+            return *static_cast<t_value*>(m_slots[index]);
+        }
+
+        template <typename t>
+        [[nodiscard]] inline auto get_or_set(t&& value) -> std::remove_cvref_t<t>&
+        {
+            if (auto* existing = get<std::remove_cvref_t<t>>())
+            {
+                return *existing;
+            }
+            return set(std::forward<t>(value));
+        }
+
+        template <typename t>
+        [[maybe_unused]] inline auto remove() -> void
+        {
+            const auto index = slot_index<t>();
+            if (index >= m_slots.size())
+            {
+                return;
+            }
+            if (m_slots[index])
+            {
+                ++m_versions[index];
+            }
+            m_slots[index] = nullptr;
+            m_owners[index].reset();
+        }
+
+        inline auto clear() -> void
+        {
+            m_slots.clear();
+            m_versions.clear();
+            m_owners.clear();
+        }
+
+      private:
+        /* m_slots[i] is m_owners[i].get(), kept apart so lookups only touch a flat array of pointers */
+        std::vector<void*> m_slots{};
+        std::vector<std::uint64_t> m_versions{};
+        std::vector<erased_ptr> m_owners{};
+
+        template <typename t>
+        [[nodiscard]] static auto slot_index() noexcept -> std::size_t
+        {
+            return dense_type_index<resources, std::remove_const_t<t>>();
+        }
+    };
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "fae/core/erased_ptr.hpp"
+#include "fae/ecs_world.hpp"
+
+namespace fae
+{
+    /*
+    when a system runs, checked by the scheduler before each run: the system is skipped unless every check passes
+    e.g. run_condition{}.every(std::chrono::milliseconds(100)).staggered()
+         run_condition{}.when_resource_changed<active_camera>()
+         run_condition{}.when_changed<directional_light>()
+         run_condition{}.when([](ecs_world& world) { return world.resources.contains<editor>(); })
+    a skipped run does not count as a run, so changed<t> & added<t> filters still cover everything since the system last actually ran
+    */
+    struct run_condition
+    {
+        using clock = std::chrono::steady_clock;
+
+        run_condition() = default;
+        run_condition(run_condition&&) noexcept = default;
+        auto operator=(run_condition&&) noexcept -> run_condition& = default;
+
+        /* copyable so a condition built as a temporary can be passed by value, each copy gets its own copy of every check's state */
+        run_condition(const run_condition& other) : m_rate(other.m_rate)
+        {
+            m_checks.reserve(other.m_checks.size());
+            for (const auto& other_check : other.m_checks)
+            {
+                m_checks.push_back(check{
+                    .test = other_check.test,
+                    .commit = other_check.commit,
+                    .copy = other_check.copy,
+                    .state = other_check.copy(other_check.state.get()),
+                });
+            }
+        }
+
+        auto operator=(const run_condition& other) -> run_condition&
+        {
+            if (this != &other)
+            {
+                *this = run_condition(other);
+            }
+            return *this;
+        }
+
+        /* runs only if predicate(ecs_world&) is true */
+        template <typename t_predicate>
+            requires std::predicate<t_predicate&, ecs_world&>
+        [[maybe_unused]] auto when(t_predicate&& predicate) -> run_condition&
+        {
+            using t_state = std::remove_cvref_t<t_predicate>;
+            m_checks.push_back(check{
+                .test = [](void* state, ecs_world& world) -> bool
+                { return (*static_cast<t_state*>(state))(world); },
+                .commit = nullptr,
+                .copy = &copy_state<t_state>,
+                .state = make_erased<t_state>(std::forward<t_predicate>(predicate)),
+            });
+            return *this;
+        }
+
+        /* runs only if the resource was set or marked changed since the system last ran (the first run needs the resource to exist) */
+        template <typename t_resource>
+        [[maybe_unused]] auto when_resource_changed() -> run_condition&
+        {
+            m_checks.push_back(check{
+                .test = [](void* state, ecs_world& world) -> bool
+                { return world.resources.version<t_resource>() != *static_cast<std::uint64_t*>(state); },
+                .commit = [](void* state, ecs_world& world)
+                { *static_cast<std::uint64_t*>(state) = world.resources.version<t_resource>(); },
+                .copy = &copy_state<std::uint64_t>,
+                .state = make_erased<std::uint64_t>(0),
+            });
+            return *this;
+        }
+
+        /* runs only if a t_component was added, changed or removed since the system last ran (they must be tracked, see ecs_world::track_changes) */
+        template <typename... t_components>
+        [[maybe_unused]] auto when_changed() -> run_condition&
+        {
+            using t_state = std::array<std::uint64_t, sizeof...(t_components)>;
+            m_checks.push_back(check{
+                .test = [](void* state, ecs_world& world) -> bool
+                { return t_state{ world.changes.last_change<t_components>()... } != *static_cast<t_state*>(state); },
+                .commit = [](void* state, ecs_world& world)
+                { *static_cast<t_state*>(state) = t_state{ world.changes.last_change<t_components>()... }; },
+                .copy = &copy_state<t_state>,
+                .state = make_erased<t_state>(t_state{}),
+            });
+            return *this;
+        }
+
+        /* at most once per period & once per invoke, periods missed while the frame was too long are skipped rather than caught up */
+        [[maybe_unused]] auto every(clock::duration period) -> run_condition&
+        {
+            m_rate = rate{ .period = period, .phase = m_rate ? m_rate->phase : 0.0 };
+            return *this;
+        }
+
+        [[maybe_unused]] auto at_hz(double hz) -> run_condition&
+        {
+            return every(std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / hz)));
+        }
+
+        /*
+        offsets the first run of every() by a fraction of the period that differs per staggered system
+        (golden ratio sequence), so systems throttled to the same rate do not all run on the same frame
+        */
+        [[maybe_unused]] auto staggered() -> run_condition&
+        {
+            static auto staggered_count = std::atomic<std::uint64_t>{ 0 };
+            constexpr auto golden_ratio_conjugate = 0.6180339887498949;
+            const auto n = static_cast<double>(staggered_count.fetch_add(1, std::memory_order_relaxed) + 1);
+            const auto phase = n * golden_ratio_conjugate - static_cast<double>(static_cast<std::uint64_t>(n * golden_ratio_conjugate));
+            if (!m_rate)
+            {
+                m_rate = rate{};
+            }
+            m_rate->phase = phase;
+            return *this;
+        }
+
+        [[nodiscard]] auto is_always() const noexcept -> bool
+        {
+            return !m_rate && m_checks.empty();
+        }
+
+        /* called by the scheduler, true if the system should run now (& then records that it ran) */
+        [[nodiscard]] auto should_run(ecs_world& world) -> bool
+        {
+            if (is_always())
+            {
+                return true;
+            }
+            const auto now = m_rate ? clock::now() : clock::time_point{};
+            if (m_rate && !m_rate->is_due(now))
+            {
+                return false;
+            }
+            for (const auto& check : m_checks)
+            {
+                if (!check.test(check.state.get(), world))
+                {
+                    return false;
+                }
+            }
+            if (m_rate)
+            {
+                m_rate->advance(now);
+            }
+            for (const auto& check : m_checks)
+            {
+                if (check.commit)
+                {
+                    check.commit(check.state.get(), world);
+                }
+            }
+            return true;
+        }
+
+      private:
+        struct check
+        {
+            bool (*test)(void* state, ecs_world& world);
+            /* after every check passed, so a check's state only moves on when the system actually runs */
+            void (*commit)(void* state, ecs_world& world);
+            erased_ptr (*copy)(const void* state);
+            erased_ptr state;
+        };
+
+        template <typename t_state>
+        [[nodiscard]] static auto copy_state(const void* state) -> erased_ptr
+        {
+            return make_erased<t_state>(*static_cast<const t_state*>(state));
+        }
+
+        struct rate
+        {
+            clock::duration period{};
+            /* fraction of period the first run is delayed by */
+            double phase = 0.0;
+            std::optional<clock::time_point> next{};
+
+            [[nodiscard]] auto is_due(clock::time_point now) -> bool
+            {
+                if (!next)
+                {
+                    next = now + std::chrono::duration_cast<clock::duration>(period * phase);
+                }
+                return now >= *next;
+            }
+
+            auto advance(clock::time_point now) -> void
+            {
+                if (period <= clock::duration::zero())
+                {
+                    return;
+                }
+                const auto periods_due = (now - *next) / period + 1;
+                *next += period * periods_due;
+            }
+        };
+
+        std::optional<rate> m_rate{};
+        std::vector<check> m_checks{};
+    };
+}
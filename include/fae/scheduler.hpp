@@ -1,51 +1,233 @@
 #pragma once
 
-#include <any>
-#include <typeindex>
-#include <unordered_map>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include <entt/core/type_info.hpp>
+
+#include "fae/allocation_tracker.hpp"
+#include "fae/core/dense_type_index.hpp"
+#include "fae/core/erased_ptr.hpp"
+#include "fae/ecs_world.hpp"
 #include "fae/event.hpp"
+#include "fae/flight_recorder.hpp"
+#include "fae/job_system.hpp"
+#include "fae/profiler.hpp"
+#include "fae/run_condition.hpp"
+#include "fae/system_access.hpp"
 
 namespace fae
 {
-    struct scheduler
+    struct scheduler;
+
+    /* dense index per step (event argument) type, into the scheduler's flat table of system sets */
+    template <typename t_arg>
+    [[nodiscard]] inline auto step_index() noexcept -> std::size_t
     {
-        template <typename t_arg>
-        [[maybe_unused]] inline auto add_system(const typename event<t_arg>::t_listener& system) noexcept -> scheduler&
+        return dense_type_index<scheduler, t_arg>();
+    }
+
+    /* zone of a system while nothing needs its name (see system_set::entry::get_zone) */
+    inline constexpr auto unnamed_system_zone = profile_zone{ .name = "system" };
+
+    /*
+    non allocating callable reference: a function pointer & the object it is called on
+    plain functions (& captureless lambdas) are called directly, other callables are owned by their system_set
+    */
+    template <typename t_arg>
+    struct system_delegate
+    {
+        using t_fptr = void (*)(const t_arg&);
+
+        void (*thunk)(const system_delegate&, const t_arg&) = nullptr;
+        t_fptr function = nullptr;
+        void* object = nullptr;
+
+        inline auto operator()(const t_arg& arg) const -> void
+        {
+            thunk(*this, arg);
+        }
+    };
+
+    /*
+    systems of a step (or any event) run in batches, built from their declared access:
+    a system runs after every earlier added system it conflicts with & alongside the ones it does not
+    so conflicting systems keep the order they were added in, & systems without declared access run alone, in order
+    */
+    template <typename t_arg>
+    struct system_set
+    {
+        using t_system = system_delegate<t_arg>;
+        using t_fptr = typename t_system::t_fptr;
+
+        struct entry
+        {
+            t_system system;
+            system_access access;
+            /* the callable behind system.object, if it is not a plain function */
+            erased_ptr owner{ nullptr, nullptr };
+            /* world tick of the system's last run, what changed<t> & added<t> compare against */
+            mutable std::uint64_t last_run = 0;
+            mutable run_condition condition{};
+            /* names the system after its function (or the callable's type), one zone per function or type */
+            const profile_zone& (*make_zone)(const t_system& system) = nullptr;
+            mutable const profile_zone* zone = nullptr;
+
+            /* made the first time the profiler, allocation tracking or a flight recorder needs it (looking a function's name up is slow) */
+            [[nodiscard]] auto get_zone() const -> const profile_zone&
+            {
+                if (!zone)
+                {
+                    zone = &make_zone(system);
+                }
+                return *zone;
+            }
+        };
+
+        std::vector<entry> entries{};
+        /* indices into entries, each batch runs after the previous one */
+        std::vector<std::vector<std::size_t>> batches{};
+        mutable bool are_storages_prepared = false;
+
+        template <typename t_callable>
+            requires std::invocable<t_callable&, const t_arg&>
+        auto add(t_callable&& system, system_access&& access, run_condition&& condition = {}) -> void
         {
-            const auto key = std::type_index(typeid(t_arg));
-            if (!m_systems.contains(key))
+            if constexpr (std::is_convertible_v<t_callable&&, t_fptr>)
             {
-                m_systems[key] = event<t_arg>{};
+                entries.push_back(entry{
+                    .system = t_system{
+                        .thunk = [](const t_system& self, const t_arg& arg)
+                        { self.function(arg); },
+                        .function = static_cast<t_fptr>(system),
+                    },
+                    .access = std::move(access),
+                    .condition = std::move(condition),
+                    .make_zone = [](const t_system& self) -> const profile_zone&
+                    { return function_profile_zone(reinterpret_cast<const void*>(self.function)); },
+                });
             }
-            auto& e = std::any_cast<event<t_arg>&>(m_systems[key]);
-            e += system;
+            else
+            {
+                using t_owned = std::remove_cvref_t<t_callable>;
+                auto owner = make_erased<t_owned>(std::forward<t_callable>(system));
+                auto* object = owner.get();
+                entries.push_back(entry{
+                    .system = t_system{
+                        .thunk = [](const t_system& self, const t_arg& arg)
+                        { (*static_cast<t_owned*>(self.object))(arg); },
+                        .object = object,
+                    },
+                    .access = std::move(access),
+                    .owner = std::move(owner),
+                    .condition = std::move(condition),
+                    .make_zone = []([[maybe_unused]] const t_system& self) -> const profile_zone&
+                    {
+                        static const auto& zone = make_profile_zone(std::string(entt::type_name<t_owned>::value()));
+                        return zone;
+                    },
+                });
+            }
+            rebuild();
+        }
+
+        /* removes the systems added as this function */
+        auto remove(t_fptr system) -> void
+        {
+            std::erase_if(entries, [&](const entry& entry)
+                { return entry.system.function == system; });
+            rebuild();
+        }
+
+        auto rebuild() -> void
+        {
+            batches.clear();
+            auto batch_of = std::vector<std::size_t>(entries.size());
+            for (std::size_t i = 0; i < entries.size(); ++i)
+            {
+                std::size_t batch = 0;
+                for (std::size_t j = 0; j < i; ++j)
+                {
+                    if (entries[i].access.conflicts_with(entries[j].access))
+                    {
+                        batch = std::max(batch, batch_of[j] + 1);
+                    }
+                }
+                batch_of[i] = batch;
+                if (batch == batches.size())
+                {
+                    batches.emplace_back();
+                }
+                batches[batch].push_back(i);
+            }
+            are_storages_prepared = false;
+        }
+    };
+
+    struct scheduler
+    {
+        /* without a job system every system runs on the invoking thread */
+        scheduler() noexcept = default;
+        explicit scheduler(job_system& jobs) noexcept : m_jobs(&jobs) {}
+
+        /* systems added without an access declaration are exclusive, i.e. run alone & in the order they were added */
+        template <typename t_arg, typename t_system>
+            requires std::invocable<t_system&, const t_arg&>
+        [[maybe_unused]] inline auto add_system(t_system&& system) noexcept -> scheduler&
+        {
+            return add_system<t_arg>(std::forward<t_system>(system), exclusive_access());
+        }
+
+        template <typename t_arg, typename t_system>
+            requires std::invocable<t_system&, const t_arg&>
+        [[maybe_unused]] inline auto add_system(t_system&& system, system_access access) noexcept -> scheduler&
+        {
+            get_or_create_system_set<t_arg>().add(std::forward<t_system>(system), std::move(access));
+            return *this;
+        }
+
+        /* the system only runs when condition holds (throttled, predicated, on resource changes), see run_condition */
+        template <typename t_arg, typename t_system>
+            requires std::invocable<t_system&, const t_arg&>
+        [[maybe_unused]] inline auto add_system(t_system&& system, run_condition condition) noexcept -> scheduler&
+        {
+            return add_system<t_arg>(std::forward<t_system>(system), exclusive_access(), std::move(condition));
+        }
+
+        template <typename t_arg, typename t_system>
+            requires std::invocable<t_system&, const t_arg&>
+        [[maybe_unused]] inline auto add_system(t_system&& system, system_access access, run_condition condition) noexcept -> scheduler&
+        {
+            static_assert(requires(const t_arg& arg) { arg.ecs_world; }, "run conditions need a step with an ecs_world");
+            get_or_create_system_set<t_arg>().add(std::forward<t_system>(system), std::move(access), std::move(condition));
             return *this;
         }
 
         template <typename t_arg>
-        [[maybe_unused]] inline auto remove_system(const typename event<t_arg>::t_listener& system) noexcept -> scheduler&
+        [[maybe_unused]] inline auto remove_system(typename system_set<t_arg>::t_fptr system) noexcept -> scheduler&
         {
-            const auto key = std::type_index(typeid(t_arg));
-            if (!m_systems.contains(key))
+            if (auto* systems = find_system_set<t_arg>())
             {
-                return *this;
+                systems->remove(system);
             }
-            auto& e = std::any_cast<event<t_arg>&>(m_systems[key]);
-            e -= system;
             return *this;
         }
 
         template <typename t_arg>
         [[maybe_unused]] inline auto clear_systems() noexcept -> scheduler&
         {
-            const auto key = std::type_index(typeid(t_arg));
-            if (!m_systems.contains(key))
+            if (auto* systems = find_system_set<t_arg>())
             {
-                return *this;
+                systems->entries.clear();
+                systems->rebuild();
             }
-            auto& e = std::any_cast<event<t_arg>&>(m_systems[key]);
-            e.clear();
             return *this;
         }
 
@@ -58,26 +240,20 @@ namespace fae
         template <typename t_arg>
         [[maybe_unused]] inline auto invoke(const t_arg& arg = {}) -> scheduler&
         {
-            const auto key = std::type_index(typeid(t_arg));
-            if (!m_systems.contains(key))
+            if (const auto* systems = find_system_set<t_arg>())
             {
-                return *this;
+                run(*systems, arg);
             }
-            auto& e = std::any_cast<event<t_arg>&>(m_systems[key]);
-            e.invoke(std::forward<const t_arg&>(arg));
             return *this;
         }
 
         template <typename t_arg>
         [[maybe_unused]] inline auto invoke(const t_arg& arg = {}) const -> const scheduler&
         {
-            const auto key = std::type_index(typeid(t_arg));
-            if (!m_systems.contains(key))
+            if (const auto* systems = find_system_set<t_arg>())
             {
-                return *this;
+                run(*systems, arg);
             }
-            const auto& e = std::any_cast<event<t_arg>&>(m_systems.at(key));
-            e.invoke(std::forward<const t_arg&>(arg));
             return *this;
         }
 
@@ -93,7 +269,123 @@ namespace fae
             return invoke(std::forward<const t_arg&>(arg));
         }
 
+        [[nodiscard]] inline auto get_job_system() const noexcept -> job_system*
+        {
+            return m_jobs;
+        }
+
+        /* every invoke & system call is timed into recorder while it is set (see flight_recorder_plugin), null to stop */
+        [[maybe_unused]] inline auto set_flight_recorder(flight_recorder* recorder) noexcept -> scheduler&
+        {
+            m_recorder = recorder;
+            return *this;
+        }
+
       private:
-        std::unordered_map<std::type_index, std::any> m_systems{};
+        /* indexed by step_index<t_arg>(), each holds a system_set<t_arg> (or null if nothing was added for t_arg) */
+        std::vector<erased_ptr> m_systems{};
+        job_system* m_jobs = nullptr;
+        flight_recorder* m_recorder = nullptr;
+
+        template <typename t_arg>
+        [[nodiscard]] auto find_system_set() const noexcept -> system_set<t_arg>*
+        {
+            const auto index = step_index<t_arg>();
+            return index < m_systems.size() ? static_cast<system_set<t_arg>*>(m_systems[index].get()) : nullptr;
+        }
+
+        template <typename t_arg>
+        auto get_or_create_system_set() -> system_set<t_arg>&
+        {
+            const auto index = step_index<t_arg>();
+            while (index >= m_systems.size())
+            {
+                m_systems.emplace_back(nullptr, nullptr);
+            }
+            if (!m_systems[index])
+            {
+                m_systems[index] = make_erased<system_set<t_arg>>();
+            }
+            return *static_cast<system_set<t_arg>*>(m_systems[index].get());
+        }
+
+        template <typename t_arg>
+        static auto call_system(const typename system_set<t_arg>::entry& entry, const t_arg& arg, flight_recorder* recorder) -> void
+        {
+            const auto& zone = is_profiling() || is_tracking_allocations() || recorder ? entry.get_zone() : unnamed_system_zone;
+            [[maybe_unused]] const auto profiled = profile_scope(zone);
+            // with FAE_TRACK_ALLOCATIONS a system's allocations are counted under its name instead of its step's
+            [[maybe_unused]] const auto allocations = allocation_scope(zone.name.data());
+            if (!recorder)
+            {
+                entry.system(arg);
+                return;
+            }
+            const auto begin = std::chrono::steady_clock::now();
+            entry.system(arg);
+            recorder->record_system(zone, std::chrono::steady_clock::now() - begin);
+        }
+
+        template <typename t_arg>
+        static auto run_system(const typename system_set<t_arg>::entry& entry, const t_arg& arg, flight_recorder* recorder) -> void
+        {
+            if constexpr (requires { arg.ecs_world.changes; })
+            {
+                if (!entry.condition.should_run(arg.ecs_world))
+                {
+                    return;
+                }
+                auto ticks = system_tick_scope(arg.ecs_world.changes, entry.last_run);
+                call_system(entry, arg, recorder);
+            }
+            else
+            {
+                call_system(entry, arg, recorder);
+            }
+        }
+
+        template <typename t_arg>
+        auto run(const system_set<t_arg>& systems, const t_arg& arg) const -> void
+        {
+            // one zone per invoke, named after the step type
+            static constexpr auto zone = profile_zone{ .name = entt::type_name<t_arg>::value(), .file = __FILE__, .line = __LINE__ };
+            [[maybe_unused]] const auto profiled = profile_scope(zone);
+            const auto begin = m_recorder ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
+            if constexpr (requires { arg.ecs_world.registry; })
+            {
+                if (!systems.are_storages_prepared)
+                {
+                    for (const auto& entry : systems.entries)
+                    {
+                        entry.access.prepare_storages(arg.ecs_world.registry);
+                    }
+                    systems.are_storages_prepared = true;
+                }
+            }
+
+            for (const auto& batch : systems.batches)
+            {
+                if (batch.size() == 1 || !m_jobs)
+                {
+                    for (auto i : batch)
+                    {
+                        run_system(systems.entries[i], arg, m_recorder);
+                    }
+                    continue;
+                }
+                m_jobs->parallel_for(batch.size(), 1, [&](std::size_t begin, std::size_t end)
+                    {
+                        for (auto i = begin; i < end; ++i)
+                        {
+                            run_system(systems.entries[batch[i]], arg, m_recorder);
+                        } });
+            }
+
+            if (m_recorder)
+            {
+                m_recorder->record_step(zone, std::chrono::steady_clock::now() - begin);
+            }
+        }
     };
 }
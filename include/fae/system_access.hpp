@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <typeindex>
+#include <vector>
+
+#include "fae/entity.hpp"
+
+namespace fae
+{
+    /*
+    what a system reads & writes, used by the scheduler to run non conflicting systems of a step at the same time
+    e.g. system_access{}.reads<velocity>().writes<transform>().reads_resource<time>()
+    structural changes count as writes (emplacing or removing a T writes T, creating or destroying entities writes entt::entity)
+    */
+    struct system_access
+    {
+        /* conflicts with every other system, the default for systems that do not declare their access */
+        bool exclusive = false;
+        std::vector<std::type_index> component_reads{};
+        std::vector<std::type_index> component_writes{};
+        std::vector<std::type_index> resource_reads{};
+        std::vector<std::type_index> resource_writes{};
+        /* create the storages of the declared types up front, so systems running in parallel never insert into the registry's pool map */
+        std::vector<void (*)(entity_registry_t&)> storages{};
+
+        template <typename... t_components>
+        [[maybe_unused]] inline auto reads() -> system_access&
+        {
+            (add<t_components>(component_reads), ...);
+            return *this;
+        }
+
+        template <typename... t_components>
+        [[maybe_unused]] inline auto writes() -> system_access&
+        {
+            (add<t_components>(component_writes), ...);
+            return *this;
+        }
+
+        template <typename... t_resources>
+        [[maybe_unused]] inline auto reads_resource() -> system_access&
+        {
+            (add<t_resources>(resource_reads), ...);
+            return *this;
+        }
+
+        template <typename... t_resources>
+        [[maybe_unused]] inline auto writes_resource() -> system_access&
+        {
+            (add<t_resources>(resource_writes), ...);
+            return *this;
+        }
+
+        [[nodiscard]] auto conflicts_with(const system_access& other) const noexcept -> bool
+        {
+            if (exclusive || other.exclusive)
+            {
+                return true;
+            }
+            auto overlaps = [](const std::vector<std::type_index>& lhs, const std::vector<std::type_index>& rhs)
+            {
+                return std::ranges::any_of(lhs, [&](const std::type_index& type)
+                    { return std::ranges::find(rhs, type) != rhs.end(); });
+            };
+            return overlaps(component_writes, other.component_writes) ||
+                   overlaps(component_writes, other.component_reads) ||
+                   overlaps(component_reads, other.component_writes) ||
+                   overlaps(resource_writes, other.resource_writes) ||
+                   overlaps(resource_writes, other.resource_reads) ||
+                   overlaps(resource_reads, other.resource_writes);
+        }
+
+        auto prepare_storages(entity_registry_t& registry) const -> void
+        {
+            for (auto prepare : storages)
+            {
+                prepare(registry);
+            }
+        }
+
+      private:
+        template <typename t>
+        auto add(std::vector<std::type_index>& types) -> void
+        {
+            using type = std::remove_cvref_t<t>;
+            types.emplace_back(typeid(type));
+            if constexpr (!std::is_same_v<type, entity>)
+            {
+                storages.push_back([](entity_registry_t& registry)
+                    { static_cast<void>(registry.storage<type>()); });
+            }
+        }
+    };
+
+    [[nodiscard]] inline auto exclusive_access() -> system_access
+    {
+        return system_access{ .exclusive = true };
+    }
+}
@@ -1,20 +1,47 @@
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <optional>
 
 #include "fae/duration.hpp"
+#include "fae/math.hpp"
 
 namespace fae
 {
     struct application;
-    struct update_step;
+    struct pre_update_step;
+    struct fixed_update_step;
 
     struct time
     {
+        /* frames the frame time percentiles are taken over */
+        static constexpr std::size_t frame_time_window = 240;
+
         duration unscaled_delta{};
         duration unscaled_elapsed{};
         float scale = 1.f;
 
+        /* simulated time per fixed_update_step, the fixed steps run as often as needed to keep up with the scaled frame time */
+        duration fixed_delta = std::chrono::nanoseconds(16'666'667);
+        /* fixed steps run per frame at most, the time a frame is behind beyond that is dropped (keeps a slow frame from making the next one slower) */
+        std::uint32_t max_fixed_steps = 8;
+        /* scaled time not simulated by fixed steps yet, always less than fixed_delta after the fixed steps of a frame */
+        duration fixed_accumulator{};
+        /* how far the frame is between the last fixed step & the next, in [0, 1), fixed_step_interpolation entities are drawn that far between their last two transforms */
+        float fixed_alpha = 0.f;
+        /* fixed steps run this frame */
+        std::uint32_t fixed_steps = 0;
+
+        std::chrono::steady_clock::time_point last_update{};
+
+        /* unscaled deltas of the last frames, a ring written at frame_time_count % frame_time_window */
+        std::array<duration, frame_time_window> frame_times{};
+        std::uint64_t frame_time_count = 0;
+
         [[nodiscard]] inline constexpr auto delta() const noexcept -> duration
         {
             return unscaled_delta * scale;
@@ -34,12 +61,53 @@ namespace fae
             }
             return 1.f / dt;
         }
+
+        /*
+        frame time (unscaled) that percentile (in [0, 1]) of the last frame_time_window frames took at most, 0 before the first measured frame
+        e.g. time.frame_time_percentile(0.99f) is the frame time only 1% of the recent frames exceeded
+        */
+        [[nodiscard]] auto frame_time_percentile(float percentile) const noexcept -> duration;
+
+        [[nodiscard]] inline auto frame_time_p50() const noexcept -> duration
+        {
+            return frame_time_percentile(0.5f);
+        }
+
+        [[nodiscard]] inline auto frame_time_p95() const noexcept -> duration
+        {
+            return frame_time_percentile(0.95f);
+        }
+
+        [[nodiscard]] inline auto frame_time_p99() const noexcept -> duration
+        {
+            return frame_time_percentile(0.99f);
+        }
     };
 
-    auto update_time(const update_step& step) noexcept -> void;
+    /*
+    on an entity moved in fixed_update_step, so it is drawn between its last two fixed step transforms (by time::fixed_alpha)
+    instead of jumping once per fixed step & standing still in the frames between
+    */
+    struct fixed_step_interpolation
+    {
+        /* the transform before the last fixed step, none until a fixed step ran */
+        std::optional<transform> previous{};
+
+        /* the transform to draw, alpha of the way from previous to current */
+        [[nodiscard]] auto interpolate(const transform& current, float alpha) const noexcept -> transform;
+    };
+
+    /* runs before the fixed steps & update_step so both see this frame's delta */
+    auto update_time(const pre_update_step& step) noexcept -> void;
+    /* keeps the transforms of fixed_step_interpolation entities before each fixed step, added ahead of the fixed systems */
+    auto store_fixed_step_transforms(const fixed_update_step& step) noexcept -> void;
 
     struct time_plugin
     {
+        /* rate of fixed_update_step, must be positive */
+        float fixed_hz = 60.f;
+        std::uint32_t max_fixed_steps = 8;
+
         auto init(application& app) const noexcept -> void;
     };
 }
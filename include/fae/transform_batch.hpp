@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "fae/math.hpp"
+
+namespace fae
+{
+    /* transforms as structure of arrays, each pointer to count floats */
+    struct transform_soa
+    {
+        const float* position_x = nullptr;
+        const float* position_y = nullptr;
+        const float* position_z = nullptr;
+        const float* rotation_x = nullptr;
+        const float* rotation_y = nullptr;
+        const float* rotation_z = nullptr;
+        const float* rotation_w = nullptr;
+        const float* scale_x = nullptr;
+        const float* scale_y = nullptr;
+        const float* scale_z = nullptr;
+        std::size_t count = 0;
+    };
+
+    /*
+    out[i] = transforms[i].to_mat4() for a whole batch of transforms, 8 at a time with avx2 or 4 at a time with sse (picked once from the cpu)
+    the same arithmetic as to_mat4 in the same order & without fused multiply-adds (the file is built with -ffp-contract=off)
+    so the results match compose_trs_scalar exactly, & to_mat4 compiled with contractions elsewhere up to rounding
+    out must hold at least as many matrices as there are transforms
+    */
+    auto compose_trs(std::span<const transform> transforms, std::span<mat4> out) noexcept -> void;
+    auto compose_trs(const transform_soa& transforms, std::span<mat4> out) noexcept -> void;
+
+    /* the scalar reference, to_mat4 in a loop */
+    auto compose_trs_scalar(std::span<const transform> transforms, std::span<mat4> out) noexcept -> void;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fae/entity.hpp"
+#include "fae/math.hpp"
+
+namespace fae
+{
+    struct application;
+    struct post_update_step;
+
+    /*
+    world space transform of an entity, its transform combined with those of its parents (see fae::parent)
+    added to every entity with a transform & kept up to date by propagate_transforms, read it instead of transform::to_mat4() when drawing
+    only transforms flagged through the registry (set_component, patch_component, mark_changed) are propagated, not ones changed through plain references
+    */
+    struct global_transform
+    {
+        mat4 matrix{ 1.f };
+        /* number of parents above the entity */
+        std::uint32_t depth = 0;
+        /* morton code of the position, orders the entities of a depth level when transform_hierarchy::spatial_order is set */
+        std::uint64_t spatial_key = 0;
+        /* propagation pass in which matrix was last computed */
+        std::uint64_t updated_pass = 0;
+
+        [[nodiscard]] inline auto position() const noexcept -> vec3
+        {
+            return vec3(matrix[3]);
+        }
+    };
+
+    /*
+    bookkeeping of propagate_transforms, a resource
+    global_transforms are kept sorted by depth (breadth first) so every parent comes before its children in the pool
+    & every depth level is a contiguous range whose entities only depend on the previous level, updated in parallel
+    with spatial_order, a level is sorted by the morton code of the positions, so entities close in space are close in the pool
+    (positions as of the sort, set needs_sort to sort moving entities again)
+    only the entities whose transform was flagged as changed & their descendants are propagated, marking is not thread safe
+    (flag transforms changed from parallel jobs, e.g. par_each, once they are done)
+    */
+    struct transform_hierarchy
+    {
+        /* set when a parent or global_transform is added, changed or removed, the next propagation sorts again & recomputes everything */
+        bool needs_sort = true;
+        bool spatial_order = false;
+        /* size of the grid cells positions are quantized to for spatial_order */
+        float spatial_cell_size = 1.f;
+        /* end of each depth level in the global_transform pool, in order */
+        std::vector<std::size_t> level_ends{};
+        std::uint64_t pass = 0;
+        /* bumped every time the global_transform pool is sorted, for pools kept in the same order (e.g. models, see extract_render_snapshot) */
+        std::uint64_t order = 0;
+        /* entities whose transform was added, changed or removed since the last propagation */
+        std::vector<entity> dirty{};
+        /* entities whose global_transform changed in the last propagation */
+        std::vector<entity> moved{};
+        /*
+        children of every entity by position in the global_transform pool, as of the last sort
+        the children of position i are child_indices[child_offsets[i]] up to child_indices[child_offsets[i + 1]]
+        */
+        std::vector<std::size_t> child_offsets{};
+        std::vector<std::size_t> child_indices{};
+        /* pool positions propagated in the last pass, in pool order, kept to reuse their memory */
+        std::vector<std::size_t> pending{};
+        std::vector<std::uint8_t> pending_moved{};
+
+        auto mark_unsorted([[maybe_unused]] entity_registry_t& registry, [[maybe_unused]] entity id) noexcept -> void
+        {
+            needs_sort = true;
+        }
+
+        auto mark_dirty([[maybe_unused]] entity_registry_t& registry, entity id) -> void
+        {
+            dirty.push_back(id);
+        }
+    };
+
+    /* sets the parent of child, keeping the parent's children list in sync (pass entt::null to detach), logs an error & does nothing if it would make a cycle */
+    auto set_parent(entity_registry_t& registry, entity child, entity parent) -> void;
+
+    /* world matrix of the entity, from its global_transform if it has one (falls back to its local transform) */
+    [[nodiscard]] auto world_matrix_of(const entity_registry_t& registry, entity id) noexcept -> mat4;
+
+    auto propagate_transforms(const post_update_step& step) noexcept -> void;
+
+    struct transform_hierarchy_plugin
+    {
+        bool spatial_order = false;
+        float spatial_cell_size = 1.f;
+
+        auto init(application& app) const noexcept -> void;
+    };
+}
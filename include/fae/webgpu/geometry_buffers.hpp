@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "fae/core/free_list_allocator.hpp"
+
+namespace fae
+{
+    struct mesh;
+
+    /*
+    a few large vertex & index buffers (arenas) that every uploaded mesh is sub-allocated from
+    so draws only differ in their base vertex & first index and the buffers are bound once per pass
+    */
+    struct geometry_buffers
+    {
+        struct arena
+        {
+            wgpu::Buffer buffer;
+            free_list_allocator allocator;
+        };
+
+        struct allocation
+        {
+            std::size_t vertex_arena = 0;
+            free_list_allocator::allocation vertices;
+            std::size_t index_arena = 0;
+            free_list_allocator::allocation indices;
+            /* used to detect the mesh's vertices or indices being replaced since the upload */
+            const void* source_vertices = nullptr;
+            const void* source_indices = nullptr;
+            std::size_t last_used_frame = 0;
+        };
+
+        struct statistics
+        {
+            std::size_t mesh_count = 0;
+            std::size_t vertex_arena_count = 0;
+            std::size_t vertex_capacity = 0;
+            std::size_t vertices_used = 0;
+            /* of the most fragmented arena */
+            float vertex_fragmentation = 0.f;
+            std::size_t index_arena_count = 0;
+            std::size_t index_capacity = 0;
+            std::size_t indices_used = 0;
+            float index_fragmentation = 0.f;
+        };
+
+        /* in elements (vertices and indices), arenas are grown by adding new ones of at least this size */
+        std::size_t vertex_arena_capacity = 1 << 18;
+        std::size_t index_arena_capacity = 1 << 20;
+        /* meshes not drawn for this many frames are evicted */
+        std::size_t eviction_frames = 300;
+        /* arenas whose free space is more fragmented than this are compacted at the end of a frame */
+        float defragmentation_threshold = 0.5f;
+
+        std::vector<arena> vertex_arenas;
+        std::vector<arena> index_arenas;
+
+        /* uploads the mesh if it is not resident yet & returns where it lives, meshes are told apart by mesh::id */
+        [[nodiscard]] auto upload(const wgpu::Device& device, const mesh& mesh) -> std::optional<allocation>;
+        /* frees the mesh's geometry right away instead of once it is evicted (e.g. when its model is destroyed) */
+        auto release(const mesh& mesh) noexcept -> void;
+        /* evicts unused meshes & compacts fragmented arenas, call once per frame after submitting */
+        auto end_frame(const wgpu::Device& device) -> void;
+        auto defragment(const wgpu::Device& device) -> void;
+        [[nodiscard]] auto get_statistics() const noexcept -> statistics;
+
+      private:
+        /* by mesh::id */
+        std::unordered_map<std::uint64_t, allocation> m_allocations;
+        std::size_t m_frame = 0;
+
+        auto release(const allocation& value) noexcept -> void;
+    };
+}
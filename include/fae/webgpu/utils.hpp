@@ -10,6 +10,8 @@
 
 namespace fae
 {
+    struct virtual_file_system;
+
     [[nodiscard]] auto request_adapter_sync(wgpu::Instance instance, wgpu::RequestAdapterOptions adapter_options = {}) noexcept -> wgpu::Adapter;
     [[nodiscard]] auto request_device_sync(wgpu::Adapter adapter, wgpu::DeviceDescriptor device_descriptor = {}) noexcept -> wgpu::Device;
     [[nodiscard]] wgpu::Buffer create_buffer(const wgpu::Device& device,
@@ -27,6 +29,10 @@ namespace fae
     [[nodiscard]] std::optional<wgpu::ShaderModule> create_shader_module_from_path(const wgpu::Device& device,
         std::string_view label,
         const std::filesystem::path& path);
+    [[nodiscard]] std::optional<wgpu::ShaderModule> create_shader_module_from_path(const wgpu::Device& device,
+        std::string_view label,
+        const std::filesystem::path& path,
+        const virtual_file_system& vfs);
     [[nodiscard]] wgpu::Texture create_texture(const wgpu::Device& device,
         std::string_view label,
         wgpu::Extent3D extent,
@@ -3,6 +3,9 @@
 #include <array>
 #include <any>
 #include <memory>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
 
 #include <webgpu/webgpu_cpp.h>
 
@@ -16,6 +19,7 @@
 #include "fae/rendering/texture.hpp"
 #include "fae/rendering/render_pipeline.hpp"
 
+#include "geometry_buffers.hpp"
 #include "sdl_impl.hpp"
 #include "string_utils.hpp"
 #include "utils.hpp"
@@ -52,16 +56,26 @@ namespace fae
 
             struct render_command
             {
-                std::vector<vertex> vertex_data;
-                std::vector<std::uint32_t> index_data;
-                std::vector<std::uint8_t> uniform_data;
+                geometry_buffers::allocation geometry;
+                /* index range to draw, relative to the first index of the geometry */
+                std::uint32_t first_index;
+                std::uint32_t index_count;
+                std::pmr::vector<std::uint8_t> uniform_data;
                 wgpu::TextureView texture_view;
                 wgpu::Sampler sampler;
+                /* the arena buffers of geometry, resolved when the pass ends (the arenas may grow before the pass is submitted) */
+                wgpu::Buffer vertex_buffer;
+                wgpu::Buffer index_buffer;
             };
-            std::vector<render_command> render_commands;
+            /* from the frame arena, like every command's uniform data */
+            std::pmr::vector<render_command> render_commands;
             std::string label;
         };
         std::vector<render_pass> render_passes;
+
+        geometry_buffers geometry;
+        /* by texture::id */
+        std::unordered_map<std::uint64_t, texture_and_view> textures;
     };
 
     struct webgpu_plugin
@@ -0,0 +1,484 @@
+#include "fae/allocation_tracker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <format>
+#include <new>
+#include <string>
+
+#include "fae/application/application.hpp"
+#include "fae/logging.hpp"
+
+namespace fae
+{
+#ifdef FAE_TRACK_ALLOCATIONS
+    namespace
+    {
+        constexpr std::size_t max_tracked_threads = 128;
+        constexpr std::size_t max_tracked_tags = 64;
+        constexpr auto untagged = "untagged";
+
+        /* written only by its thread (a load & a store, not a locked add), read when collecting */
+        struct counter
+        {
+            std::atomic<std::uint64_t> value = 0;
+            /* value at the last collection, only touched while collecting */
+            std::uint64_t collected = 0;
+
+            auto add(std::uint64_t amount) noexcept -> void
+            {
+                value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] auto collect() noexcept -> std::uint64_t
+            {
+                const auto current = value.load(std::memory_order_relaxed);
+                const auto delta = current - collected;
+                collected = current;
+                return delta;
+            }
+        };
+
+        struct stat_counters
+        {
+            counter allocations;
+            counter bytes;
+            counter frees;
+
+            [[nodiscard]] auto collect() noexcept -> allocation_stats
+            {
+                return allocation_stats{
+                    .allocations = allocations.collect(),
+                    .bytes = bytes.collect(),
+                    .frees = frees.collect(),
+                };
+            }
+        };
+
+        struct tag_counters
+        {
+            std::atomic<const char*> name = nullptr;
+            stat_counters stats;
+        };
+
+        /* counters of a thread slot, a slot is reused by the next thread once its thread exits (its counts so far are still collected) */
+        struct alignas(64) thread_counters
+        {
+            stat_counters total;
+            std::array<tag_counters, max_tracked_tags> tags;
+            std::atomic<std::size_t> tag_count = 0;
+            std::atomic<bool> in_use = false;
+        };
+
+        // fixed storage, registering a thread or a tag must not allocate
+        std::array<thread_counters, max_tracked_threads> threads{};
+        /* slots used so far, collecting reads the slots below it */
+        std::atomic<std::size_t> thread_count = 0;
+
+        thread_local thread_counters* current_thread = nullptr;
+        /* set once the thread exited (or found no free slot), its allocations are not counted from then on */
+        thread_local bool is_untracked_thread = false;
+        thread_local const char* current_tag = untagged;
+        thread_local tag_counters* current_tag_counters = nullptr;
+        thread_local const char* current_tag_counters_name = nullptr;
+        /* set while counting, an allocation made by the tracker itself (none should be) is not counted */
+        thread_local bool is_counting = false;
+
+        /* owns the slot of its thread & frees it when the thread exits, so programs that keep starting threads do not run out */
+        struct thread_slot
+        {
+            thread_counters* counters = nullptr;
+
+            ~thread_slot()
+            {
+                is_untracked_thread = true;
+                current_thread = nullptr;
+                current_tag_counters = nullptr;
+                current_tag_counters_name = nullptr;
+                if (counters)
+                {
+                    counters->in_use.store(false, std::memory_order_release);
+                }
+            }
+        };
+
+        [[nodiscard]] auto claim_slot() noexcept -> thread_counters*
+        {
+            for (std::size_t i = 0; i < max_tracked_threads; ++i)
+            {
+                auto expected = false;
+                if (threads[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+                {
+                    auto count = thread_count.load(std::memory_order_relaxed);
+                    while (count < i + 1 && !thread_count.compare_exchange_weak(count, i + 1, std::memory_order_acq_rel))
+                    {
+                    }
+                    return &threads[i];
+                }
+            }
+            return nullptr;
+        }
+
+        [[nodiscard]] auto same_tag(const char* lhs, const char* rhs) noexcept -> bool
+        {
+            return lhs == rhs || std::string_view(lhs) == std::string_view(rhs);
+        }
+
+        [[nodiscard]] auto find_tag(thread_counters& thread, const char* name) noexcept -> tag_counters&
+        {
+            const auto count = thread.tag_count.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (same_tag(thread.tags[i].name.load(std::memory_order_relaxed), name))
+                {
+                    return thread.tags[i];
+                }
+            }
+            if (count == max_tracked_tags)
+            {
+                // out of slots, counted under the first tag seen
+                return thread.tags[0];
+            }
+            thread.tags[count].name.store(name, std::memory_order_relaxed);
+            thread.tag_count.store(count + 1, std::memory_order_release);
+            return thread.tags[count];
+        }
+
+        [[nodiscard]] auto this_thread() noexcept -> thread_counters*
+        {
+            if (!current_thread && !is_untracked_thread)
+            {
+                thread_local auto slot = thread_slot{};
+                slot.counters = claim_slot();
+                current_thread = slot.counters;
+                is_untracked_thread = !current_thread;
+            }
+            return current_thread;
+        }
+
+        auto count_allocation(std::size_t size) noexcept -> void
+        {
+            if (is_counting)
+            {
+                return;
+            }
+            is_counting = true;
+            if (auto* thread = this_thread())
+            {
+                thread->total.allocations.add(1);
+                thread->total.bytes.add(size);
+                if (current_tag_counters_name != current_tag)
+                {
+                    current_tag_counters = &find_tag(*thread, current_tag);
+                    current_tag_counters_name = current_tag;
+                }
+                current_tag_counters->stats.allocations.add(1);
+                current_tag_counters->stats.bytes.add(size);
+            }
+            is_counting = false;
+        }
+
+        auto count_free() noexcept -> void
+        {
+            if (is_counting)
+            {
+                return;
+            }
+            is_counting = true;
+            if (auto* thread = this_thread())
+            {
+                thread->total.frees.add(1);
+                if (current_tag_counters_name != current_tag)
+                {
+                    current_tag_counters = &find_tag(*thread, current_tag);
+                    current_tag_counters_name = current_tag;
+                }
+                current_tag_counters->stats.frees.add(1);
+            }
+            is_counting = false;
+        }
+
+        [[nodiscard]] auto allocate(std::size_t size) noexcept -> void*
+        {
+            count_allocation(size);
+            return std::malloc(size > 0 ? size : 1);
+        }
+
+        [[nodiscard]] auto allocate_aligned(std::size_t size, std::align_val_t alignment) noexcept -> void*
+        {
+            count_allocation(size);
+            const auto align = static_cast<std::size_t>(alignment);
+#ifdef FAE_PLATFORM_WINDOWS
+            return _aligned_malloc(size > 0 ? size : 1, align);
+#else
+            // aligned_alloc needs a size that is a multiple of the alignment
+            const auto rounded = ((size > 0 ? size : 1) + align - 1) / align * align;
+            return std::aligned_alloc(align, rounded);
+#endif
+        }
+
+        auto deallocate(void* pointer) noexcept -> void
+        {
+            if (!pointer)
+            {
+                return;
+            }
+            count_free();
+            std::free(pointer);
+        }
+
+        auto deallocate_aligned(void* pointer) noexcept -> void
+        {
+            if (!pointer)
+            {
+                return;
+            }
+            count_free();
+#ifdef FAE_PLATFORM_WINDOWS
+            _aligned_free(pointer);
+#else
+            std::free(pointer);
+#endif
+        }
+
+        [[nodiscard]] auto allocate_or_throw(std::size_t size) -> void*
+        {
+            if (auto* pointer = allocate(size))
+            {
+                return pointer;
+            }
+            throw std::bad_alloc();
+        }
+
+        [[nodiscard]] auto allocate_aligned_or_throw(std::size_t size, std::align_val_t alignment) -> void*
+        {
+            if (auto* pointer = allocate_aligned(size, alignment))
+            {
+                return pointer;
+            }
+            throw std::bad_alloc();
+        }
+
+        auto add(allocation_stats& stats, const allocation_stats& other) noexcept -> void
+        {
+            stats.allocations += other.allocations;
+            stats.bytes += other.bytes;
+            stats.frees += other.frees;
+        }
+
+        [[nodiscard]] auto is_empty(const allocation_stats& stats) noexcept -> bool
+        {
+            return stats.allocations == 0 && stats.frees == 0;
+        }
+    }
+
+    allocation_scope::allocation_scope(const char* tag) noexcept : m_previous(current_tag)
+    {
+        current_tag = tag;
+    }
+
+    allocation_scope::~allocation_scope()
+    {
+        current_tag = m_previous;
+    }
+
+    auto collect_allocations(allocation_report& report) noexcept -> void
+    {
+        // the report's own growth is not counted
+        const auto was_counting = is_counting;
+        is_counting = true;
+        ++report.frame;
+        report.total = {};
+        report.threads.clear();
+        for (auto& tag : report.tags)
+        {
+            tag.stats = {};
+        }
+
+        const auto count = thread_count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto& thread = threads[i];
+            const auto stats = thread.total.collect();
+            add(report.total, stats);
+            if (!is_empty(stats))
+            {
+                report.threads.push_back(allocation_report::thread{ .index = i, .stats = stats });
+            }
+
+            const auto tag_count = thread.tag_count.load(std::memory_order_acquire);
+            for (std::size_t t = 0; t < tag_count; ++t)
+            {
+                auto& tag = thread.tags[t];
+                const auto tag_stats = tag.stats.collect();
+                if (is_empty(tag_stats))
+                {
+                    continue;
+                }
+                const auto name = std::string_view(tag.name.load(std::memory_order_relaxed));
+                auto it = std::ranges::find(report.tags, name, &allocation_report::tag::name);
+                if (it == report.tags.end())
+                {
+                    it = report.tags.insert(report.tags.end(), allocation_report::tag{ .name = name });
+                }
+                add(it->stats, tag_stats);
+            }
+        }
+        // tags that did not allocate this time stay in the report (zeroed) so their slots are reused
+        std::ranges::stable_sort(report.tags, std::ranges::greater{}, [](const allocation_report::tag& tag)
+            { return tag.stats.bytes; });
+        is_counting = was_counting;
+    }
+#else
+    auto collect_allocations(allocation_report& report) noexcept -> void
+    {
+        ++report.frame;
+    }
+#endif
+
+    auto allocation_tracking_plugin::init(application& app) const noexcept -> void
+    {
+        if (!is_tracking_allocations())
+        {
+            fae::log_warning("allocation tracking needs a build with FAE_TRACK_ALLOCATIONS, reports will be empty");
+        }
+        app.set_global_component<allocation_report>(allocation_report{})
+            .set_global_component<allocation_budget>(allocation_budget{ .warmup_frames = zero_allocation_after_frames });
+        app.add_system<pre_update_step>(track_frame_allocations);
+    }
+
+    auto track_frame_allocations(const pre_update_step& step) noexcept -> void
+    {
+        auto* report = step.ecs_world.resources.get<allocation_report>();
+        if (!report)
+        {
+            return;
+        }
+        [[maybe_unused]] auto allocations = allocation_scope("allocation_tracking");
+        collect_allocations(*report);
+
+        auto* budget = step.ecs_world.resources.get<allocation_budget>();
+        if (!budget || budget->warmup_frames == 0 || report->frame <= budget->warmup_frames)
+        {
+            return;
+        }
+        // what the last check logged is not held against this frame
+        auto allocations_in_frame = report->total.allocations;
+        for (const auto& tag : report->tags)
+        {
+            if (tag.name == "allocation_tracking")
+            {
+                allocations_in_frame -= tag.stats.allocations;
+            }
+        }
+        if (allocations_in_frame == 0)
+        {
+            return;
+        }
+        ++budget->violations;
+        auto message = std::format("frame {} allocated {} times ({} bytes) after the warmup:", report->frame, allocations_in_frame, report->total.bytes);
+        for (const auto& tag : report->tags)
+        {
+            if (tag.stats.allocations > 0 && tag.name != "allocation_tracking")
+            {
+                message += std::format(" [{}] {} ({} bytes)", tag.name, tag.stats.allocations, tag.stats.bytes);
+            }
+        }
+        fae::log_error(message);
+    }
+}
+
+#ifdef FAE_TRACK_ALLOCATIONS
+// replacements of the global allocation functions, every other overload forwards to these
+auto operator new(std::size_t size) -> void*
+{
+    return fae::allocate_or_throw(size);
+}
+
+auto operator new[](std::size_t size) -> void*
+{
+    return fae::allocate_or_throw(size);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void*
+{
+    return fae::allocate_aligned_or_throw(size, alignment);
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void*
+{
+    return fae::allocate_aligned_or_throw(size, alignment);
+}
+
+auto operator new(std::size_t size, const std::nothrow_t&) noexcept -> void*
+{
+    return fae::allocate(size);
+}
+
+auto operator new[](std::size_t size, const std::nothrow_t&) noexcept -> void*
+{
+    return fae::allocate(size);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept -> void*
+{
+    return fae::allocate_aligned(size, alignment);
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept -> void*
+{
+    return fae::allocate_aligned(size, alignment);
+}
+
+auto operator delete(void* pointer) noexcept -> void
+{
+    fae::deallocate(pointer);
+}
+
+auto operator delete[](void* pointer) noexcept -> void
+{
+    fae::deallocate(pointer);
+}
+
+auto operator delete(void* pointer, std::size_t) noexcept -> void
+{
+    fae::deallocate(pointer);
+}
+
+auto operator delete[](void* pointer, std::size_t) noexcept -> void
+{
+    fae::deallocate(pointer);
+}
+
+auto operator delete(void* pointer, std::align_val_t) noexcept -> void
+{
+    fae::deallocate_aligned(pointer);
+}
+
+auto operator delete[](void* pointer, std::align_val_t) noexcept -> void
+{
+    fae::deallocate_aligned(pointer);
+}
+
+auto operator delete(void* pointer, std::size_t, std::align_val_t) noexcept -> void
+{
+    fae::deallocate_aligned(pointer);
+}
+
+auto operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept -> void
+{
+    fae::deallocate_aligned(pointer);
+}
+
+auto operator delete(void* pointer, const std::nothrow_t&) noexcept -> void
+{
+    fae::deallocate(pointer);
+}
+
+auto operator delete[](void* pointer, const std::nothrow_t&) noexcept -> void
+{
+    fae::deallocate(pointer);
+}
+#endif
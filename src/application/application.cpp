@@ -1,5 +1,11 @@
 #include "fae/application/application.hpp"
 
+#include <algorithm>
+
+#include "fae/allocation_tracker.hpp"
+#include "fae/profiler.hpp"
+#include "fae/time.hpp"
+
 #ifdef FAE_PLATFORM_WEB
 #include <emscripten/emscripten.h>
 #endif
@@ -8,24 +14,45 @@ namespace fae
 {
     auto application::step() -> void
     {
-        scheduler.invoke(pre_update_step{
-            .global_entity = global_entity,
-            .assets = assets,
-            .scheduler = scheduler,
-            .ecs_world = ecs_world,
-        });
-        scheduler.invoke(update_step{
-            .global_entity = global_entity,
-            .assets = assets,
-            .scheduler = scheduler,
-            .ecs_world = ecs_world,
-        });
-        scheduler.invoke(post_update_step{
-            .global_entity = global_entity,
-            .assets = assets,
-            .scheduler = scheduler,
-            .ecs_world = ecs_world,
-        });
+        // every invoke & system is a zone too when built with FAE_PROFILE (see write_chrome_trace)
+        FAE_PROFILE_SCOPE("application::step");
+        // frees the temporaries of two frames ago, the last frame's may still be read by the render thread
+        ecs_world.frame_memory.next_frame();
+        // allocations are counted per step (& per system, see scheduler::call_system) when built with FAE_TRACK_ALLOCATIONS (see allocation_tracking_plugin)
+        {
+            [[maybe_unused]] auto allocations = allocation_scope("pre_update_step");
+            scheduler.invoke(pre_update_step{
+                .global_entity = global_entity,
+                .assets = assets,
+                .scheduler = scheduler,
+                .ecs_world = ecs_world,
+            });
+            ecs_world.apply_commands();
+        }
+        {
+            [[maybe_unused]] auto allocations = allocation_scope("fixed_update_step");
+            run_fixed_steps();
+        }
+        {
+            [[maybe_unused]] auto allocations = allocation_scope("update_step");
+            scheduler.invoke(update_step{
+                .global_entity = global_entity,
+                .assets = assets,
+                .scheduler = scheduler,
+                .ecs_world = ecs_world,
+            });
+            ecs_world.apply_commands();
+        }
+        {
+            [[maybe_unused]] auto allocations = allocation_scope("post_update_step");
+            scheduler.invoke(post_update_step{
+                .global_entity = global_entity,
+                .assets = assets,
+                .scheduler = scheduler,
+                .ecs_world = ecs_world,
+            });
+            ecs_world.apply_commands();
+        }
 
         if (!is_running)
         {
@@ -35,6 +62,7 @@ namespace fae
                 .scheduler = scheduler,
                 .ecs_world = ecs_world,
             });
+            ecs_world.apply_commands();
             scheduler.invoke(deinit_step{
                 .global_entity = global_entity,
                 .assets = assets,
@@ -47,6 +75,36 @@ namespace fae
         }
     }
 
+    auto application::run_fixed_steps() -> void
+    {
+        auto* time = ecs_world.resources.get<fae::time>();
+        if (!time || time->fixed_delta <= duration{})
+        {
+            return;
+        }
+        time->fixed_accumulator += time->delta();
+        time->fixed_steps = 0;
+        while (time->fixed_accumulator >= time->fixed_delta)
+        {
+            if (time->fixed_steps == time->max_fixed_steps)
+            {
+                // too far behind to catch up, drop the rest instead of spending even longer on the next frame
+                time->fixed_accumulator = duration{ std::chrono::nanoseconds(time->fixed_accumulator.nanoseconds().count() % time->fixed_delta.nanoseconds().count()) };
+                break;
+            }
+            scheduler.invoke(fixed_update_step{
+                .global_entity = global_entity,
+                .assets = assets,
+                .scheduler = scheduler,
+                .ecs_world = ecs_world,
+            });
+            ecs_world.apply_commands();
+            time->fixed_accumulator -= time->fixed_delta;
+            ++time->fixed_steps;
+        }
+        time->fixed_alpha = std::clamp(time->fixed_accumulator.seconds_f32() / time->fixed_delta.seconds_f32(), 0.f, 1.f);
+    }
+
     auto application::run() -> void
     {
         is_running = true;
@@ -61,12 +119,14 @@ namespace fae
             .scheduler = scheduler,
             .ecs_world = ecs_world,
         });
+        ecs_world.apply_commands();
         scheduler.invoke(start_step{
             .global_entity = global_entity,
             .assets = assets,
             .scheduler = scheduler,
             .ecs_world = ecs_world,
         });
+        ecs_world.apply_commands();
 #ifdef FAE_PLATFORM_WEB
         emscripten_set_main_loop_arg([](void* arg) -> void
             { static_cast<application*>(arg)->step(); }, reinterpret_cast<void*>(this), 0, 1);
@@ -0,0 +1,125 @@
+#include "fae/command_buffer.hpp"
+
+#include <algorithm>
+
+namespace fae
+{
+    auto command_buffer::clear() -> void
+    {
+        for (const auto& command : m_commands)
+        {
+            if (command.destroy)
+            {
+                command.destroy(command.payload);
+            }
+        }
+        m_commands.clear();
+        m_destroyed.clear();
+        m_spawned.clear();
+        m_oversized.clear();
+        m_spawn_count = 0;
+        m_chunk_index = 0;
+        m_chunk_offset = 0;
+    }
+
+    auto command_buffer::allocate(std::size_t size, std::size_t alignment) -> void*
+    {
+        if (size + alignment > chunk_size)
+        {
+            // operator new[] only guarantees the default alignment, over allocate for the rest
+            auto& storage = m_oversized.emplace_back(std::make_unique<std::byte[]>(size + alignment));
+            void* memory = storage.get();
+            auto space = size + alignment;
+            return std::align(alignment, size, memory, space);
+        }
+        while (true)
+        {
+            if (m_chunk_index == m_chunks.size())
+            {
+                m_chunks.emplace_back(std::make_unique<std::byte[]>(chunk_size));
+            }
+            void* memory = m_chunks[m_chunk_index].get() + m_chunk_offset;
+            auto space = chunk_size - m_chunk_offset;
+            if (std::align(alignment, size, memory, space))
+            {
+                m_chunk_offset = static_cast<std::size_t>(static_cast<std::byte*>(memory) - m_chunks[m_chunk_index].get()) + size;
+                return memory;
+            }
+            ++m_chunk_index;
+            m_chunk_offset = 0;
+        }
+    }
+
+    auto command_buffer::resolve(const command_target& target) const noexcept -> entity
+    {
+        return target.spawn_index == command_target::no_spawn ? target.id : m_spawned[target.spawn_index];
+    }
+
+    auto command_buffers::for_thread(std::size_t slot) -> command_buffer&
+    {
+        auto lock = std::scoped_lock(m_mutex);
+        while (slot >= m_buffers.size())
+        {
+            m_buffers.push_back(std::make_unique<command_buffer>());
+        }
+        return *m_buffers[slot];
+    }
+
+    auto command_buffers::apply(entity_registry_t& registry, std::pmr::memory_resource* memory) -> void
+    {
+        auto lock = std::scoped_lock(m_mutex);
+        auto buffer_locks = std::pmr::vector<std::unique_lock<std::mutex>>(memory);
+        buffer_locks.reserve(m_buffers.size());
+
+        m_pending.clear();
+        for (const auto& buffer : m_buffers)
+        {
+            buffer_locks.emplace_back(buffer->m_mutex);
+            if (buffer->m_spawn_count > 0)
+            {
+                buffer->m_spawned.resize(buffer->m_spawn_count);
+                registry.create(buffer->m_spawned.begin(), buffer->m_spawned.end());
+            }
+            for (const auto& command : buffer->m_commands)
+            {
+                m_pending.push_back(pending_command{ .buffer = buffer.get(), .command = &command });
+            }
+        }
+
+        std::ranges::stable_sort(m_pending, {}, [](const pending_command& pending)
+            { return pending.command->pool; });
+        for (const auto& pending : m_pending)
+        {
+            const auto id = pending.buffer->resolve(pending.command->target);
+            if (registry.valid(id))
+            {
+                pending.command->apply(registry, id, pending.command->payload);
+            }
+        }
+        m_pending.clear();
+
+        m_destroyed.clear();
+        for (const auto& buffer : m_buffers)
+        {
+            for (const auto& target : buffer->m_destroyed)
+            {
+                m_destroyed.push_back(buffer->resolve(target));
+            }
+        }
+        std::ranges::sort(m_destroyed);
+        const auto duplicates = std::ranges::unique(m_destroyed);
+        m_destroyed.erase(duplicates.begin(), duplicates.end());
+        for (auto id : m_destroyed)
+        {
+            if (registry.valid(id))
+            {
+                registry.destroy(id);
+            }
+        }
+
+        for (const auto& buffer : m_buffers)
+        {
+            buffer->clear();
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#include "fae/core/dense_type_index.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace fae
+{
+    namespace
+    {
+        struct dense_type_indices
+        {
+            std::mutex mutex;
+            /* by family hash << 32 | type hash */
+            std::unordered_map<std::uint64_t, std::size_t> indices;
+            std::unordered_map<entt::id_type, std::size_t> family_sizes;
+        };
+
+        auto get_dense_type_indices() -> dense_type_indices&
+        {
+            static auto instance = dense_type_indices{};
+            return instance;
+        }
+    }
+
+    auto register_dense_type_index(entt::id_type family, entt::id_type type) -> std::size_t
+    {
+        auto& table = get_dense_type_indices();
+        const auto key = static_cast<std::uint64_t>(family) << 32 | type;
+        auto lock = std::scoped_lock(table.mutex);
+        if (auto it = table.indices.find(key); it != table.indices.end())
+        {
+            return it->second;
+        }
+        const auto index = table.family_sizes[family]++;
+        table.indices.emplace(key, index);
+        return index;
+    }
+}
@@ -8,6 +8,7 @@ namespace fae
     {
         app
             .add_plugin(time_plugin)
+            .add_plugin(transform_hierarchy_plugin)
             .add_plugin(windowing_plugin)
             .add_plugin(input_plugin)
             .add_plugin(rendering_plugin)
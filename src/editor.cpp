@@ -7,6 +7,7 @@
 #include "fae/logging.hpp"
 #include "fae/rendering/rendering.hpp"
 #include "fae/lighting.hpp"
+#include "fae/webgpu/webgpu.hpp"
 
 namespace fae
 {
@@ -39,19 +40,12 @@ namespace fae
 
         if (ImGui::IsKeyPressed(ImGuiKey_Delete))
         {
+            // deferred, the scene is still being iterated & drawn this frame
             step.global_entity.use_component<editor>([&](editor& editor)
-                { 
-                    auto entity = fae::entity_commands
-                    {
-                        .id = editor.selected_entity,
-                        .registry = step.ecs_world.registry,
-                    };
-                    if (!entity.valid())
-                        return;
-                        entity.destroy(); });
+                { step.ecs_world.commands().get_entity(editor.selected_entity).destroy(); });
         }
 
-        for (auto& entity : step.ecs_world.entities())
+        for (auto entity : step.ecs_world.entities())
         {
             auto name = std::to_string(static_cast<std::uint32_t>(entity.id));
             entity.use_component<fae::name>([&](fae::name& name_component)
@@ -95,25 +89,37 @@ namespace fae
                     }
                     prev_selected_entity = editor.selected_entity;
 
+                    auto is_transform_edited = false;
                     entity.use_component<transform>([&](transform& transform)
                         {
                             if (fae::ui::CollapsingHeader("Transform", ImGuiTreeNodeFlags_DefaultOpen))
                             {
-                                fae::ui::DragFloat3("Position", fae::math::value_ptr(transform.position), 0.01f);
+                                is_transform_edited |= fae::ui::DragFloat3("Position", fae::math::value_ptr(transform.position), 0.01f);
                                 auto euler = fae::math::eulerAngles(transform.rotation);
-                                fae::ui::DragFloat3("Rotation", fae::math::value_ptr(euler), 0.01f);
-                                transform.rotation = fae::math::quat(euler);
-                                fae::ui::DragFloat3("Scale", fae::math::value_ptr(transform.scale), 0.01f);
+                                if (fae::ui::DragFloat3("Rotation", fae::math::value_ptr(euler), 0.01f))
+                                {
+                                    transform.rotation = fae::math::quat(euler);
+                                    is_transform_edited = true;
+                                }
+                                is_transform_edited |= fae::ui::DragFloat3("Scale", fae::math::value_ptr(transform.scale), 0.01f);
                             }
                         });
+                    // edited in place, flagged so the transform hierarchy propagates it
+                    if (is_transform_edited)
+                    {
+                        entity.mark_changed<transform>();
+                    }
 
                         entity.use_component<ambient_light>([&](ambient_light& light)
                         {
                             if (fae::ui::CollapsingHeader("Ambient Light"), ImGuiTreeNodeFlags_DefaultOpen)
                             {
                             auto color = light.color.to_array();
-                            fae::ui::ColorEdit4("Color", color.data());
-                            light.color = fae::color::from_array(color);
+                            if (fae::ui::ColorEdit4("Color", color.data()))
+                            {
+                                light.color = fae::color::from_array(color);
+                                entity.mark_changed<ambient_light>();
+                            }
                             }
                         });
                     
@@ -121,11 +127,15 @@ namespace fae
                         {
                             if (fae::ui::CollapsingHeader("Directional Light"), ImGuiTreeNodeFlags_DefaultOpen)
                             {
-                            fae::ui::DragFloat3("Direction", fae::math::value_ptr(light.direction), 1.f, -1.f, 1.f);
+                            auto is_edited = fae::ui::DragFloat3("Direction", fae::math::value_ptr(light.direction), 1.f, -1.f, 1.f);
                             light.direction = fae::math::normalize(light.direction);
                             auto color = light.color.to_array();
-                            fae::ui::ColorEdit4("Color", color.data());
+                            is_edited |= fae::ui::ColorEdit4("Color", color.data());
                             light.color = fae::color::from_array(color);
+                            if (is_edited)
+                            {
+                                entity.mark_changed<directional_light>();
+                            }
                             }
                         });
                 }
@@ -145,6 +155,17 @@ namespace fae
                     renderer.set_clear_color(fae::color::from_array(clear_color));
                 }
             });
+        step.global_entity.use_component<fae::webgpu>(
+            [&](fae::webgpu& webgpu)
+            {
+                if (fae::ui::CollapsingHeader("Geometry Buffers"))
+                {
+                    const auto stats = webgpu.geometry.get_statistics();
+                    fae::ui::Text("Meshes: %zu", stats.mesh_count);
+                    fae::ui::Text("Vertices: %zu / %zu (%zu arenas, %.0f%% fragmented)", stats.vertices_used, stats.vertex_capacity, stats.vertex_arena_count, stats.vertex_fragmentation * 100.f);
+                    fae::ui::Text("Indices: %zu / %zu (%zu arenas, %.0f%% fragmented)", stats.indices_used, stats.index_capacity, stats.index_arena_count, stats.index_fragmentation * 100.f);
+                }
+            });
         fae::ui::End();
     }
 }
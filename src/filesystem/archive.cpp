@@ -0,0 +1,266 @@
+#include "fae/filesystem/archive.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <type_traits>
+
+#include "fae/core/lz4.hpp"
+#include "fae/logging.hpp"
+
+namespace fae
+{
+    static_assert(std::endian::native == std::endian::little, "archives are read in place and assume a little endian host");
+    static_assert(std::is_trivially_copyable_v<archive::header> && sizeof(archive::header) == 32);
+    static_assert(std::is_trivially_copyable_v<archive::entry> && sizeof(archive::entry) == 48);
+
+    namespace
+    {
+        auto read_file(const std::filesystem::path& path) -> std::optional<std::vector<byte>>
+        {
+            auto file = std::ifstream(path, std::ios::binary | std::ios::ate);
+            if (!file.is_open())
+            {
+                return std::nullopt;
+            }
+            auto data = std::vector<byte>(static_cast<std::size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            return data;
+        }
+
+        auto is_precompressed(const std::filesystem::path& path) -> bool
+        {
+            constexpr auto extensions = std::array<std::string_view, 10>{ ".png", ".jpg", ".jpeg", ".gif", ".webp", ".ktx2", ".ogg", ".mp3", ".flac", ".zip" };
+            auto extension = path.extension().string();
+            std::ranges::transform(extension, extension.begin(), [](char c)
+                { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+            return std::ranges::find(extensions, extension) != extensions.end();
+        }
+    }
+
+    auto normalize_asset_path(const std::filesystem::path& path) -> std::string
+    {
+        auto result = path.lexically_normal().relative_path().generic_string();
+        return result == "." ? std::string{} : result;
+    }
+
+    auto archive::open(const std::filesystem::path& path) -> std::optional<archive>
+    {
+        auto file = mapped_file::open(path);
+        if (!file)
+        {
+            fae::log_error(std::format("failed to open archive {}", path.string()));
+            return std::nullopt;
+        }
+
+        const auto data = file->data();
+        auto file_header = header{};
+        if (data.size() < sizeof(header))
+        {
+            fae::log_error(std::format("archive {} is truncated", path.string()));
+            return std::nullopt;
+        }
+        std::memcpy(&file_header, data.data(), sizeof(header));
+        if (std::string_view(file_header.magic, sizeof(file_header.magic)) != magic || file_header.version != version)
+        {
+            fae::log_error(std::format("{} is not a version {} archive", path.string(), version));
+            return std::nullopt;
+        }
+
+        const auto toc_size = static_cast<std::uint64_t>(file_header.entry_count) * sizeof(entry);
+        if (file_header.toc_offset > data.size() || toc_size > data.size() - file_header.toc_offset || file_header.paths_offset > data.size())
+        {
+            fae::log_error(std::format("archive {} has a corrupt table of contents", path.string()));
+            return std::nullopt;
+        }
+
+        auto result = archive{};
+        result.m_entries.resize(file_header.entry_count);
+        std::memcpy(result.m_entries.data(), data.data() + file_header.toc_offset, toc_size);
+        const auto paths_size = data.size() - file_header.paths_offset;
+        for (const auto& entry : result.m_entries)
+        {
+            if (entry.offset > data.size() || entry.stored_size > data.size() - entry.offset ||
+                entry.path_offset > paths_size || entry.path_size > paths_size - entry.path_offset)
+            {
+                fae::log_error(std::format("archive {} has an entry out of bounds", path.string()));
+                return std::nullopt;
+            }
+        }
+        result.m_paths_offset = file_header.paths_offset;
+        result.m_file = std::move(*file);
+        return result;
+    }
+
+    auto archive::hash_path(std::string_view path) noexcept -> std::uint64_t
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (auto c : path)
+        {
+            hash = (hash ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    auto archive::find(std::string_view path) const noexcept -> const entry*
+    {
+        const auto hash = hash_path(path);
+        auto it = std::ranges::lower_bound(m_entries, hash, {}, &entry::path_hash);
+        for (; it != m_entries.end() && it->path_hash == hash; ++it)
+        {
+            if (path_of(*it) == path)
+            {
+                return &*it;
+            }
+        }
+        return nullptr;
+    }
+
+    auto archive::entries() const noexcept -> std::span<const entry>
+    {
+        return m_entries;
+    }
+
+    auto archive::path_of(const entry& entry) const noexcept -> std::string_view
+    {
+        return { reinterpret_cast<const char*>(m_file.data().data() + m_paths_offset + entry.path_offset), entry.path_size };
+    }
+
+    auto archive::stored_data(const entry& entry) const noexcept -> std::span<const byte>
+    {
+        return m_file.data().subspan(entry.offset, entry.stored_size);
+    }
+
+    auto archive::read(const entry& entry) const -> std::optional<std::vector<byte>>
+    {
+        const auto stored = stored_data(entry);
+        switch (entry.compression)
+        {
+        case archive_compression::none:
+            return std::vector<byte>(stored.begin(), stored.end());
+        case archive_compression::lz4:
+        {
+            auto result = std::vector<byte>(entry.size);
+            if (!lz4::decompress(stored, result))
+            {
+                fae::log_error(std::format("failed to decompress {}", path_of(entry)));
+                return std::nullopt;
+            }
+            return result;
+        }
+        }
+        fae::log_error(std::format("{} uses an unknown compression", path_of(entry)));
+        return std::nullopt;
+    }
+
+    auto archive_writer::add(std::string_view path, std::span<const byte> data, archive_compression compression) -> void
+    {
+        auto stored = std::vector<byte>{};
+        if (compression == archive_compression::lz4)
+        {
+            stored = lz4::compress(data);
+            if (stored.size() >= data.size())
+            {
+                compression = archive_compression::none;
+            }
+        }
+        if (compression == archive_compression::none)
+        {
+            stored.assign(data.begin(), data.end());
+        }
+        m_entries.push_back(pending_entry{
+            .path = normalize_asset_path(path),
+            .stored = std::move(stored),
+            .size = data.size(),
+            .compression = compression,
+        });
+    }
+
+    auto archive_writer::write(const std::filesystem::path& path) const -> bool
+    {
+        auto toc = std::vector<archive::entry>{};
+        toc.reserve(m_entries.size());
+        std::uint64_t offset = sizeof(archive::header);
+        std::uint32_t path_offset = 0;
+        for (const auto& pending : m_entries)
+        {
+            toc.push_back(archive::entry{
+                .path_hash = archive::hash_path(pending.path),
+                .offset = offset,
+                .stored_size = pending.stored.size(),
+                .size = pending.size,
+                .path_offset = path_offset,
+                .path_size = static_cast<std::uint32_t>(pending.path.size()),
+                .compression = pending.compression,
+                .reserved = 0,
+            });
+            offset += pending.stored.size();
+            path_offset += static_cast<std::uint32_t>(pending.path.size());
+        }
+        std::ranges::stable_sort(toc, {}, &archive::entry::path_hash);
+
+        // the table of contents is 8 byte aligned
+        const auto padding = (8 - offset % 8) % 8;
+        auto file_header = archive::header{
+            .magic = {},
+            .version = archive::version,
+            .entry_count = static_cast<std::uint32_t>(toc.size()),
+            .toc_offset = offset + padding,
+            .paths_offset = offset + padding + toc.size() * sizeof(archive::entry),
+        };
+        std::ranges::copy(archive::magic, file_header.magic);
+
+        auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            fae::log_error(std::format("failed to write archive {}", path.string()));
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&file_header), sizeof(file_header));
+        for (const auto& pending : m_entries)
+        {
+            file.write(reinterpret_cast<const char*>(pending.stored.data()), static_cast<std::streamsize>(pending.stored.size()));
+        }
+        constexpr auto zeros = std::array<char, 8>{};
+        file.write(zeros.data(), static_cast<std::streamsize>(padding));
+        file.write(reinterpret_cast<const char*>(toc.data()), static_cast<std::streamsize>(toc.size() * sizeof(archive::entry)));
+        for (const auto& pending : m_entries)
+        {
+            file.write(pending.path.data(), static_cast<std::streamsize>(pending.path.size()));
+        }
+        return file.good();
+    }
+
+    auto pack_directory(const std::filesystem::path& directory, const std::filesystem::path& output) -> bool
+    {
+        auto error = std::error_code{};
+        auto writer = archive_writer{};
+        for (const auto& file : std::filesystem::recursive_directory_iterator(directory, error))
+        {
+            if (!file.is_regular_file())
+            {
+                continue;
+            }
+            auto data = read_file(file.path());
+            if (!data)
+            {
+                fae::log_error(std::format("failed to read {}", file.path().string()));
+                return false;
+            }
+
+            const auto relative = std::filesystem::relative(file.path(), directory).generic_string();
+            writer.add(relative, *data, is_precompressed(file.path()) ? archive_compression::none : archive_compression::lz4);
+        }
+        if (error)
+        {
+            fae::log_error(std::format("failed to pack {}: {}", directory.string(), error.message()));
+            return false;
+        }
+        return writer.write(output);
+    }
+}
@@ -0,0 +1,143 @@
+#include "fae/filesystem/mapped_file.hpp"
+
+#include <utility>
+
+#if defined(FAE_PLATFORM_WEB)
+#include <fstream>
+#elif defined(FAE_PLATFORM_WINDOWS)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fae
+{
+    mapped_file::mapped_file(mapped_file&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    auto mapped_file::operator=(mapped_file&& other) noexcept -> mapped_file&
+    {
+        if (this != &other)
+        {
+            close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+#if defined(FAE_PLATFORM_WEB)
+            m_storage = std::move(other.m_storage);
+#elif defined(FAE_PLATFORM_WINDOWS)
+            m_file = std::exchange(other.m_file, nullptr);
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    mapped_file::~mapped_file()
+    {
+        close();
+    }
+
+    auto mapped_file::open(const std::filesystem::path& path) -> std::optional<mapped_file>
+    {
+        auto result = mapped_file{};
+#if defined(FAE_PLATFORM_WEB)
+        auto file = std::ifstream(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+        {
+            return std::nullopt;
+        }
+        result.m_storage.resize(static_cast<std::size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(result.m_storage.data()), static_cast<std::streamsize>(result.m_storage.size()));
+        result.m_data = result.m_storage.data();
+        result.m_size = result.m_storage.size();
+#elif defined(FAE_PLATFORM_WINDOWS)
+        auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return std::nullopt;
+        }
+        result.m_file = file;
+        auto size = LARGE_INTEGER{};
+        if (!GetFileSizeEx(file, &size))
+        {
+            return std::nullopt;
+        }
+        result.m_size = static_cast<std::size_t>(size.QuadPart);
+        if (result.m_size == 0)
+        {
+            return result;
+        }
+        result.m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!result.m_mapping)
+        {
+            return std::nullopt;
+        }
+        result.m_data = static_cast<const byte*>(MapViewOfFile(result.m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!result.m_data)
+        {
+            return std::nullopt;
+        }
+#else
+        const auto descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+        {
+            return std::nullopt;
+        }
+        struct stat status{};
+        if (fstat(descriptor, &status) != 0)
+        {
+            ::close(descriptor);
+            return std::nullopt;
+        }
+        result.m_size = static_cast<std::size_t>(status.st_size);
+        if (result.m_size > 0)
+        {
+            auto* mapping = mmap(nullptr, result.m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (mapping == MAP_FAILED)
+            {
+                ::close(descriptor);
+                return std::nullopt;
+            }
+            result.m_data = static_cast<const byte*>(mapping);
+        }
+        // the mapping keeps the file alive on its own
+        ::close(descriptor);
+#endif
+        return result;
+    }
+
+    auto mapped_file::close() noexcept -> void
+    {
+#if defined(FAE_PLATFORM_WEB)
+        m_storage.clear();
+#elif defined(FAE_PLATFORM_WINDOWS)
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+        }
+        if (m_file)
+        {
+            CloseHandle(m_file);
+        }
+        m_mapping = nullptr;
+        m_file = nullptr;
+#else
+        if (m_data)
+        {
+            munmap(const_cast<byte*>(m_data), m_size);
+        }
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
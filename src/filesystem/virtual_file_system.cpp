@@ -0,0 +1,164 @@
+#include "fae/filesystem/virtual_file_system.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <system_error>
+
+#include "fae/logging.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        /* the path relative to the mount point, or nothing if the mount point is not one of its parents */
+        auto relative_to_mount(std::string_view path, std::string_view mount_point) -> std::optional<std::string_view>
+        {
+            if (mount_point.empty())
+            {
+                return path;
+            }
+            if (!path.starts_with(mount_point))
+            {
+                return std::nullopt;
+            }
+            path.remove_prefix(mount_point.size());
+            if (path.empty())
+            {
+                return path;
+            }
+            if (path.front() != '/')
+            {
+                return std::nullopt;
+            }
+            path.remove_prefix(1);
+            return path;
+        }
+
+        auto read_from_disk(const std::filesystem::path& path) -> std::optional<file_contents>
+        {
+            auto file = std::ifstream(path, std::ios::binary | std::ios::ate);
+            if (!file.is_open())
+            {
+                return std::nullopt;
+            }
+            auto result = file_contents{ .storage = std::vector<byte>(static_cast<std::size_t>(file.tellg())) };
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(result.storage.data()), static_cast<std::streamsize>(result.storage.size()));
+            return result;
+        }
+    }
+
+    auto virtual_file_system::mount_directory(std::string_view mount_point, const std::filesystem::path& directory, int priority) -> void
+    {
+        add_mount(mount{
+            .point = normalize_asset_path(mount_point),
+            .priority = priority,
+            .source = directory,
+        });
+    }
+
+    auto virtual_file_system::mount_archive(std::string_view mount_point, const std::filesystem::path& archive_path, int priority) -> bool
+    {
+        auto maybe_archive = archive::open(archive_path);
+        if (!maybe_archive)
+        {
+            return false;
+        }
+        add_mount(mount{
+            .point = normalize_asset_path(mount_point),
+            .priority = priority,
+            .source = std::move(*maybe_archive),
+        });
+        return true;
+    }
+
+    auto virtual_file_system::unmount(std::string_view mount_point) -> void
+    {
+        const auto point = normalize_asset_path(mount_point);
+        std::erase_if(m_mounts, [&](const mount& mount)
+            { return mount.point == point; });
+    }
+
+    auto virtual_file_system::exists(const std::filesystem::path& path) const -> bool
+    {
+        if (path.is_absolute())
+        {
+            auto error = std::error_code{};
+            return std::filesystem::is_regular_file(path, error);
+        }
+        const auto normalized = normalize_asset_path(path);
+        for (const auto& mount : m_mounts)
+        {
+            const auto relative = relative_to_mount(normalized, mount.point);
+            if (!relative)
+            {
+                continue;
+            }
+            if (const auto* directory = std::get_if<std::filesystem::path>(&mount.source))
+            {
+                auto error = std::error_code{};
+                if (std::filesystem::is_regular_file(*directory / *relative, error))
+                {
+                    return true;
+                }
+            }
+            else if (std::get<archive>(mount.source).find(*relative))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto virtual_file_system::read(const std::filesystem::path& path) const -> std::optional<file_contents>
+    {
+        if (path.is_absolute())
+        {
+            return read_from_disk(path);
+        }
+        const auto normalized = normalize_asset_path(path);
+        for (const auto& mount : m_mounts)
+        {
+            const auto relative = relative_to_mount(normalized, mount.point);
+            if (!relative)
+            {
+                continue;
+            }
+
+            if (const auto* directory = std::get_if<std::filesystem::path>(&mount.source))
+            {
+                if (auto result = read_from_disk(*directory / *relative))
+                {
+                    return result;
+                }
+                continue;
+            }
+
+            const auto& mounted_archive = std::get<archive>(mount.source);
+            const auto* entry = mounted_archive.find(*relative);
+            if (!entry)
+            {
+                continue;
+            }
+            if (entry->compression == archive_compression::none)
+            {
+                return file_contents{ .view = mounted_archive.stored_data(*entry) };
+            }
+            auto decompressed = mounted_archive.read(*entry);
+            if (!decompressed)
+            {
+                return std::nullopt;
+            }
+            return file_contents{ .storage = std::move(*decompressed) };
+        }
+        return std::nullopt;
+    }
+
+    auto virtual_file_system::add_mount(mount&& mount) -> void
+    {
+        // before the first mount of lower or equal priority, so newer mounts shadow older ones
+        auto it = std::ranges::find_if(m_mounts, [&](const auto& existing)
+            { return existing.priority <= mount.priority; });
+        m_mounts.insert(it, std::move(mount));
+    }
+}
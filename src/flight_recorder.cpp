@@ -0,0 +1,442 @@
+#include "fae/flight_recorder.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "fae/allocation_tracker.hpp"
+#include "fae/application/application.hpp"
+#include "fae/logging.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        std::atomic<std::uint64_t> frame_draws = 0;
+        std::atomic<std::uint64_t> frame_uploaded_bytes = 0;
+
+        [[nodiscard]] auto to_milliseconds(std::chrono::nanoseconds time) noexcept -> double
+        {
+            return std::chrono::duration<double, std::milli>(time).count();
+        }
+
+        [[nodiscard]] auto json_string(std::string_view text) -> std::string
+        {
+            auto result = std::string("\"");
+            for (const auto c : text)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    result += '\\';
+                    result += c;
+                }
+                else if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    result += std::format("\\u{:04x}", static_cast<unsigned int>(c));
+                }
+                else
+                {
+                    result += c;
+                }
+            }
+            result += '"';
+            return result;
+        }
+
+        /* names may hold commas (template arguments), quoted with quotes doubled */
+        [[nodiscard]] auto csv_string(std::string_view text) -> std::string
+        {
+            auto result = std::string("\"");
+            for (const auto c : text)
+            {
+                if (c == '"')
+                {
+                    result += '"';
+                }
+                result += c;
+            }
+            result += '"';
+            return result;
+        }
+
+        [[nodiscard]] auto recorded_count(const std::atomic<std::uint32_t>& count, std::size_t capacity) noexcept -> std::size_t
+        {
+            return std::min<std::size_t>(count.load(std::memory_order_relaxed), capacity);
+        }
+
+        auto write_json(std::ofstream& file, duration budget, std::span<const flight_recorder::frame* const> frames, std::uint64_t hitch) -> void
+        {
+            file << std::format(R"({{"budget_ms":{:.3f},"hitch_frame":{},"frames":[)", to_milliseconds(budget.nanoseconds()), hitch);
+            for (std::size_t i = 0; i < frames.size(); ++i)
+            {
+                const auto& frame = *frames[i];
+                file << (i > 0 ? ",\n" : "\n");
+                file << std::format(R"({{"frame":{},"time_ms":{:.3f},"draws":{},"uploaded_bytes":{},"allocations":{},"allocated_bytes":{},"steps":[)",
+                    frame.index, to_milliseconds(frame.time.nanoseconds()), frame.draws, frame.uploaded_bytes, frame.allocations, frame.allocated_bytes);
+                for (std::size_t j = 0; j < recorded_count(frame.step_count, frame.steps.size()); ++j)
+                {
+                    file << std::format(R"({}{{"name":{},"ms":{:.3f}}})", j > 0 ? "," : "", json_string(frame.steps[j].zone->name), to_milliseconds(frame.steps[j].time));
+                }
+                file << R"(],"systems":[)";
+                for (std::size_t j = 0; j < recorded_count(frame.system_count, frame.systems.size()); ++j)
+                {
+                    file << std::format(R"({}{{"name":{},"ms":{:.3f}}})", j > 0 ? "," : "", json_string(frame.systems[j].zone->name), to_milliseconds(frame.systems[j].time));
+                }
+                file << "]}";
+            }
+            file << "\n]}\n";
+        }
+
+        /* one value per row, frame,category,name,value */
+        auto write_csv(std::ofstream& file, std::span<const flight_recorder::frame* const> frames) -> void
+        {
+            file << "frame,category,name,value\n";
+            for (const auto* frame : frames)
+            {
+                file << std::format("{},frame_ms,,{:.3f}\n", frame->index, to_milliseconds(frame->time.nanoseconds()));
+                file << std::format("{},draws,,{}\n", frame->index, frame->draws);
+                file << std::format("{},uploaded_bytes,,{}\n", frame->index, frame->uploaded_bytes);
+                file << std::format("{},allocations,,{}\n", frame->index, frame->allocations);
+                file << std::format("{},allocated_bytes,,{}\n", frame->index, frame->allocated_bytes);
+                for (std::size_t j = 0; j < recorded_count(frame->step_count, frame->steps.size()); ++j)
+                {
+                    file << std::format("{},step_ms,{},{:.3f}\n", frame->index, csv_string(frame->steps[j].zone->name), to_milliseconds(frame->steps[j].time));
+                }
+                for (std::size_t j = 0; j < recorded_count(frame->system_count, frame->systems.size()); ++j)
+                {
+                    file << std::format("{},system_ms,{},{:.3f}\n", frame->index, csv_string(frame->systems[j].zone->name), to_milliseconds(frame->systems[j].time));
+                }
+            }
+        }
+
+        auto write_frames(const std::filesystem::path& path, flight_recorder_format format, duration budget, std::span<const flight_recorder::frame* const> frames, std::uint64_t hitch) -> bool
+        {
+            auto file = std::ofstream(path, std::ios::trunc);
+            if (!file.is_open())
+            {
+                fae::log_error("failed to write flight recorder dump {}", path.string());
+                return false;
+            }
+            if (format == flight_recorder_format::json)
+            {
+                write_json(file, budget, frames, hitch);
+            }
+            else
+            {
+                write_csv(file, frames);
+            }
+            return file.good();
+        }
+
+        /* the frame being recorded is left out, it is not complete (& its slot is reused from the oldest frame) */
+        [[nodiscard]] auto complete_frame_count(const flight_recorder& recorder) noexcept -> std::size_t
+        {
+            return static_cast<std::size_t>(std::min<std::uint64_t>(recorder.frame_index, recorder.frames.size() - 1));
+        }
+
+        /* frames hold atomics, so they are copied field by field (& only the recorded timings) */
+        auto copy_frame(const flight_recorder::frame& from, flight_recorder::frame& to) noexcept -> void
+        {
+            to.index = from.index;
+            to.time = from.time;
+            to.draws = from.draws;
+            to.uploaded_bytes = from.uploaded_bytes;
+            to.allocations = from.allocations;
+            to.allocated_bytes = from.allocated_bytes;
+            const auto step_count = recorded_count(from.step_count, from.steps.size());
+            const auto system_count = recorded_count(from.system_count, from.systems.size());
+            to.step_count.store(static_cast<std::uint32_t>(step_count), std::memory_order_relaxed);
+            to.system_count.store(static_cast<std::uint32_t>(system_count), std::memory_order_relaxed);
+            std::copy_n(from.steps.begin(), step_count, to.steps.begin());
+            std::copy_n(from.systems.begin(), system_count, to.systems.begin());
+        }
+    }
+
+    struct flight_recorder::dump_writer::state
+    {
+        std::mutex mutex;
+        std::condition_variable dump_ready;
+        std::condition_variable dump_done;
+        /* the copied frames, oldest first, sized for the ring by the first dump */
+        std::vector<frame> frames;
+        std::size_t frame_count = 0;
+        std::filesystem::path path;
+        flight_recorder_format format = flight_recorder_format::json;
+        duration budget{};
+        std::uint64_t hitch = 0;
+        bool busy = false;
+        bool stopping = false;
+        std::thread thread;
+
+        auto write() -> void
+        {
+            auto ordered = std::vector<const frame*>{};
+            ordered.reserve(frame_count);
+            auto hitch_time = duration{};
+            for (std::size_t i = 0; i < frame_count; ++i)
+            {
+                ordered.push_back(&frames[i]);
+                if (frames[i].index == hitch)
+                {
+                    hitch_time = frames[i].time;
+                }
+            }
+            auto error = std::error_code{};
+            std::filesystem::create_directories(path.parent_path(), error);
+            if (write_frames(path, format, budget, ordered, hitch))
+            {
+                fae::log_warning("frame {} took {:.3f}ms (budget {:.3f}ms), wrote the frames around it to {}", hitch,
+                    to_milliseconds(hitch_time.nanoseconds()), to_milliseconds(budget.nanoseconds()), path.string());
+            }
+        }
+
+        auto run() -> void
+        {
+            auto lock = std::unique_lock(mutex);
+            while (true)
+            {
+                dump_ready.wait(lock, [&]
+                    { return busy || stopping; });
+                if (!busy)
+                {
+                    return;
+                }
+                // the frames are not touched by try_write while busy
+                lock.unlock();
+                write();
+                lock.lock();
+                busy = false;
+                dump_done.notify_all();
+            }
+        }
+    };
+
+    flight_recorder::dump_writer::dump_writer() noexcept = default;
+
+    flight_recorder::dump_writer::dump_writer(dump_writer&&) noexcept = default;
+
+    auto flight_recorder::dump_writer::operator=(dump_writer&& other) noexcept -> dump_writer&
+    {
+        if (this != &other)
+        {
+            stop();
+            m_state = std::move(other.m_state);
+        }
+        return *this;
+    }
+
+    flight_recorder::dump_writer::~dump_writer()
+    {
+        stop();
+    }
+
+    auto flight_recorder::dump_writer::stop() noexcept -> void
+    {
+        if (!m_state || !m_state->thread.joinable())
+        {
+            return;
+        }
+        {
+            auto lock = std::scoped_lock(m_state->mutex);
+            m_state->stopping = true;
+        }
+        m_state->dump_ready.notify_all();
+        // run() finishes the dump being written before it sees stopping
+        m_state->thread.join();
+    }
+
+    auto flight_recorder::dump_writer::try_write(const flight_recorder& recorder, std::filesystem::path path, std::uint64_t hitch) -> bool
+    {
+        if (!m_state)
+        {
+            m_state = std::make_unique<state>();
+#ifndef FAE_PLATFORM_WEB
+            m_state->thread = std::thread([state = m_state.get()]
+                { state->run(); });
+#endif
+        }
+        auto& state = *m_state;
+        auto lock = std::unique_lock(state.mutex);
+        if (state.busy)
+        {
+            return false;
+        }
+        const auto count = complete_frame_count(recorder);
+        if (state.frames.size() < count)
+        {
+            // sized in place, frames hold atomics & are never moved
+            state.frames = std::vector<frame>(recorder.frames.size());
+        }
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            copy_frame(recorder.frames[(recorder.frame_index - count + i) % recorder.frames.size()], state.frames[i]);
+        }
+        state.frame_count = count;
+        state.path = std::move(path);
+        state.format = recorder.format;
+        state.budget = recorder.budget;
+        state.hitch = hitch;
+        if (!state.thread.joinable())
+        {
+            lock.unlock();
+            state.write();
+            return true;
+        }
+        state.busy = true;
+        lock.unlock();
+        state.dump_ready.notify_one();
+        return true;
+    }
+
+    auto flight_recorder::dump_writer::wait() -> void
+    {
+        if (!m_state || !m_state->thread.joinable())
+        {
+            return;
+        }
+        auto lock = std::unique_lock(m_state->mutex);
+        m_state->dump_done.wait(lock, [&]
+            { return !m_state->busy; });
+    }
+
+    auto count_frame_draws(std::uint64_t count) noexcept -> void
+    {
+        frame_draws.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    auto count_frame_uploaded_bytes(std::uint64_t bytes) noexcept -> void
+    {
+        frame_uploaded_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    auto flight_recorder::record_step(const profile_zone& step, std::chrono::nanoseconds time) noexcept -> void
+    {
+        if (frames.empty())
+        {
+            return;
+        }
+        auto& frame = frames[frame_index % frames.size()];
+        const auto slot = frame.step_count.fetch_add(1, std::memory_order_relaxed);
+        if (slot < frame.steps.size())
+        {
+            frame.steps[slot] = timing{ .zone = &step, .time = time };
+        }
+    }
+
+    auto flight_recorder::record_system(const profile_zone& system, std::chrono::nanoseconds time) noexcept -> void
+    {
+        if (frames.empty())
+        {
+            return;
+        }
+        auto& frame = frames[frame_index % frames.size()];
+        const auto slot = frame.system_count.fetch_add(1, std::memory_order_relaxed);
+        if (slot < frame.systems.size())
+        {
+            frame.systems[slot] = timing{ .zone = &system, .time = time };
+        }
+    }
+
+    auto flight_recorder::end_frame(std::uint64_t allocations, std::uint64_t allocated_bytes) noexcept -> void
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (frames.empty())
+        {
+            return;
+        }
+        auto& frame = frames[frame_index % frames.size()];
+        frame.index = frame_index;
+        frame.time = frame_start == std::chrono::steady_clock::time_point{} ? duration{} : duration{ std::chrono::duration_cast<std::chrono::nanoseconds>(now - frame_start) };
+        frame.draws = frame_draws.exchange(0, std::memory_order_relaxed);
+        frame.uploaded_bytes = frame_uploaded_bytes.exchange(0, std::memory_order_relaxed);
+        frame.allocations = allocations;
+        frame.allocated_bytes = allocated_bytes;
+
+        if (frame.time > budget && !is_dump_frame)
+        {
+            ++hitches;
+            if (pending_dump_frame == 0 && dumps < max_dumps)
+            {
+                // a later hitch in the window is part of the same dump
+                pending_hitch = frame_index;
+                // the hitch must still be in the ring when the dump is written
+                pending_dump_frame = frame_index + std::min<std::uint64_t>(frames_after_hitch, frames.size() - 2);
+            }
+        }
+        is_dump_frame = false;
+        ++frame_index;
+
+        if (pending_dump_frame != 0 && frame_index > pending_dump_frame)
+        {
+            const auto path = directory / std::format("hitch_{}.{}", pending_hitch, format == flight_recorder_format::json ? "json" : "csv");
+            if (writer.try_write(*this, path, pending_hitch))
+            {
+                ++dumps;
+                is_dump_frame = true;
+            }
+            else
+            {
+                fae::log_warning("frame {} took {:.3f}ms (budget {:.3f}ms), not dumped while the last dump is still being written", pending_hitch,
+                    to_milliseconds(frames[pending_hitch % frames.size()].time.nanoseconds()), to_milliseconds(budget.nanoseconds()));
+            }
+            pending_hitch = 0;
+            pending_dump_frame = 0;
+        }
+
+        auto& next = frames[frame_index % frames.size()];
+        next.step_count.store(0, std::memory_order_relaxed);
+        next.system_count.store(0, std::memory_order_relaxed);
+        frame_start = now;
+    }
+
+    auto flight_recorder::write(const std::filesystem::path& path, flight_recorder_format file_format, std::uint64_t hitch) const -> bool
+    {
+        const auto count = complete_frame_count(*this);
+        auto ordered = std::vector<const frame*>{};
+        ordered.reserve(count);
+        for (auto index = frame_index - count; index < frame_index; ++index)
+        {
+            ordered.push_back(&frames[index % frames.size()]);
+        }
+        return write_frames(path, file_format, budget, ordered, hitch);
+    }
+
+    auto flight_recorder::wait_for_dumps() -> void
+    {
+        writer.wait();
+    }
+
+    auto flight_recorder_plugin::init(application& app) const noexcept -> void
+    {
+        app.set_global_component<flight_recorder>(flight_recorder{
+            .budget = budget,
+            .frames_after_hitch = frames_after_hitch,
+            .directory = directory,
+            .format = format,
+            .max_dumps = max_dumps,
+        });
+        auto* recorder = app.ecs_world.resources.get<flight_recorder>();
+        // sized in place, frames hold atomics & are never moved
+        recorder->frames = std::vector<flight_recorder::frame>(std::max<std::size_t>(frame_count, 2));
+        app.scheduler.set_flight_recorder(recorder);
+        app.add_system<pre_update_step>(record_flight_frame);
+    }
+
+    auto record_flight_frame(const pre_update_step& step) noexcept -> void
+    {
+        auto* recorder = step.ecs_world.resources.get<flight_recorder>();
+        if (!recorder)
+        {
+            return;
+        }
+        const auto* report = step.ecs_world.resources.get<allocation_report>();
+        recorder->end_frame(report ? report->total.allocations : 0, report ? report->total.bytes : 0);
+    }
+}
@@ -0,0 +1,52 @@
+#include "fae/frame_arena.hpp"
+
+namespace fae
+{
+    auto frame_arena::for_thread(std::size_t slot) -> linear_arena&
+    {
+        struct cached_arena
+        {
+            std::uint64_t owner = 0;
+            std::uint64_t frame = 0;
+            std::size_t slot = 0;
+            linear_arena* arena = nullptr;
+        };
+        // the arena a thread used last, valid as long as it is the same frame of the same frame arena
+        thread_local auto cached = cached_arena{};
+        const auto frame = m_frame.load(std::memory_order_acquire);
+        if (cached.arena && cached.owner == m_id.get() && cached.frame == frame && cached.slot == slot)
+        {
+            return *cached.arena;
+        }
+
+        auto lock = std::scoped_lock(m_mutex);
+        auto& arenas = current_arenas();
+        while (slot >= arenas.size())
+        {
+            arenas.push_back(std::make_unique<linear_arena>());
+        }
+        cached = cached_arena{ .owner = m_id.get(), .frame = frame, .slot = slot, .arena = arenas[slot].get() };
+        return *arenas[slot];
+    }
+
+    auto frame_arena::next_frame() -> void
+    {
+        auto lock = std::scoped_lock(m_mutex);
+        m_frame.fetch_add(1, std::memory_order_acq_rel);
+        for (auto& arena : current_arenas())
+        {
+            arena->reset();
+        }
+    }
+
+    auto frame_arena::bytes_used() -> std::size_t
+    {
+        auto lock = std::scoped_lock(m_mutex);
+        std::size_t total = 0;
+        for (const auto& arena : current_arenas())
+        {
+            total += arena->bytes_used();
+        }
+        return total;
+    }
+}
@@ -0,0 +1,223 @@
+#include "fae/job_system.hpp"
+
+#include <algorithm>
+
+#if defined(FAE_PLATFORM_WINDOWS)
+#include <Windows.h>
+#elif defined(FAE_PLATFORM_LINUX) || defined(FAE_PLATFORM_ANDROID)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace fae
+{
+    namespace
+    {
+        thread_local const job_system* current_job_system = nullptr;
+        thread_local std::size_t current_worker_index = 0;
+
+        auto pin_to_core(std::jthread& thread, std::size_t core) -> void
+        {
+            const auto core_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+            core %= core_count;
+#if defined(FAE_PLATFORM_WINDOWS)
+            SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{ 1 } << (core % (sizeof(DWORD_PTR) * 8)));
+#elif defined(FAE_PLATFORM_LINUX) || defined(FAE_PLATFORM_ANDROID)
+            auto cores = cpu_set_t{};
+            CPU_ZERO(&cores);
+            CPU_SET(core, &cores);
+            pthread_setaffinity_np(thread.native_handle(), sizeof(cores), &cores);
+#else
+            // no affinity api (macos only has hints, the web has no threads)
+            static_cast<void>(thread);
+            static_cast<void>(core);
+#endif
+        }
+    }
+
+    job_system::job_system(job_system_settings settings) : m_settings(settings)
+    {
+        start();
+    }
+
+    job_system::~job_system()
+    {
+        stop();
+    }
+
+    auto job_system::configure(job_system_settings settings) -> void
+    {
+        stop();
+        m_settings = settings;
+        start();
+    }
+
+    auto job_system::settings() const noexcept -> const job_system_settings&
+    {
+        return m_settings;
+    }
+
+    auto job_system::worker_count() const noexcept -> std::size_t
+    {
+        return m_workers.size();
+    }
+
+    auto job_system::current_thread_slot() const noexcept -> std::size_t
+    {
+        return current_queue_index();
+    }
+
+    auto job_system::wait(job_counter& counter) -> void
+    {
+        while (true)
+        {
+            // read before checking the counter, so a job finishing in between is not slept through
+            const auto finished = m_finished.load();
+            if (counter.is_done())
+            {
+                return;
+            }
+            if (!run_one())
+            {
+                // the jobs left are running on other threads, sleep until one of them finishes
+                m_finished.wait(finished);
+            }
+        }
+    }
+
+    auto job_system::start() -> void
+    {
+        m_stopping = false;
+        m_queued = 0;
+        m_queues.clear();
+        for (std::size_t i = 0; i <= m_settings.worker_count; ++i)
+        {
+            m_queues.push_back(std::make_unique<queue>());
+        }
+        m_workers.reserve(m_settings.worker_count);
+        for (std::size_t i = 0; i < m_settings.worker_count; ++i)
+        {
+            m_workers.emplace_back([this, i]
+                { work(i); });
+            if (m_settings.pin_workers)
+            {
+                pin_to_core(m_workers.back(), i + 1);
+            }
+        }
+    }
+
+    auto job_system::stop() -> void
+    {
+        m_stopping = true;
+        m_queued.fetch_add(1);
+        m_queued.notify_all();
+        m_workers.clear();
+    }
+
+    auto job_system::push(job&& job) -> void
+    {
+        job.counter->pending.fetch_add(1, std::memory_order_relaxed);
+        auto& target = *m_queues[current_queue_index()];
+        {
+            auto lock = std::scoped_lock(target.mutex);
+            target.jobs.push_back(job);
+        }
+        m_queued.fetch_add(1, std::memory_order_release);
+        m_queued.notify_one();
+    }
+
+    auto job_system::pop(std::size_t queue_index) -> std::optional<job>
+    {
+        auto& source = *m_queues[queue_index];
+        auto lock = std::scoped_lock(source.mutex);
+        if (source.jobs.empty())
+        {
+            return std::nullopt;
+        }
+        // workers take their newest job, the shared queue is first in first out
+        const auto is_shared = queue_index == m_queues.size() - 1;
+        auto result = is_shared ? source.jobs.front() : source.jobs.back();
+        if (is_shared)
+        {
+            source.jobs.pop_front();
+        }
+        else
+        {
+            source.jobs.pop_back();
+        }
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return result;
+    }
+
+    auto job_system::steal(std::size_t thief_index) -> std::optional<job>
+    {
+        const auto queue_count = m_queues.size();
+        for (std::size_t offset = 1; offset < queue_count; ++offset)
+        {
+            auto& victim = *m_queues[(thief_index + offset) % queue_count];
+            auto lock = std::scoped_lock(victim.mutex);
+            if (victim.jobs.empty())
+            {
+                continue;
+            }
+            // the oldest job of a worker is the biggest half of its range
+            auto result = victim.jobs.front();
+            victim.jobs.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return result;
+        }
+        return std::nullopt;
+    }
+
+    auto job_system::current_queue_index() const noexcept -> std::size_t
+    {
+        return current_job_system == this ? current_worker_index : m_queues.size() - 1;
+    }
+
+    auto job_system::run_one() -> bool
+    {
+        const auto index = current_queue_index();
+        auto maybe_job = pop(index);
+        if (!maybe_job)
+        {
+            maybe_job = steal(index);
+        }
+        if (!maybe_job)
+        {
+            return false;
+        }
+        execute(*maybe_job);
+        return true;
+    }
+
+    auto job_system::execute(job job) -> void
+    {
+        while (job.end - job.begin > job.grain)
+        {
+            const auto middle = job.begin + (job.end - job.begin) / 2;
+            auto upper_half = job;
+            upper_half.begin = middle;
+            push(std::move(upper_half));
+            job.end = middle;
+        }
+        job.invoke(job.context, job.begin, job.end);
+        job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+        // the counter may be gone as soon as it reaches zero, waiters are woken through the job system instead
+        m_finished.fetch_add(1);
+        m_finished.notify_all();
+    }
+
+    auto job_system::work(std::size_t worker_index) -> void
+    {
+        current_job_system = this;
+        current_worker_index = worker_index;
+        while (!m_stopping.load(std::memory_order_acquire))
+        {
+            if (run_one())
+            {
+                continue;
+            }
+            m_queued.wait(0, std::memory_order_acquire);
+        }
+    }
+}
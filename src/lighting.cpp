@@ -6,19 +6,30 @@ namespace fae
 {
     auto lighting_plugin::init(application& app) const noexcept -> void
     {
+        app.ecs_world.track_changes<ambient_light, directional_light>();
         app
             .set_global_component(ambient_light_info{})
             .set_global_component(directional_light_info{})
-            .add_system<update_step>(update_lighting);
+            .add_system<update_step>(update_lighting,
+                system_access{}
+                    .reads<ambient_light, directional_light>()
+                    .writes_resource<ambient_light_info, directional_light_info>(),
+                run_condition{}.when_changed<ambient_light, directional_light>());
     }
 
     auto update_lighting(const update_step& step) noexcept -> void
     {
+        // only runs when a light was added, changed or removed, the checks below skip the kind of light that did not change
+        auto& world = step.ecs_world;
         step.global_entity.use_component<ambient_light_info>([&](ambient_light_info& info)
             {
+                if (world.registry.storage<ambient_light>().size() == info.lights.count && world.view<const ambient_light>(changed<ambient_light>{}).empty())
+                {
+                    return;
+                }
                 info.clear();
                 auto i = 0;
-                for (auto& [entity, ambient_light] : step.ecs_world.query<const ambient_light>())
+                for (auto [entity, ambient_light] : world.view<const ambient_light>())
                 {
                     info.lights.colors[i] = ambient_light.color.to_vec4();
                     i++;
@@ -27,9 +38,13 @@ namespace fae
 
         step.global_entity.use_component<directional_light_info>([&](directional_light_info& info)
             {
+                if (world.registry.storage<directional_light>().size() == info.lights.count && world.view<const directional_light>(changed<directional_light>{}).empty())
+                {
+                    return;
+                }
                 info.clear();
                 auto i = 0;
-                for (auto& [entity, directional_light] : step.ecs_world.query<const directional_light>())
+                for (auto [entity, directional_light] : world.view<const directional_light>())
                 {
                     info.directions[i] = { directional_light.direction, 0.f };
                     info.lights.colors[i] = directional_light.color.to_vec4();
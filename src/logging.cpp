@@ -0,0 +1,327 @@
+#include "fae/logging.hpp"
+
+#include <cstdlib>
+#include <iterator>
+#include <print>
+#include <string>
+
+#ifndef FAE_PLATFORM_WEB
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "fae/allocation_tracker.hpp"
+#endif
+
+namespace fae
+{
+    namespace
+    {
+        auto write_log_record(const detail::log_record& record, std::string& line) noexcept -> void
+        {
+            line.clear();
+            auto out = std::back_inserter(line);
+            if (record.show_time)
+            {
+                std::format_to(out, "[{}] ", record.time);
+            }
+            if (record.show_source_location)
+            {
+                std::format_to(out, "[{}:{}] ", record.file, record.line);
+            }
+            if (record.show_level)
+            {
+                std::format_to(out, "[{}] ", record.level);
+            }
+            const auto* bytes = reinterpret_cast<const std::byte*>(&record);
+            record.format_arguments(record.format, bytes + sizeof(detail::log_record) + record.stacktrace_size, line);
+            if (record.stacktrace_size > 0)
+            {
+                line += '\n';
+                line.append(reinterpret_cast<const char*>(bytes + sizeof(detail::log_record)), record.stacktrace_size);
+            }
+            std::println("{}", line);
+        }
+
+        /* records written on the calling thread instead of queued, see reserve_log_record */
+        thread_local std::byte* synchronous_record = nullptr;
+
+#ifndef FAE_PLATFORM_WEB
+        constexpr std::size_t log_queue_capacity = 64 * 1024;
+        /* bigger records (long messages or stack traces) are written synchronously */
+        constexpr std::size_t max_queued_record_size = log_queue_capacity / 4;
+        constexpr auto log_write_interval = std::chrono::milliseconds(2);
+
+        /*
+        byte ring of log records, written only by its thread & read only by the logging thread, so it needs no locks
+        positions only grow, the offset in data is position % capacity
+        a record that doesn't fit before the end of data starts at the beginning, the end is skipped
+        */
+        struct log_queue
+        {
+            alignas(64) std::atomic<std::uint64_t> head = 0;
+            alignas(64) std::atomic<std::uint64_t> tail = 0;
+            /* set when its thread exits, the logging thread frees it once empty */
+            std::atomic<bool> is_orphaned = false;
+            /* producer only, end of the record being written */
+            std::uint64_t reserved = 0;
+            alignas(64) std::array<std::byte, log_queue_capacity> data{};
+
+            [[nodiscard]] auto try_reserve(std::size_t size) noexcept -> std::byte*
+            {
+                auto position = head.load(std::memory_order_relaxed);
+                const auto offset = position % log_queue_capacity;
+                const auto skipped = log_queue_capacity - offset < size ? log_queue_capacity - offset : 0;
+                if (log_queue_capacity - (position - tail.load(std::memory_order_acquire)) < skipped + size)
+                {
+                    return nullptr;
+                }
+                if (skipped >= sizeof(detail::log_record))
+                {
+                    ::new (static_cast<void*>(data.data() + offset)) detail::log_record{
+                        .size = static_cast<std::uint32_t>(skipped),
+                        .is_padding = true,
+                    };
+                }
+                position += skipped;
+                reserved = position + size;
+                return data.data() + position % log_queue_capacity;
+            }
+
+            auto commit() noexcept -> void
+            {
+                head.store(reserved, std::memory_order_release);
+            }
+
+            /* writes the records committed so far, logging thread only */
+            auto drain(std::string& line) noexcept -> void
+            {
+                auto position = tail.load(std::memory_order_relaxed);
+                const auto end = head.load(std::memory_order_acquire);
+                while (position != end)
+                {
+                    const auto offset = position % log_queue_capacity;
+                    if (log_queue_capacity - offset < sizeof(detail::log_record))
+                    {
+                        // too short for a padding record
+                        position += log_queue_capacity - offset;
+                        continue;
+                    }
+                    const auto& record = *std::launder(reinterpret_cast<const detail::log_record*>(data.data() + offset));
+                    if (!record.is_padding)
+                    {
+                        write_log_record(record, line);
+                    }
+                    position += record.size;
+                    // released per record so a waiting thread can go on as soon as possible
+                    tail.store(position, std::memory_order_release);
+                }
+            }
+
+            [[nodiscard]] auto is_empty() const noexcept -> bool
+            {
+                return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+            }
+        };
+
+        /* the queues of every thread that logged & the thread that writes them, created by the first log & never destroyed (threads may log until exit) */
+        struct logger
+        {
+            std::mutex queues_mutex;
+            std::vector<std::unique_ptr<log_queue>> queues;
+            /* copy of queues, so they are drained without holding queues_mutex */
+            std::vector<log_queue*> draining;
+
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable drained;
+            bool is_wake_requested = false;
+            std::uint64_t drain_count = 0;
+
+            /* held while writing, synchronous records are written next to the logging thread's */
+            std::mutex output_mutex;
+            std::string line;
+
+            logger()
+            {
+                std::thread([this]
+                    { run(); })
+                    .detach();
+                std::atexit(flush_logs);
+            }
+
+            [[nodiscard]] auto add_queue() -> log_queue*
+            {
+                auto lock = std::scoped_lock(queues_mutex);
+                return queues.emplace_back(std::make_unique<log_queue>()).get();
+            }
+
+            auto wake_up() noexcept -> void
+            {
+                {
+                    auto lock = std::scoped_lock(mutex);
+                    is_wake_requested = true;
+                }
+                wake.notify_one();
+            }
+
+            auto flush() noexcept -> void
+            {
+                auto lock = std::unique_lock(mutex);
+                // a drain in progress may have passed the calling thread's queue already, the one after it can't have
+                const auto target = drain_count + 2;
+                is_wake_requested = true;
+                wake.notify_one();
+                drained.wait(lock, [&]
+                    { return drain_count >= target; });
+            }
+
+            auto run() noexcept -> void
+            {
+                [[maybe_unused]] auto allocations = allocation_scope("logging");
+                while (true)
+                {
+                    {
+                        auto lock = std::unique_lock(mutex);
+                        wake.wait_for(lock, log_write_interval, [&]
+                            { return is_wake_requested; });
+                        is_wake_requested = false;
+                    }
+                    {
+                        auto lock = std::scoped_lock(queues_mutex);
+                        draining.clear();
+                        for (const auto& queue : queues)
+                        {
+                            draining.push_back(queue.get());
+                        }
+                    }
+                    {
+                        auto lock = std::scoped_lock(output_mutex);
+                        for (auto* queue : draining)
+                        {
+                            queue->drain(line);
+                        }
+                    }
+                    {
+                        // orphaned is read first, its thread committed everything before setting it
+                        auto lock = std::scoped_lock(queues_mutex);
+                        std::erase_if(queues, [](const std::unique_ptr<log_queue>& queue)
+                            { return queue->is_orphaned.load(std::memory_order_acquire) && queue->is_empty(); });
+                    }
+                    {
+                        auto lock = std::scoped_lock(mutex);
+                        ++drain_count;
+                    }
+                    drained.notify_all();
+                }
+            }
+        };
+
+        std::atomic<logger*> logger_instance = nullptr;
+
+        [[nodiscard]] auto get_logger() -> logger&
+        {
+            static auto* instance = [] {
+                auto* created = new logger();
+                logger_instance.store(created, std::memory_order_release);
+                return created;
+            }();
+            return *instance;
+        }
+
+        thread_local log_queue* current_queue = nullptr;
+        /* set once the thread's queue was handed to the logging thread on exit, later logs (from thread_local destructors) are written synchronously */
+        thread_local bool is_queue_released = false;
+
+        struct log_queue_owner
+        {
+            ~log_queue_owner()
+            {
+                if (current_queue)
+                {
+                    current_queue->is_orphaned.store(true, std::memory_order_release);
+                }
+                current_queue = nullptr;
+                is_queue_released = true;
+            }
+        };
+
+        [[nodiscard]] auto this_thread_queue() -> log_queue*
+        {
+            if (!current_queue && !is_queue_released)
+            {
+                thread_local log_queue_owner owner;
+                current_queue = get_logger().add_queue();
+            }
+            return current_queue;
+        }
+#endif
+    }
+
+    auto flush_logs() noexcept -> void
+    {
+#ifndef FAE_PLATFORM_WEB
+        if (auto* instance = logger_instance.load(std::memory_order_acquire))
+        {
+            instance->flush();
+        }
+#endif
+    }
+
+    namespace detail
+    {
+        /* queued on native platforms, written synchronously on the web (no threads) & for records too big for a queue */
+        auto reserve_log_record(std::size_t size) noexcept -> std::byte*
+        {
+#ifndef FAE_PLATFORM_WEB
+            if (size <= max_queued_record_size)
+            {
+                if (auto* queue = this_thread_queue())
+                {
+                    auto* record = queue->try_reserve(size);
+                    while (!record)
+                    {
+                        // full, waits for the logging thread to write some of it
+                        get_logger().wake_up();
+                        std::this_thread::yield();
+                        record = queue->try_reserve(size);
+                    }
+                    return record;
+                }
+            }
+#endif
+            synchronous_record = static_cast<std::byte*>(std::malloc(size));
+            if (!synchronous_record)
+            {
+                std::abort();
+            }
+            return synchronous_record;
+        }
+
+        auto commit_log_record(std::byte* record) noexcept -> void
+        {
+            if (record != synchronous_record)
+            {
+#ifndef FAE_PLATFORM_WEB
+                current_queue->commit();
+#endif
+                return;
+            }
+            synchronous_record = nullptr;
+            auto line = std::string{};
+#ifndef FAE_PLATFORM_WEB
+            // after what this thread queued before it
+            flush_logs();
+            auto& instance = get_logger();
+            auto lock = std::scoped_lock(instance.output_mutex);
+#endif
+            write_log_record(*std::launder(reinterpret_cast<const log_record*>(record)), line);
+            std::free(record);
+        }
+    }
+}
@@ -0,0 +1,282 @@
+#include "fae/profiler.hpp"
+
+#include <deque>
+#include <format>
+#include <mutex>
+#include <unordered_map>
+
+#include "fae/logging.hpp"
+
+#ifdef FAE_PROFILE
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <vector>
+#endif
+
+#if !defined(FAE_PLATFORM_WEB) && __has_include(<dlfcn.h>) && __has_include(<cxxabi.h>)
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#define FAE_HAS_DLADDR
+#endif
+
+namespace fae
+{
+    namespace
+    {
+        /* zones named at runtime, deques so their addresses stay stable */
+        struct profile_zone_names
+        {
+            std::mutex mutex;
+            std::deque<std::string> names;
+            std::deque<profile_zone> zones;
+            /* interned zones of function_profile_zone */
+            std::unordered_map<const void*, const profile_zone*> functions;
+        };
+
+        [[nodiscard]] auto get_profile_zone_names() -> profile_zone_names&
+        {
+            // never destroyed, recorded zones point into it until exit
+            static auto* names = new profile_zone_names();
+            return *names;
+        }
+
+#ifdef FAE_PROFILE
+        constexpr std::size_t zones_per_thread = 64 * 1024;
+        /* the oldest zones of a ring may be overwritten while exporting, these are left out */
+        constexpr std::size_t overwrite_margin = 1024;
+
+        /* relaxed atomics, a zone is only ever written by its thread but may be read while exporting */
+        struct recorded_zone
+        {
+            std::atomic<const profile_zone*> zone = nullptr;
+            std::atomic<std::uint64_t> begin = 0;
+            std::atomic<std::uint64_t> end = 0;
+        };
+
+        /* ring of the latest zones of a thread, kept after the thread exits */
+        struct thread_profile
+        {
+            std::size_t index = 0;
+            std::atomic<std::uint64_t> written = 0;
+            /* zones before it were cleared */
+            std::atomic<std::uint64_t> cleared = 0;
+            std::array<recorded_zone, zones_per_thread> zones{};
+        };
+
+        struct profiler
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<thread_profile>> threads;
+            /* to convert timestamps to microseconds when exporting */
+            std::uint64_t start_timestamp = profile_timestamp();
+            std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        };
+
+        [[nodiscard]] auto get_profiler() -> profiler&
+        {
+            // never destroyed, threads may record zones until exit
+            static auto* instance = new profiler();
+            return *instance;
+        }
+
+        // created during static initialization instead of by the first zone, whose begin would be before start_timestamp
+        [[maybe_unused]] const auto& profiler_at_startup = get_profiler();
+
+        thread_local thread_profile* current_thread = nullptr;
+
+        [[nodiscard]] auto register_thread() -> thread_profile*
+        {
+            auto& instance = get_profiler();
+            auto lock = std::scoped_lock(instance.mutex);
+            auto& thread = instance.threads.emplace_back(std::make_unique<thread_profile>());
+            thread->index = instance.threads.size() - 1;
+            return thread.get();
+        }
+
+        auto write_json_string(std::ofstream& file, std::string_view text) -> void
+        {
+            file << '"';
+            for (const auto c : text)
+            {
+                switch (c)
+                {
+                case '"':
+                    file << "\\\"";
+                    break;
+                case '\\':
+                    file << "\\\\";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        file << std::format("\\u{:04x}", static_cast<unsigned int>(c));
+                    }
+                    else
+                    {
+                        file << c;
+                    }
+                    break;
+                }
+            }
+            file << '"';
+        }
+#endif
+    }
+
+    auto make_profile_zone(std::string name) -> const profile_zone&
+    {
+        auto& names = get_profile_zone_names();
+        auto lock = std::scoped_lock(names.mutex);
+        const auto& stored = names.names.emplace_back(std::move(name));
+        return names.zones.emplace_back(profile_zone{ .name = stored });
+    }
+
+    auto function_profile_zone(const void* address) -> const profile_zone&
+    {
+        auto& names = get_profile_zone_names();
+        {
+            auto lock = std::scoped_lock(names.mutex);
+            if (auto it = names.functions.find(address); it != names.functions.end())
+            {
+                return *it->second;
+            }
+        }
+        // named without the lock, looking symbols up is slow (two threads may name the same function, the first one is kept)
+        const auto& zone = make_profile_zone(describe_function_address(address));
+        auto lock = std::scoped_lock(names.mutex);
+        return *names.functions.try_emplace(address, &zone).first->second;
+    }
+
+    auto describe_function_address(const void* address) -> std::string
+    {
+#ifdef FAE_HAS_DLADDR
+        auto info = Dl_info{};
+        if (dladdr(address, &info) != 0 && info.dli_sname)
+        {
+            auto status = 0;
+            auto* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            auto name = std::string(status == 0 && demangled ? demangled : info.dli_sname);
+            std::free(demangled);
+            return name;
+        }
+#endif
+        return std::format("{}", address);
+    }
+
+#ifdef FAE_PROFILE
+    auto record_profile_zone(const profile_zone& zone, std::uint64_t begin, std::uint64_t end) noexcept -> void
+    {
+        auto* thread = current_thread;
+        if (!thread)
+        {
+            thread = current_thread = register_thread();
+        }
+        const auto index = thread->written.load(std::memory_order_relaxed);
+        auto& recorded = thread->zones[index % zones_per_thread];
+        recorded.zone.store(&zone, std::memory_order_relaxed);
+        recorded.begin.store(begin, std::memory_order_relaxed);
+        recorded.end.store(end, std::memory_order_relaxed);
+        thread->written.store(index + 1, std::memory_order_release);
+    }
+
+    auto write_chrome_trace(const std::filesystem::path& path) -> bool
+    {
+        auto& instance = get_profiler();
+        auto lock = std::scoped_lock(instance.mutex);
+
+        const auto elapsed_microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - instance.start_time).count();
+        const auto elapsed_timestamp = static_cast<double>(profile_timestamp() - instance.start_timestamp);
+        const auto timestamps_per_microsecond = elapsed_microseconds > 0. && elapsed_timestamp > 0. ? elapsed_timestamp / elapsed_microseconds : 1.;
+        auto to_microseconds = [&](std::uint64_t timestamp)
+        {
+            return (static_cast<double>(timestamp) - static_cast<double>(instance.start_timestamp)) / timestamps_per_microsecond;
+        };
+
+        auto file = std::ofstream(path, std::ios::trunc);
+        if (!file.is_open())
+        {
+            fae::log_error("failed to write chrome trace {}", path.string());
+            return false;
+        }
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        auto is_first = true;
+        struct copied_zone
+        {
+            const profile_zone* zone;
+            std::uint64_t begin;
+            std::uint64_t end;
+        };
+        auto zones = std::vector<copied_zone>{};
+        for (const auto& thread : instance.threads)
+        {
+            if (!is_first)
+            {
+                file << ',';
+            }
+            is_first = false;
+            file << std::format(R"({{"name":"thread_name","ph":"M","pid":0,"tid":{},"args":{{"name":"thread {}"}}}})", thread->index, thread->index);
+
+            const auto written = thread->written.load(std::memory_order_acquire);
+            const auto first = std::max(thread->cleared.load(std::memory_order_relaxed), written > zones_per_thread ? written - zones_per_thread : std::uint64_t{ 0 });
+            zones.clear();
+            for (auto i = first; i < written; ++i)
+            {
+                const auto& recorded = thread->zones[i % zones_per_thread];
+                zones.push_back(copied_zone{
+                    .zone = recorded.zone.load(std::memory_order_relaxed),
+                    .begin = recorded.begin.load(std::memory_order_relaxed),
+                    .end = recorded.end.load(std::memory_order_relaxed),
+                });
+            }
+            // the thread kept recording while copying, the zones it may have overwritten are dropped
+            const auto written_after = thread->written.load(std::memory_order_acquire);
+            const auto overwritten = written_after + overwrite_margin > zones_per_thread ? written_after + overwrite_margin - zones_per_thread : std::uint64_t{ 0 };
+            for (auto i = first; i < written; ++i)
+            {
+                if (i < overwritten)
+                {
+                    continue;
+                }
+                const auto& [zone, begin, end] = zones[i - first];
+                file << R"(,{"name":)";
+                write_json_string(file, zone->name);
+                file << std::format(R"(,"cat":"fae","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":0,"tid":{})", to_microseconds(begin), static_cast<double>(end - begin) / timestamps_per_microsecond, thread->index);
+                if (zone->line > 0)
+                {
+                    file << R"(,"args":{"file":)";
+                    write_json_string(file, zone->file);
+                    file << std::format(R"(,"line":{}}})", zone->line);
+                }
+                file << '}';
+            }
+        }
+        file << "]}";
+        return file.good();
+    }
+
+    auto clear_profile() noexcept -> void
+    {
+        auto& instance = get_profiler();
+        auto lock = std::scoped_lock(instance.mutex);
+        for (const auto& thread : instance.threads)
+        {
+            thread->cleared.store(thread->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+    }
+#else
+    auto write_chrome_trace([[maybe_unused]] const std::filesystem::path& path) -> bool
+    {
+        fae::log_warning("nothing was profiled, build with FAE_PROFILE to record zones");
+        return false;
+    }
+
+    auto clear_profile() noexcept -> void
+    {
+    }
+#endif
+}
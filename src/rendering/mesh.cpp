@@ -3,68 +3,115 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include "fae/filesystem/virtual_file_system.hpp"
+
 namespace fae
 {
-    auto meshes::cube(float size) -> mesh
+    namespace
     {
-        static auto static_mesh = *mesh::load(FAE_ASSET_DIR / std::filesystem::path("cube.obj"));
-        auto mesh = static_mesh;
-        for (auto& vertex : mesh.vertices)
+        constexpr auto import_flags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType;
+
+        auto from_scene(const aiScene& scene) -> mesh
         {
-            vertex.position *= size / 2;
+            auto result = mesh{};
+
+            // TODO support multi mesh loading from one file
+            std::size_t mesh_idx = 0;
+            auto mesh = scene.mMeshes[mesh_idx];
+
+            for (std::size_t v = 0; v < mesh->mNumVertices; v++)
+            {
+                auto vertex = fae::vertex{};
+                vertex.position = { mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z };
+                if (mesh->HasVertexColors(mesh_idx))
+                {
+                    auto color = mesh->mColors[v];
+                    vertex.color = { color->r, color->g, color->b, color->a };
+                }
+                if (mesh->HasNormals())
+                {
+                    auto normal = mesh->mNormals[v];
+                    vertex.normal = { normal.x, normal.y, normal.z };
+                }
+                if (mesh->HasTextureCoords(mesh_idx))
+                {
+                    auto uv = mesh->mTextureCoords[mesh_idx][v];
+                    vertex.uv = { uv.x, uv.y };
+                }
+                result.vertices.push_back(vertex);
+            }
+
+            if (mesh->HasFaces())
+            {
+                for (std::size_t f = 0; f < mesh->mNumFaces; f++)
+                {
+                    auto face = mesh->mFaces[f];
+                    for (std::size_t i = 0; i < face.mNumIndices; i++)
+                    {
+                        result.indices.push_back(face.mIndices[i]);
+                    }
+                }
+            }
+
+            result.compute_bounds();
+            generate_lods(result);
+
+            return result;
         }
-        return mesh;
     }
 
     auto mesh::load(std::filesystem::path path) -> std::optional<mesh>
     {
         auto importer = Assimp::Importer{};
-        const auto scene = importer.ReadFile(path.string(), aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType);
+        const auto scene = importer.ReadFile(path.string(), import_flags);
         if (!scene)
         {
             return std::nullopt;
         }
+        return from_scene(*scene);
+    }
 
-        auto result = mesh{};
+    auto mesh::load(const std::filesystem::path& path, const virtual_file_system& vfs) -> std::optional<mesh>
+    {
+        auto file = vfs.read(path);
+        if (!file)
+        {
+            return std::nullopt;
+        }
 
-        // TODO support multi mesh loading from one file
-        std::size_t mesh_idx = 0;
-        auto mesh = scene->mMeshes[mesh_idx];
+        // the extension tells assimp which importer to use since there is no file name
+        const auto bytes = file->data();
+        const auto extension = path.extension().string();
+        auto importer = Assimp::Importer{};
+        const auto scene = importer.ReadFileFromMemory(bytes.data(), bytes.size(), import_flags, extension.empty() ? "" : extension.c_str() + 1);
+        if (!scene)
+        {
+            return std::nullopt;
+        }
+        return from_scene(*scene);
+    }
 
-        for (std::size_t v = 0; v < mesh->mNumVertices; v++)
+    auto mesh::compute_bounds() noexcept -> void
+    {
+        if (vertices.empty())
         {
-            auto vertex = fae::vertex{};
-            vertex.position = { mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z };
-            if (mesh->HasVertexColors(mesh_idx))
-            {
-                auto color = mesh->mColors[v];
-                vertex.color = { color->r, color->g, color->b, color->a };
-            }
-            if (mesh->HasNormals())
-            {
-                auto normal = mesh->mNormals[v];
-                vertex.normal = { normal.x, normal.y, normal.z };
-            }
-            if (mesh->HasTextureCoords(mesh_idx))
-            {
-                auto uv = mesh->mTextureCoords[mesh_idx][v];
-                vertex.uv = { uv.x, uv.y };
-            }
-            result.vertices.push_back(vertex);
+            bounds = bounding_sphere{};
+            return;
         }
 
-        if (mesh->HasFaces())
+        auto min = vertices.front().position;
+        auto max = vertices.front().position;
+        for (const auto& vertex : vertices)
         {
-            for (std::size_t f = 0; f < mesh->mNumFaces; f++)
-            {
-                auto face = mesh->mFaces[f];
-                for (std::size_t i = 0; i < face.mNumIndices; i++)
-                {
-                    result.indices.push_back(face.mIndices[i]);
-                }
-            }
+            min = math::min(min, vertex.position);
+            max = math::max(max, vertex.position);
         }
 
-        return result;
+        bounds.center = (min + max) * 0.5f;
+        bounds.radius = 0.f;
+        for (const auto& vertex : vertices)
+        {
+            bounds.radius = std::max(bounds.radius, math::distance(bounds.center, vertex.position));
+        }
     }
 }
@@ -0,0 +1,423 @@
+#include "fae/rendering/mesh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace fae
+{
+    namespace
+    {
+        /*
+        symmetric 4x4 matrix of the sum of squared distances to a set of weighted planes
+        evaluated as the weighted mean, so costs are squared distances whatever the mesh scale or triangle density
+        */
+        struct quadric
+        {
+            std::array<double, 10> m{};
+            double weight = 0.0;
+
+            [[nodiscard]] static auto from_plane(double a, double b, double c, double d, double weight) noexcept -> quadric
+            {
+                return quadric{
+                    .m = {
+                        a * a * weight, a * b * weight, a * c * weight, a * d * weight,
+                        b * b * weight, b * c * weight, b * d * weight,
+                        c * c * weight, c * d * weight,
+                        d * d * weight,
+                    },
+                    .weight = weight,
+                };
+            }
+
+            auto operator+=(const quadric& rhs) noexcept -> quadric&
+            {
+                for (std::size_t i = 0; i < m.size(); ++i)
+                {
+                    m[i] += rhs.m[i];
+                }
+                weight += rhs.weight;
+                return *this;
+            }
+
+            [[nodiscard]] auto operator+(const quadric& rhs) const noexcept -> quadric
+            {
+                auto result = *this;
+                result += rhs;
+                return result;
+            }
+
+            [[nodiscard]] auto evaluate(const vec3& p) const noexcept -> double
+            {
+                const double x = p.x, y = p.y, z = p.z;
+                const auto error = m[0] * x * x + 2 * m[1] * x * y + 2 * m[2] * x * z + 2 * m[3] * x +
+                                   m[4] * y * y + 2 * m[5] * y * z + 2 * m[6] * y +
+                                   m[7] * z * z + 2 * m[8] * z +
+                                   m[9];
+                return weight > 0.0 ? std::max(error / weight, 0.0) : 0.0;
+            }
+        };
+
+        struct position_hash
+        {
+            auto operator()(const vec3& p) const noexcept -> std::size_t
+            {
+                auto h = static_cast<std::size_t>(std::bit_cast<std::uint32_t>(p.x));
+                h = h * 73856093u ^ static_cast<std::size_t>(std::bit_cast<std::uint32_t>(p.y));
+                h = h * 19349663u ^ static_cast<std::size_t>(std::bit_cast<std::uint32_t>(p.z));
+                return h;
+            }
+        };
+
+        struct triangle
+        {
+            /* welded vertex ids, used for the topology */
+            std::array<std::uint32_t, 3> welded;
+            /* original vertex ids, used when emitting indices so untouched seams keep their attributes */
+            std::array<std::uint32_t, 3> original;
+            bool alive = true;
+
+            [[nodiscard]] auto contains(std::uint32_t v) const noexcept -> bool
+            {
+                return welded[0] == v || welded[1] == v || welded[2] == v;
+            }
+        };
+
+        struct collapse
+        {
+            double cost;
+            std::uint32_t from;
+            std::uint32_t to;
+
+            auto operator>(const collapse& rhs) const noexcept -> bool
+            {
+                return cost > rhs.cost;
+            }
+        };
+
+        struct simplifier
+        {
+            std::vector<vec3> positions;
+            /* original vertex id representing each welded vertex */
+            std::vector<std::uint32_t> representative;
+            std::vector<quadric> quadrics;
+            std::vector<std::vector<std::uint32_t>> adjacency;
+            std::vector<bool> removed;
+            std::vector<triangle> triangles;
+            std::size_t alive_triangles = 0;
+            std::priority_queue<collapse, std::vector<collapse>, std::greater<collapse>> candidates;
+            double max_cost_applied = 0.0;
+
+            simplifier(const mesh& mesh, std::span<const std::uint32_t> indices)
+            {
+                auto welded_ids = std::vector<std::uint32_t>(mesh.vertices.size());
+                auto position_to_id = std::unordered_map<vec3, std::uint32_t, position_hash>{};
+                position_to_id.reserve(mesh.vertices.size());
+                for (std::uint32_t v = 0; v < mesh.vertices.size(); ++v)
+                {
+                    const auto [it, inserted] = position_to_id.try_emplace(mesh.vertices[v].position, static_cast<std::uint32_t>(positions.size()));
+                    if (inserted)
+                    {
+                        positions.push_back(mesh.vertices[v].position);
+                        representative.push_back(v);
+                    }
+                    welded_ids[v] = it->second;
+                }
+
+                quadrics.resize(positions.size());
+                adjacency.resize(positions.size());
+                removed.resize(positions.size(), false);
+
+                triangles.reserve(indices.size() / 3);
+                for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+                {
+                    const auto t = triangle{
+                        .welded = { welded_ids[indices[i]], welded_ids[indices[i + 1]], welded_ids[indices[i + 2]] },
+                        .original = { indices[i], indices[i + 1], indices[i + 2] },
+                    };
+                    if (t.welded[0] == t.welded[1] || t.welded[1] == t.welded[2] || t.welded[0] == t.welded[2])
+                    {
+                        continue;
+                    }
+                    const auto id = static_cast<std::uint32_t>(triangles.size());
+                    triangles.push_back(t);
+                    for (auto v : t.welded)
+                    {
+                        adjacency[v].push_back(id);
+                    }
+                }
+                alive_triangles = triangles.size();
+
+                accumulate_quadrics();
+
+                for (const auto& t : triangles)
+                {
+                    for (std::size_t c = 0; c < 3; ++c)
+                    {
+                        push_candidate(t.welded[c], t.welded[(c + 1) % 3]);
+                        push_candidate(t.welded[(c + 1) % 3], t.welded[c]);
+                    }
+                }
+            }
+
+            auto accumulate_quadrics() -> void
+            {
+                auto edge_use = std::unordered_map<std::uint64_t, std::uint32_t>{};
+                auto edge_key = [](std::uint32_t a, std::uint32_t b)
+                {
+                    return (static_cast<std::uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+                };
+
+                for (const auto& t : triangles)
+                {
+                    const auto& p0 = positions[t.welded[0]];
+                    const auto& p1 = positions[t.welded[1]];
+                    const auto& p2 = positions[t.welded[2]];
+                    const auto n = math::cross(p1 - p0, p2 - p0);
+                    const auto area = math::length(n);
+                    if (area <= 0.f)
+                    {
+                        continue;
+                    }
+                    const auto normal = n / area;
+                    const auto plane = quadric::from_plane(normal.x, normal.y, normal.z, -math::dot(normal, p0), area);
+                    for (auto v : t.welded)
+                    {
+                        quadrics[v] += plane;
+                    }
+                    for (std::size_t c = 0; c < 3; ++c)
+                    {
+                        ++edge_use[edge_key(t.welded[c], t.welded[(c + 1) % 3])];
+                    }
+                }
+
+                // keep open borders in place by penalizing movement away from them
+                constexpr auto border_weight = 10.f;
+                for (const auto& t : triangles)
+                {
+                    const auto& p0 = positions[t.welded[0]];
+                    const auto face_normal = math::cross(positions[t.welded[1]] - p0, positions[t.welded[2]] - p0);
+                    for (std::size_t c = 0; c < 3; ++c)
+                    {
+                        const auto a = t.welded[c];
+                        const auto b = t.welded[(c + 1) % 3];
+                        if (edge_use[edge_key(a, b)] != 1)
+                        {
+                            continue;
+                        }
+                        const auto edge = positions[b] - positions[a];
+                        auto n = math::cross(edge, face_normal);
+                        const auto length = math::length(n);
+                        if (length <= 0.f)
+                        {
+                            continue;
+                        }
+                        n /= length;
+                        const auto plane = quadric::from_plane(n.x, n.y, n.z, -math::dot(n, positions[a]), border_weight * math::dot(edge, edge));
+                        quadrics[a] += plane;
+                        quadrics[b] += plane;
+                    }
+                }
+            }
+
+            [[nodiscard]] auto cost(std::uint32_t from, std::uint32_t to) const noexcept -> double
+            {
+                return (quadrics[from] + quadrics[to]).evaluate(positions[to]);
+            }
+
+            auto push_candidate(std::uint32_t from, std::uint32_t to) -> void
+            {
+                candidates.push(collapse{ .cost = cost(from, to), .from = from, .to = to });
+            }
+
+            /* checks the edge still exists and that moving `from` onto `to` flips no triangle */
+            [[nodiscard]] auto can_collapse(std::uint32_t from, std::uint32_t to) const noexcept -> bool
+            {
+                auto edge_exists = false;
+                for (auto id : adjacency[from])
+                {
+                    const auto& t = triangles[id];
+                    if (!t.alive)
+                    {
+                        continue;
+                    }
+                    if (t.contains(to))
+                    {
+                        edge_exists = true;
+                        continue;
+                    }
+
+                    auto moved = std::array<vec3, 3>{};
+                    for (std::size_t c = 0; c < 3; ++c)
+                    {
+                        moved[c] = positions[t.welded[c] == from ? to : t.welded[c]];
+                    }
+                    const auto& p = positions;
+                    const auto before = math::cross(p[t.welded[1]] - p[t.welded[0]], p[t.welded[2]] - p[t.welded[0]]);
+                    const auto after = math::cross(moved[1] - moved[0], moved[2] - moved[0]);
+                    if (math::dot(before, after) <= 0.f)
+                    {
+                        return false;
+                    }
+                }
+                return edge_exists;
+            }
+
+            auto apply_collapse(std::uint32_t from, std::uint32_t to) -> void
+            {
+                removed[from] = true;
+                quadrics[to] += quadrics[from];
+
+                for (auto id : adjacency[from])
+                {
+                    auto& t = triangles[id];
+                    if (!t.alive)
+                    {
+                        continue;
+                    }
+                    if (t.contains(to))
+                    {
+                        t.alive = false;
+                        --alive_triangles;
+                        continue;
+                    }
+                    for (std::size_t c = 0; c < 3; ++c)
+                    {
+                        if (t.welded[c] == from)
+                        {
+                            t.welded[c] = to;
+                            t.original[c] = representative[to];
+                        }
+                    }
+                    adjacency[to].push_back(id);
+                }
+                adjacency[from].clear();
+
+                std::erase_if(adjacency[to], [&](std::uint32_t id)
+                    { return !triangles[id].alive; });
+                for (auto id : adjacency[to])
+                {
+                    for (auto v : triangles[id].welded)
+                    {
+                        if (v != to)
+                        {
+                            push_candidate(to, v);
+                            push_candidate(v, to);
+                        }
+                    }
+                }
+            }
+
+            /* collapses the cheapest edges until target_triangles are left or max_cost is reached */
+            auto simplify(std::size_t target_triangles, double max_cost) -> void
+            {
+                while (alive_triangles > target_triangles && !candidates.empty())
+                {
+                    const auto candidate = candidates.top();
+                    if (candidate.cost > max_cost)
+                    {
+                        return;
+                    }
+                    candidates.pop();
+                    if (removed[candidate.from] || removed[candidate.to])
+                    {
+                        continue;
+                    }
+                    // quadrics change as neighbours collapse, so re-queue outdated costs
+                    const auto current_cost = cost(candidate.from, candidate.to);
+                    if (current_cost > candidate.cost * (1.0 + 1e-6) + 1e-12)
+                    {
+                        candidates.push(collapse{ .cost = current_cost, .from = candidate.from, .to = candidate.to });
+                        continue;
+                    }
+                    if (!can_collapse(candidate.from, candidate.to))
+                    {
+                        continue;
+                    }
+                    apply_collapse(candidate.from, candidate.to);
+                    max_cost_applied = std::max(max_cost_applied, current_cost);
+                }
+            }
+
+            auto emit(std::vector<std::uint32_t>& out) const -> void
+            {
+                out.reserve(out.size() + alive_triangles * 3);
+                for (const auto& t : triangles)
+                {
+                    if (t.alive)
+                    {
+                        out.insert(out.end(), t.original.begin(), t.original.end());
+                    }
+                }
+            }
+        };
+    }
+
+    auto generate_lods(mesh& mesh, const lod_generation_settings& settings) -> void
+    {
+        if (mesh.vertices.empty())
+        {
+            return;
+        }
+        if (!mesh.has_indices())
+        {
+            mesh.indices.resize(mesh.vertices.size());
+            std::iota(mesh.indices.begin(), mesh.indices.end(), 0u);
+        }
+
+        // drop previously generated levels, they are always rebuilt from the full detail level
+        const auto base_index_count = mesh.lods.empty() ? mesh.indices.size() : mesh.lods.front().index_count;
+        mesh.indices.resize(base_index_count);
+        mesh.lods.clear();
+        mesh.lods.push_back(mesh_lod{
+            .first_index = 0,
+            .index_count = static_cast<std::uint32_t>(base_index_count),
+            .error = 0.f,
+        });
+
+        if (mesh.bounds.radius <= 0.f)
+        {
+            mesh.compute_bounds();
+        }
+        const auto radius = static_cast<double>(mesh.bounds.radius);
+        if (radius <= 0.0)
+        {
+            return;
+        }
+        const auto max_distance = settings.max_error * radius;
+        const auto max_cost = max_distance * max_distance;
+
+        auto s = simplifier(mesh, std::span<const std::uint32_t>(mesh.indices));
+        for (std::size_t level = 1; level < settings.max_lods; ++level)
+        {
+            const auto previous_triangles = s.alive_triangles;
+            const auto target_triangles = std::max(settings.min_triangles, static_cast<std::size_t>(previous_triangles * settings.reduction));
+            if (target_triangles >= previous_triangles)
+            {
+                break;
+            }
+
+            s.simplify(target_triangles, max_cost);
+
+            // stop once simplification no longer pays for the extra index range
+            if (s.alive_triangles == 0 || s.alive_triangles * 10 > previous_triangles * 9)
+            {
+                break;
+            }
+
+            const auto first_index = mesh.indices.size();
+            s.emit(mesh.indices);
+            mesh.lods.push_back(mesh_lod{
+                .first_index = static_cast<std::uint32_t>(first_index),
+                .index_count = static_cast<std::uint32_t>(mesh.indices.size() - first_index),
+                .error = static_cast<float>(std::sqrt(s.max_cost_applied) / radius),
+            });
+        }
+    }
+}
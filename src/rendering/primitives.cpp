@@ -0,0 +1,363 @@
+#include "fae/rendering/mesh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <unordered_map>
+#include <vector>
+
+namespace fae
+{
+    namespace
+    {
+        constexpr auto pi = std::numbers::pi_v<float>;
+
+        auto make_vertex(vec3 position, vec3 normal, vec2 uv) noexcept -> vertex
+        {
+            return vertex{
+                .position = position,
+                .normal = normal,
+                .uv = uv,
+            };
+        }
+
+        auto make_mesh(primitive_size size, auto&& write) -> mesh
+        {
+            auto result = mesh{};
+            result.vertices.resize(size.vertex_count);
+            result.indices.resize(size.index_count);
+            write(std::span<vertex>(result.vertices), std::span<std::uint32_t>(result.indices));
+            result.compute_bounds();
+            return result;
+        }
+    }
+
+    auto meshes::write_cube(std::span<vertex> vertices, std::span<std::uint32_t> indices, float size) noexcept -> void
+    {
+        struct face
+        {
+            vec3 normal;
+            vec3 u;
+            vec3 v;
+        };
+        // u x v == normal, so corners walked in (u, v) order are counter clockwise seen from outside
+        constexpr auto faces = std::array<face, 6>{
+            face{ .normal = { 1.f, 0.f, 0.f }, .u = { 0.f, 0.f, -1.f }, .v = { 0.f, 1.f, 0.f } },
+            face{ .normal = { -1.f, 0.f, 0.f }, .u = { 0.f, 0.f, 1.f }, .v = { 0.f, 1.f, 0.f } },
+            face{ .normal = { 0.f, 1.f, 0.f }, .u = { 1.f, 0.f, 0.f }, .v = { 0.f, 0.f, -1.f } },
+            face{ .normal = { 0.f, -1.f, 0.f }, .u = { 1.f, 0.f, 0.f }, .v = { 0.f, 0.f, 1.f } },
+            face{ .normal = { 0.f, 0.f, 1.f }, .u = { 1.f, 0.f, 0.f }, .v = { 0.f, 1.f, 0.f } },
+            face{ .normal = { 0.f, 0.f, -1.f }, .u = { -1.f, 0.f, 0.f }, .v = { 0.f, 1.f, 0.f } },
+        };
+        constexpr auto corners = std::array<vec2, 4>{ vec2{ -1.f, -1.f }, vec2{ 1.f, -1.f }, vec2{ 1.f, 1.f }, vec2{ -1.f, 1.f } };
+
+        const auto half = size * 0.5f;
+        std::size_t v = 0, i = 0;
+        for (const auto& face : faces)
+        {
+            const auto base = static_cast<std::uint32_t>(v);
+            for (const auto& corner : corners)
+            {
+                const auto position = (face.normal + face.u * corner.x + face.v * corner.y) * half;
+                const auto uv = vec2{ (corner.x + 1.f) * 0.5f, (1.f - corner.y) * 0.5f };
+                vertices[v++] = make_vertex(position, face.normal, uv);
+            }
+            for (auto index : { 0u, 1u, 2u, 0u, 2u, 3u })
+            {
+                indices[i++] = base + index;
+            }
+        }
+    }
+
+    auto meshes::write_plane(std::span<vertex> vertices, std::span<std::uint32_t> indices, float size, std::uint32_t subdivisions) noexcept -> void
+    {
+        subdivisions = std::max(subdivisions, min_plane_subdivisions);
+        const auto half = size * 0.5f;
+        const auto step = size / static_cast<float>(subdivisions);
+        const auto row = subdivisions + 1;
+
+        std::size_t v = 0;
+        for (std::uint32_t z = 0; z <= subdivisions; ++z)
+        {
+            for (std::uint32_t x = 0; x <= subdivisions; ++x)
+            {
+                const auto uv = vec2{ static_cast<float>(x), static_cast<float>(z) } / static_cast<float>(subdivisions);
+                vertices[v++] = make_vertex({ -half + x * step, 0.f, -half + z * step }, { 0.f, 1.f, 0.f }, uv);
+            }
+        }
+
+        std::size_t i = 0;
+        for (std::uint32_t z = 0; z < subdivisions; ++z)
+        {
+            for (std::uint32_t x = 0; x < subdivisions; ++x)
+            {
+                const auto a = z * row + x;
+                const auto b = a + 1;
+                const auto d = a + row;
+                const auto c = d + 1;
+                for (auto index : { a, c, b, a, d, c })
+                {
+                    indices[i++] = index;
+                }
+            }
+        }
+    }
+
+    auto meshes::write_uv_sphere(std::span<vertex> vertices, std::span<std::uint32_t> indices, float radius, std::uint32_t segments, std::uint32_t rings) noexcept -> void
+    {
+        segments = std::max(segments, min_segments);
+        rings = std::max(rings, min_uv_sphere_rings);
+        std::size_t v = 0;
+        for (std::uint32_t r = 0; r <= rings; ++r)
+        {
+            const auto theta = pi * static_cast<float>(r) / static_cast<float>(rings);
+            for (std::uint32_t s = 0; s <= segments; ++s)
+            {
+                const auto phi = 2.f * pi * static_cast<float>(s) / static_cast<float>(segments);
+                const auto normal = vec3{ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+                const auto uv = vec2{ static_cast<float>(s) / static_cast<float>(segments), static_cast<float>(r) / static_cast<float>(rings) };
+                vertices[v++] = make_vertex(normal * radius, normal, uv);
+            }
+        }
+
+        // the first & last bands touch the poles, so only one of their two triangles has an area
+        const auto row = segments + 1;
+        std::size_t i = 0;
+        for (std::uint32_t r = 0; r < rings; ++r)
+        {
+            for (std::uint32_t s = 0; s < segments; ++s)
+            {
+                const auto a = r * row + s;
+                const auto b = a + 1;
+                const auto d = a + row;
+                const auto c = d + 1;
+                if (r != 0)
+                {
+                    for (auto index : { a, b, c })
+                    {
+                        indices[i++] = index;
+                    }
+                }
+                if (r != rings - 1)
+                {
+                    for (auto index : { a, c, d })
+                    {
+                        indices[i++] = index;
+                    }
+                }
+            }
+        }
+    }
+
+    auto meshes::write_icosphere(std::span<vertex> vertices, std::span<std::uint32_t> indices, float radius, std::uint32_t subdivisions) -> void
+    {
+        const auto t = (1.f + std::sqrt(5.f)) * 0.5f;
+        const auto corners = std::array<vec3, 12>{
+            vec3{ -1.f, t, 0.f }, vec3{ 1.f, t, 0.f }, vec3{ -1.f, -t, 0.f }, vec3{ 1.f, -t, 0.f },
+            vec3{ 0.f, -1.f, t }, vec3{ 0.f, 1.f, t }, vec3{ 0.f, -1.f, -t }, vec3{ 0.f, 1.f, -t },
+            vec3{ t, 0.f, -1.f }, vec3{ t, 0.f, 1.f }, vec3{ -t, 0.f, -1.f }, vec3{ -t, 0.f, 1.f }
+        };
+        constexpr auto faces = std::array<std::uint32_t, 60>{
+            0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11,
+            1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+            3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9,
+            4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1
+        };
+
+        std::size_t vertex_count = 0;
+        auto add_vertex = [&](vec3 direction)
+        {
+            const auto normal = math::normalize(direction);
+            const auto uv = vec2{ 0.5f + std::atan2(normal.z, normal.x) / (2.f * pi), std::acos(normal.y) / pi };
+            vertices[vertex_count] = make_vertex(normal * radius, normal, uv);
+            return static_cast<std::uint32_t>(vertex_count++);
+        };
+        for (const auto& corner : corners)
+        {
+            add_vertex(corner);
+        }
+
+        // each level splits every triangle in four, ping ponging between a scratch buffer & the output
+        auto scratch = std::vector<std::uint32_t>(subdivisions > 0 ? indices.size() / 4 : 0);
+        const auto output_first = subdivisions % 2 == 0;
+        auto current = output_first ? indices : std::span<std::uint32_t>(scratch);
+        auto next = output_first ? std::span<std::uint32_t>(scratch) : indices;
+        std::copy(faces.begin(), faces.end(), current.begin());
+        std::size_t index_count = faces.size();
+
+        auto midpoints = std::unordered_map<std::uint64_t, std::uint32_t>{};
+        midpoints.reserve(vertices.size());
+        auto midpoint = [&](std::uint32_t a, std::uint32_t b)
+        {
+            const auto key = (static_cast<std::uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+            if (auto it = midpoints.find(key); it != midpoints.end())
+            {
+                return it->second;
+            }
+            const auto id = add_vertex(vertices[a].position + vertices[b].position);
+            midpoints.emplace(key, id);
+            return id;
+        };
+
+        for (std::uint32_t level = 0; level < subdivisions; ++level)
+        {
+            std::size_t n = 0;
+            for (std::size_t f = 0; f < index_count; f += 3)
+            {
+                const auto a = current[f], b = current[f + 1], c = current[f + 2];
+                const auto ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+                for (auto index : { a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca })
+                {
+                    next[n++] = index;
+                }
+            }
+            index_count = n;
+            std::swap(current, next);
+            midpoints.clear();
+        }
+    }
+
+    auto meshes::write_cylinder(std::span<vertex> vertices, std::span<std::uint32_t> indices, float radius, float height, std::uint32_t segments) noexcept -> void
+    {
+        segments = std::max(segments, min_segments);
+        const auto half = height * 0.5f;
+        const auto row = segments + 1;
+        std::size_t v = 0, i = 0;
+
+        // side, top row then bottom row with a duplicated seam column for the uvs
+        for (auto y : { half, -half })
+        {
+            for (std::uint32_t s = 0; s <= segments; ++s)
+            {
+                const auto phi = 2.f * pi * static_cast<float>(s) / static_cast<float>(segments);
+                const auto normal = vec3{ std::cos(phi), 0.f, std::sin(phi) };
+                const auto uv = vec2{ static_cast<float>(s) / static_cast<float>(segments), y > 0.f ? 0.f : 1.f };
+                vertices[v++] = make_vertex({ normal.x * radius, y, normal.z * radius }, normal, uv);
+            }
+        }
+        for (std::uint32_t s = 0; s < segments; ++s)
+        {
+            const auto a = s, b = s + 1, c = row + s + 1, d = row + s;
+            for (auto index : { a, b, c, a, c, d })
+            {
+                indices[i++] = index;
+            }
+        }
+
+        // caps, a center vertex & a ring each
+        for (auto y : { half, -half })
+        {
+            const auto normal = vec3{ 0.f, y > 0.f ? 1.f : -1.f, 0.f };
+            const auto center = static_cast<std::uint32_t>(v);
+            vertices[v++] = make_vertex({ 0.f, y, 0.f }, normal, { 0.5f, 0.5f });
+            for (std::uint32_t s = 0; s < segments; ++s)
+            {
+                const auto phi = 2.f * pi * static_cast<float>(s) / static_cast<float>(segments);
+                const auto c = std::cos(phi), sn = std::sin(phi);
+                vertices[v++] = make_vertex({ c * radius, y, sn * radius }, normal, { 0.5f + 0.5f * c, 0.5f + 0.5f * sn });
+            }
+            for (std::uint32_t s = 0; s < segments; ++s)
+            {
+                const auto current = center + 1 + s;
+                const auto next = center + 1 + (s + 1) % segments;
+                const auto triangle = y > 0.f ? std::array{ center, next, current } : std::array{ center, current, next };
+                for (auto index : triangle)
+                {
+                    indices[i++] = index;
+                }
+            }
+        }
+    }
+
+    auto meshes::write_capsule(std::span<vertex> vertices, std::span<std::uint32_t> indices, float radius, float height, std::uint32_t segments, std::uint32_t rings) noexcept -> void
+    {
+        segments = std::max(segments, min_segments);
+        rings = std::max(rings, min_capsule_rings);
+        const auto half_body = std::max(height * 0.5f - radius, 0.f);
+        const auto total_height = 2.f * (half_body + radius);
+        const auto rows = rings * 2 + 2;
+        const auto row = segments + 1;
+
+        // a uv sphere split at the equator, the two hemispheres pushed apart by the body length
+        std::size_t v = 0;
+        for (std::uint32_t k = 0; k < rows; ++k)
+        {
+            const auto is_top = k <= rings;
+            const auto theta = is_top ? 0.5f * pi * static_cast<float>(k) / static_cast<float>(rings)
+                                      : 0.5f * pi + 0.5f * pi * static_cast<float>(k - rings - 1) / static_cast<float>(rings);
+            const auto offset = is_top ? half_body : -half_body;
+            for (std::uint32_t s = 0; s <= segments; ++s)
+            {
+                const auto phi = 2.f * pi * static_cast<float>(s) / static_cast<float>(segments);
+                const auto normal = vec3{ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+                const auto position = normal * radius + vec3{ 0.f, offset, 0.f };
+                const auto uv = vec2{ static_cast<float>(s) / static_cast<float>(segments), 0.5f - position.y / total_height };
+                vertices[v++] = make_vertex(position, normal, uv);
+            }
+        }
+
+        std::size_t i = 0;
+        for (std::uint32_t k = 0; k + 1 < rows; ++k)
+        {
+            for (std::uint32_t s = 0; s < segments; ++s)
+            {
+                const auto a = k * row + s;
+                const auto b = a + 1;
+                const auto d = a + row;
+                const auto c = d + 1;
+                if (k != 0)
+                {
+                    for (auto index : { a, b, c })
+                    {
+                        indices[i++] = index;
+                    }
+                }
+                if (k != rows - 2)
+                {
+                    for (auto index : { a, c, d })
+                    {
+                        indices[i++] = index;
+                    }
+                }
+            }
+        }
+    }
+
+    auto meshes::cube(float size) -> mesh
+    {
+        return make_mesh(cube_size(), [&](auto vertices, auto indices)
+            { write_cube(vertices, indices, size); });
+    }
+
+    auto meshes::plane(float size, std::uint32_t subdivisions) -> mesh
+    {
+        return make_mesh(plane_size(subdivisions), [&](auto vertices, auto indices)
+            { write_plane(vertices, indices, size, subdivisions); });
+    }
+
+    auto meshes::uv_sphere(float radius, std::uint32_t segments, std::uint32_t rings) -> mesh
+    {
+        return make_mesh(uv_sphere_size(segments, rings), [&](auto vertices, auto indices)
+            { write_uv_sphere(vertices, indices, radius, segments, rings); });
+    }
+
+    auto meshes::icosphere(float radius, std::uint32_t subdivisions) -> mesh
+    {
+        return make_mesh(icosphere_size(subdivisions), [&](auto vertices, auto indices)
+            { write_icosphere(vertices, indices, radius, subdivisions); });
+    }
+
+    auto meshes::cylinder(float radius, float height, std::uint32_t segments) -> mesh
+    {
+        return make_mesh(cylinder_size(segments), [&](auto vertices, auto indices)
+            { write_cylinder(vertices, indices, radius, height, segments); });
+    }
+
+    auto meshes::capsule(float radius, float height, std::uint32_t segments, std::uint32_t rings) -> mesh
+    {
+        return make_mesh(capsule_size(segments, rings), [&](auto vertices, auto indices)
+            { write_capsule(vertices, indices, radius, height, segments, rings); });
+    }
+}
@@ -0,0 +1,126 @@
+#include "fae/rendering/render_thread.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "fae/allocation_tracker.hpp"
+#include "fae/core/linear_arena.hpp"
+#include "fae/profiler.hpp"
+
+namespace fae
+{
+    struct render_thread::state
+    {
+        std::mutex mutex;
+        std::condition_variable frame_ready;
+        std::condition_variable frame_done;
+        std::function<void(std::pmr::memory_resource&)> frame;
+        linear_arena arena{};
+        bool busy = false;
+        bool stopping = false;
+        std::thread thread;
+
+        auto run() -> void
+        {
+            [[maybe_unused]] auto allocations = allocation_scope("render_thread");
+            auto lock = std::unique_lock(mutex);
+            while (true)
+            {
+                frame_ready.wait(lock, [&]
+                    { return busy || stopping; });
+                if (!busy)
+                {
+                    return;
+                }
+                auto current = std::move(frame);
+                lock.unlock();
+                {
+                    FAE_PROFILE_SCOPE("render_thread frame");
+                    arena.reset();
+                    current(arena);
+                }
+                lock.lock();
+                busy = false;
+                frame_done.notify_all();
+            }
+        }
+    };
+
+    render_thread::render_thread(bool pipelined) : m_state(std::make_unique<state>())
+    {
+#ifndef FAE_PLATFORM_WEB
+        if (pipelined)
+        {
+            m_state->thread = std::thread([state = m_state.get()]
+                { state->run(); });
+        }
+#endif
+    }
+
+    render_thread::render_thread(render_thread&&) noexcept = default;
+
+    auto render_thread::operator=(render_thread&& other) noexcept -> render_thread&
+    {
+        if (this != &other)
+        {
+            stop();
+            m_state = std::move(other.m_state);
+        }
+        return *this;
+    }
+
+    render_thread::~render_thread()
+    {
+        stop();
+    }
+
+    auto render_thread::stop() noexcept -> void
+    {
+        if (!m_state || !m_state->thread.joinable())
+        {
+            return;
+        }
+        {
+            auto lock = std::scoped_lock(m_state->mutex);
+            m_state->stopping = true;
+        }
+        m_state->frame_ready.notify_all();
+        // run() finishes the frame in flight before it sees stopping
+        m_state->thread.join();
+    }
+
+    auto render_thread::submit(std::function<void(std::pmr::memory_resource&)> submit_frame) -> void
+    {
+        if (!m_state->thread.joinable())
+        {
+            m_state->arena.reset();
+            submit_frame(m_state->arena);
+            return;
+        }
+        auto lock = std::unique_lock(m_state->mutex);
+        m_state->frame_done.wait(lock, [&]
+            { return !m_state->busy; });
+        m_state->frame = std::move(submit_frame);
+        m_state->busy = true;
+        lock.unlock();
+        m_state->frame_ready.notify_one();
+    }
+
+    auto render_thread::wait() -> void
+    {
+        if (!m_state->thread.joinable())
+        {
+            return;
+        }
+        auto lock = std::unique_lock(m_state->mutex);
+        m_state->frame_done.wait(lock, [&]
+            { return !m_state->busy; });
+    }
+
+    auto render_thread::is_pipelined() const noexcept -> bool
+    {
+        return m_state->thread.joinable();
+    }
+}
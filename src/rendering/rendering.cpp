@@ -1,5 +1,7 @@
 #include "fae/rendering/rendering.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <format>
 #include <functional>
@@ -7,21 +9,191 @@
 #include <optional>
 #include <string_view>
 #include <variant>
+#include <vector>
 
+#include "fae/allocation_tracker.hpp"
 #include "fae/application/application.hpp"
 #include "fae/color.hpp"
+#include "fae/lighting.hpp"
 #include "fae/logging.hpp"
 #include "fae/math.hpp"
 #include "fae/time.hpp"
+#include "fae/transform_hierarchy.hpp"
 #include "fae/webgpu/webgpu.hpp"
 #include "fae/windowing.hpp"
 #include "fae/rendering/renderer.hpp"
 #include "fae/rendering/render_pipeline.hpp"
 #include "fae/rendering/render_pass.hpp"
 #include "fae/webgpu/default_render_pipeline.hpp"
+#include "fae/camera.hpp"
 
 namespace fae
 {
+    namespace
+    {
+        struct lod_view
+        {
+            vec3 camera_position;
+            /* projected size in pixels of a unit sized object at unit distance */
+            float pixel_scale;
+        };
+
+        struct camera_view
+        {
+            transform transform;
+            camera camera;
+            float window_width;
+            float window_height;
+        };
+
+        /* the active camera & the size of the primary window, empty if either is missing */
+        auto find_camera(entity_commands& global_entity, ecs_world& ecs_world) noexcept -> std::optional<camera_view>
+        {
+            auto result = std::optional<camera_view>{};
+            global_entity.use_component<const active_camera>([&](const active_camera& active_camera)
+                {
+                    auto camera_entity = ecs_world.get_entity(active_camera.camera_entity);
+                    if (!camera_entity.valid())
+                        return;
+                    auto maybe_camera = camera_entity.get_component<camera>();
+                    auto maybe_camera_transform = camera_entity.get_component<transform>();
+                    if (!maybe_camera || !maybe_camera_transform)
+                        return;
+                    global_entity.use_component<const primary_window>([&](const primary_window& primary_window)
+                        {
+                            auto window_entity = ecs_world.get_entity(primary_window.window_entity);
+                            if (!window_entity.valid())
+                                return;
+                            auto maybe_window = window_entity.get_component<window>();
+                            if (!maybe_window)
+                                return;
+                            const auto window_size = maybe_window->get_size();
+                            const auto window_height = static_cast<float>(window_size.height);
+                            if (window_height <= 0.f)
+                                return;
+                            result = camera_view{
+                                .transform = *maybe_camera_transform,
+                                .camera = *maybe_camera,
+                                .window_width = static_cast<float>(window_size.width),
+                                .window_height = window_height,
+                            }; }); });
+            return result;
+        }
+
+        auto extract_camera(const camera_view& view, render_snapshot& snapshot) noexcept -> void
+        {
+            const auto& camera_transform = view.transform;
+            snapshot.has_camera = true;
+            snapshot.camera_position = camera_transform.position;
+            snapshot.view = math::lookAt(camera_transform.position, camera_transform.position + camera_transform.forward(), vec3(0.f, 1.f, 0.f));
+            snapshot.projection = math::perspective(math::radians(view.camera.fov), view.window_width / view.window_height, view.camera.near_plane, view.camera.far_plane);
+        }
+
+        auto lod_view_of(const camera_view& view) noexcept -> std::optional<lod_view>
+        {
+            const auto tan_half_fov = std::tan(math::radians(view.camera.fov) * 0.5f);
+            if (tan_half_fov <= 0.f)
+                return std::nullopt;
+            return lod_view{
+                .camera_position = view.transform.position,
+                .pixel_scale = view.window_height / (2.f * tan_half_fov),
+            };
+        }
+
+        auto select_lod(const lod_settings& settings, const lod_view& view, const mesh& mesh, const mat4& world_matrix, std::size_t current) noexcept -> std::size_t
+        {
+            const auto max_scale = std::max({ math::length(vec3(world_matrix[0])), math::length(vec3(world_matrix[1])), math::length(vec3(world_matrix[2])) });
+            const auto radius = mesh.bounds.radius * max_scale;
+            const auto center = vec3(world_matrix * vec4(mesh.bounds.center, 1.f));
+            const auto distance = math::distance(center, view.camera_position);
+            if (distance <= radius)
+            {
+                return 0;
+            }
+            const auto screen_size = 2.f * radius * view.pixel_scale / distance;
+
+            auto level_for = [&](float threshold_scale)
+            {
+                std::size_t level = 0;
+                for (auto threshold : settings.screen_size_thresholds)
+                {
+                    if (screen_size >= threshold * threshold_scale)
+                        break;
+                    ++level;
+                }
+                return std::min(level, mesh.lod_count() - 1);
+            };
+
+            const auto coarser = level_for(1.f - settings.hysteresis);
+            const auto finer = level_for(1.f + settings.hysteresis);
+            if (coarser > current)
+            {
+                return coarser;
+            }
+            if (finer < current)
+            {
+                return finer;
+            }
+            return std::min(current, mesh.lod_count() - 1);
+        }
+
+        /* world matrix of an entity drawn between its last two fixed step transforms, under its parent's */
+        auto interpolated_world_matrix(const entity_registry_t& registry, entity id, const fixed_step_interpolation& interpolation, float alpha) noexcept -> mat4
+        {
+            const auto* current = registry.try_get<const transform>(id);
+            if (!current)
+            {
+                return world_matrix_of(registry, id);
+            }
+            const auto local = interpolation.interpolate(*current, alpha).to_mat4();
+            const auto* parent = registry.try_get<const fae::parent>(id);
+            return parent ? world_matrix_of(registry, parent->value) * local : local;
+        }
+
+        /* frees a destroyed model's geometry & texture right away, meshes are otherwise only evicted once unused for a while */
+        auto release_model_gpu_resources(fae::webgpu& webgpu, entity_registry_t& registry, entity id) -> void
+        {
+            const auto& destroyed = registry.get<model>(id);
+            webgpu.geometry.release(destroyed.mesh);
+            webgpu.textures.erase(destroyed.material.diffuse.id.get());
+        }
+
+        /* created by rendering_plugin::init, so the pools are packed from the first model on */
+        auto model_group(entity_registry_t& registry)
+        {
+            return registry.group<model, visibility>(entt::get<>, entt::exclude<static_batched>);
+        }
+
+        /* sorts the model group like the global_transform pool, when that was sorted again or the group changed */
+        auto sort_models(ecs_world& ecs_world, render_order& order) -> void
+        {
+            auto& registry = ecs_world.registry;
+            auto missing = registry.view<model>(entt::exclude<visibility>);
+            if (missing.begin() != missing.end())
+            {
+                const auto ids = std::vector<entity>(missing.begin(), missing.end());
+                registry.insert<visibility>(ids.begin(), ids.end());
+            }
+
+            auto models = model_group(registry);
+            const auto* hierarchy = ecs_world.resources.get<const transform_hierarchy>();
+            const auto hierarchy_order = hierarchy ? hierarchy->order : 0;
+            if (hierarchy_order == order.hierarchy_order && !order.needs_sort)
+            {
+                return;
+            }
+            order.hierarchy_order = hierarchy_order;
+            order.needs_sort = false;
+
+            // models without a global_transform go last
+            const auto& globals = registry.storage<global_transform>();
+            auto index_of = [&](entity id)
+            { return globals.contains(id) ? globals.index(id) : globals.size(); };
+            models.sort([&](const entity lhs, const entity rhs)
+                { return index_of(lhs) < index_of(rhs); });
+        }
+    }
+
     auto rendering_plugin::init(application& app) const noexcept -> void
     {
         if (!app.global_entity.get_component<renderer>())
@@ -35,6 +207,7 @@ namespace fae
                 return;
             }
             auto webgpu_renderer = *maybe_webgpu_renderer;
+            app.ecs_world.registry.on_destroy<model>().connect<&release_model_gpu_resources>(*maybe_webgpu_renderer);
             app
                 .set_global_component<default_render_pipeline>(default_render_pipeline{
                     .render_pipeline = create_default_render_pipeline(app.ecs_world, app.global_entity, app.assets),
@@ -43,14 +216,126 @@ namespace fae
                     make_webgpu_renderer(app.ecs_world, app.global_entity));
         }
 
-        app.add_system<update_step>(update_rendering)
+        app
+            .set_global_component<lod_settings>(lod_settings{})
+            .set_global_component<static_batching_settings>(static_batching_settings{})
+            .set_global_component<stale_static_batches>(stale_static_batches{})
+            .set_global_component<render_order>(render_order{})
+            .set_global_component<render_snapshots>(render_snapshots{})
+            .set_global_component<render_thread>(render_thread{ pipelined });
+
+        [[maybe_unused]] auto models = model_group(app.ecs_world.registry);
+
+        // an entity's components are removed in no particular order when it is destroyed, losing static_batched marks the batch too
+        auto* stale = app.ecs_world.resources.get<stale_static_batches>();
+        auto& registry = app.ecs_world.registry;
+        registry.on_update<model>().connect<&stale_static_batches::mark_source>(*stale);
+        registry.on_destroy<model>().connect<&stale_static_batches::mark_source>(*stale);
+        registry.on_update<transform>().connect<&stale_static_batches::mark_source>(*stale);
+        registry.on_destroy<transform>().connect<&stale_static_batches::mark_source>(*stale);
+        registry.on_construct<visibility>().connect<&stale_static_batches::mark_hidden_source>(*stale);
+        registry.on_update<visibility>().connect<&stale_static_batches::mark_hidden_source>(*stale);
+        registry.on_destroy<static_batched>().connect<&stale_static_batches::mark_unbatched_source>(*stale);
+        registry.on_destroy<static_batch>().connect<&stale_static_batches::mark_batch>(*stale);
+
+        // entities join the model group at its end, out of order
+        auto* order = app.ecs_world.resources.get<render_order>();
+        registry.on_construct<model>().connect<&render_order::mark_unsorted>(*order);
+        registry.on_destroy<model>().connect<&render_order::mark_unsorted>(*order);
+        registry.on_construct<visibility>().connect<&render_order::mark_unsorted>(*order);
+        registry.on_destroy<visibility>().connect<&render_order::mark_unsorted>(*order);
+        registry.on_construct<static_batched>().connect<&render_order::mark_unsorted>(*order);
+        registry.on_destroy<static_batched>().connect<&render_order::mark_unsorted>(*order);
+
+        // after propagate_transforms, so batches, lods & the snapshot use this frame's world matrices
+        app.add_system<post_update_step>(build_static_batches)
+            .add_system<post_update_step>(select_lods, lod_hz > 0.f ? run_condition{}.at_hz(lod_hz).staggered() : run_condition{})
+            .add_system<post_update_step>(extract_render_snapshot)
+            .add_system<post_update_step>(update_rendering)
             .add_system<render_step>(render_models)
+            .add_system<stop_step>(finish_rendering)
             .add_system<window_resized>(resize_active_render_passes);
     }
 
-    auto update_rendering(const update_step& step) noexcept -> void
+    auto extract_render_snapshot(const post_update_step& step) noexcept -> void
+    {
+        [[maybe_unused]] auto allocations = allocation_scope("render_extraction");
+        auto maybe_snapshots = step.global_entity.get_component<render_snapshots>();
+        if (!maybe_snapshots)
+            return;
+        auto& snapshot = maybe_snapshots->back();
+        snapshot.clear();
+
+        step.global_entity.use_component<const ambient_light_info>([&](const ambient_light_info& info)
+            { snapshot.ambient_lights = info; });
+        step.global_entity.use_component<const directional_light_info>([&](const directional_light_info& info)
+            { snapshot.directional_lights = info; });
+        auto fixed_alpha = 1.f;
+        step.global_entity.use_component<const fae::time>([&](const fae::time& time)
+            {
+                snapshot.elapsed = time.elapsed().seconds_f32();
+                fixed_alpha = time.fixed_alpha;
+            });
+
+        const auto camera = find_camera(step.global_entity, step.ecs_world);
+        if (!camera)
+            return;
+        extract_camera(*camera, snapshot);
+
+        auto& registry = step.ecs_world.registry;
+        step.global_entity.use_component<render_order>([&](render_order& order)
+            { sort_models(step.ecs_world, order); });
+        const auto& globals = registry.storage<global_transform>();
+        const auto& interpolations = registry.storage<fixed_step_interpolation>();
+        const auto& lods = registry.storage<lod_state>();
+        for (auto [id, model, visibility] : model_group(registry).each())
+        {
+            if (!visibility.visible)
+                continue;
+
+            auto world_matrix = globals.contains(id) ? globals.get(id).matrix : world_matrix_of(registry, id);
+            if (interpolations.contains(id))
+            {
+                world_matrix = interpolated_world_matrix(registry, id, interpolations.get(id), fixed_alpha);
+            }
+
+            const auto lod = lods.contains(id) ? std::min(lods.get(id).level, model.mesh.lod_count() - 1) : 0;
+            snapshot.draws.push_back(render_snapshot::draw{ .model = &model, .world_matrix = world_matrix, .lod = lod });
+        }
+    }
+
+    auto select_lods(const post_update_step& step) noexcept -> void
+    {
+        const auto camera = find_camera(step.global_entity, step.ecs_world);
+        const auto view = camera ? lod_view_of(*camera) : std::nullopt;
+        if (!view)
+            return;
+
+        static const auto default_lod_settings = lod_settings{};
+        auto maybe_lod_settings = step.global_entity.get_component<const lod_settings>();
+        const auto& settings = maybe_lod_settings ? *maybe_lod_settings : default_lod_settings;
+
+        auto& registry = step.ecs_world.registry;
+        const auto& globals = registry.storage<global_transform>();
+        for (auto [id, model, visibility] : model_group(registry).each())
+        {
+            if (!visibility.visible || model.mesh.lod_count() <= 1)
+                continue;
+            const auto world_matrix = globals.contains(id) ? globals.get(id).matrix : world_matrix_of(registry, id);
+            auto& state = registry.get_or_emplace<lod_state>(id);
+            state.level = select_lod(settings, *view, model.mesh, world_matrix, state.level);
+        }
+    }
+
+    auto update_rendering(const post_update_step& step) noexcept -> void
     {
+        [[maybe_unused]] auto allocations = allocation_scope("rendering");
         static bool first_render_happened = false;
+        // the render thread is done with the front snapshot & the device once the last frame is submitted
+        step.global_entity.use_component<fae::render_thread>([&](fae::render_thread& render_thread)
+            { render_thread.wait(); });
+        step.global_entity.use_component<fae::render_snapshots>([&](fae::render_snapshots& snapshots)
+            { snapshots.publish(); });
         step.global_entity.use_component<fae::default_render_pipeline>([&](fae::default_render_pipeline& default_render_pipeline)
             { step.global_entity.use_component<fae::renderer>(
                   [&](fae::renderer& renderer)
@@ -78,26 +363,27 @@ namespace fae
                   }); });
     }
 
+    auto finish_rendering(const stop_step& step) noexcept -> void
+    {
+        step.global_entity.use_component<fae::render_thread>([&](fae::render_thread& render_thread)
+            { render_thread.wait(); });
+    }
+
     auto render_models(const render_step& step) noexcept -> void
     {
-        for (auto& [entity, model] : step.ecs_world.query<model>())
+        auto maybe_snapshots = step.global_entity.get_component<render_snapshots>();
+        if (!maybe_snapshots)
+            return;
+        for (const auto& draw : maybe_snapshots->front().draws)
         {
-            bool should_render = true;
-            entity.use_component<const visibility>([&](const fae::visibility& visibility)
-                { should_render = visibility.visible; });
-            if (!should_render)
-                continue;
-
-            auto transform = fae::transform{};
-            entity.use_component<const fae::transform>([&](const fae::transform& t)
-                { transform = t; });
-
-            step.render_pass.render_model(render_pass::render_model_args{ .model = model, .transform = transform });
+            step.render_pass.render_model(render_pass::render_model_args{ .model = *draw.model, .world_matrix = draw.world_matrix, .lod = draw.lod });
         }
     }
 
     auto resize_active_render_passes(const window_resized& e) noexcept -> void
     {
+        e.global_entity.use_component<fae::render_thread>([&](fae::render_thread& render_thread)
+            { render_thread.wait(); });
         e.global_entity.use_component<fae::renderer>([&](fae::renderer& renderer)
             {
             for (auto& render_pass : renderer.get_active_render_passes())
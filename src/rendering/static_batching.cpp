@@ -0,0 +1,247 @@
+#include "fae/rendering/rendering.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include "fae/application/application.hpp"
+#include "fae/math.hpp"
+#include "fae/transform_hierarchy.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        struct batch_key
+        {
+            std::size_t material_hash;
+            std::int32_t x;
+            std::int32_t y;
+            std::int32_t z;
+
+            auto operator==(const batch_key&) const noexcept -> bool = default;
+        };
+
+        struct batch_key_hash
+        {
+            auto operator()(const batch_key& key) const noexcept -> std::size_t
+            {
+                auto h = key.material_hash;
+                h = h * 73856093u ^ static_cast<std::size_t>(key.x);
+                h = h * 19349663u ^ static_cast<std::size_t>(key.y);
+                h = h * 83492791u ^ static_cast<std::size_t>(key.z);
+                return h;
+            }
+        };
+
+        struct batch
+        {
+            const fae::material* material;
+            std::vector<fae::entity> sources;
+            fae::mesh mesh;
+        };
+
+        auto hash_material(const material& material) noexcept -> std::size_t
+        {
+            // fnv-1a over the diffuse texture, materials are stored by value so identity is their content
+            std::uint64_t hash = 14695981039346656037ull;
+            auto mix = [&](const void* data, std::size_t size)
+            {
+                const auto* bytes = static_cast<const std::uint8_t*>(data);
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    hash = (hash ^ bytes[i]) * 1099511628211ull;
+                }
+            };
+            mix(&material.diffuse.width, sizeof(material.diffuse.width));
+            mix(&material.diffuse.height, sizeof(material.diffuse.height));
+            mix(material.diffuse.data.data(), material.diffuse.data.size() * sizeof(color));
+            return static_cast<std::size_t>(hash);
+        }
+
+        auto same_material(const material& lhs, const material& rhs) noexcept -> bool
+        {
+            return lhs.diffuse.width == rhs.diffuse.width &&
+                   lhs.diffuse.height == rhs.diffuse.height &&
+                   std::equal(lhs.diffuse.data.begin(), lhs.diffuse.data.end(), rhs.diffuse.data.begin(), rhs.diffuse.data.end(),
+                       [](const color& a, const color& b)
+                       { return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a; });
+        }
+
+        auto append_world_space(mesh& batch_mesh, const mesh& source, const mat4& model_matrix) -> void
+        {
+            const auto normal_matrix = math::transpose(math::inverse(mat3(model_matrix)));
+            const auto base_vertex = static_cast<std::uint32_t>(batch_mesh.vertices.size());
+
+            batch_mesh.vertices.reserve(batch_mesh.vertices.size() + source.vertices.size());
+            for (auto vertex : source.vertices)
+            {
+                vertex.position = vec3(model_matrix * vec4(vertex.position, 1.f));
+                const auto normal = normal_matrix * vertex.normal;
+                vertex.normal = math::length(normal) > 0.f ? math::normalize(normal) : normal;
+                batch_mesh.vertices.push_back(vertex);
+            }
+
+            const auto indices = source.lod_indices(0);
+            if (indices.empty())
+            {
+                const auto first = batch_mesh.indices.size();
+                batch_mesh.indices.resize(first + source.vertices.size());
+                std::iota(batch_mesh.indices.begin() + first, batch_mesh.indices.end(), base_vertex);
+                return;
+            }
+            batch_mesh.indices.reserve(batch_mesh.indices.size() + indices.size());
+            for (auto index : indices)
+            {
+                batch_mesh.indices.push_back(base_vertex + index);
+            }
+        }
+
+        /* destroys the stale batches, their remaining sources lose static_batched so they are batched again */
+        auto dissolve(entity_registry_t& registry, stale_static_batches& stale) -> void
+        {
+            if (stale.batches.empty())
+            {
+                return;
+            }
+            std::ranges::sort(stale.batches);
+            const auto [first, last] = std::ranges::unique(stale.batches);
+            stale.batches.erase(first, last);
+
+            auto sources = std::vector<entity>{};
+            for (auto [source, batched] : registry.view<const static_batched>().each())
+            {
+                if (std::ranges::binary_search(stale.batches, batched.batch))
+                {
+                    sources.push_back(source);
+                }
+            }
+            registry.remove<static_batched>(sources.begin(), sources.end());
+            for (auto batch : stale.batches)
+            {
+                if (registry.valid(batch))
+                {
+                    registry.destroy(batch);
+                }
+            }
+            // unbatching the sources & destroying the batches marked them again
+            stale.batches.clear();
+        }
+    }
+
+    auto stale_static_batches::mark_source(entity_registry_t& registry, entity id) -> void
+    {
+        if (const auto* batched = registry.try_get<const static_batched>(id))
+        {
+            batches.push_back(batched->batch);
+        }
+    }
+
+    auto stale_static_batches::mark_hidden_source(entity_registry_t& registry, entity id) -> void
+    {
+        if (!registry.get<const visibility>(id).visible)
+        {
+            mark_source(registry, id);
+        }
+    }
+
+    auto stale_static_batches::mark_unbatched_source(entity_registry_t& registry, entity id) -> void
+    {
+        batches.push_back(registry.get<const static_batched>(id).batch);
+    }
+
+    auto stale_static_batches::mark_batch([[maybe_unused]] entity_registry_t& registry, entity id) -> void
+    {
+        batches.push_back(id);
+    }
+
+    auto build_static_batches(const post_update_step& step) noexcept -> void
+    {
+        auto& registry = step.ecs_world.registry;
+        const auto* hierarchy = step.ecs_world.resources.get<const transform_hierarchy>();
+        step.global_entity.use_component<stale_static_batches>([&](stale_static_batches& stale)
+            {
+                // a source also moves with its parents, not only through its own transform
+                if (hierarchy)
+                {
+                    for (auto id : hierarchy->moved)
+                    {
+                        stale.mark_source(registry, id);
+                    }
+                }
+                dissolve(registry, stale); });
+
+        auto pending = registry.view<const model, const transform, const static_geometry>(entt::exclude<static_batched>);
+        if (pending.begin() == pending.end())
+        {
+            return;
+        }
+
+        auto cell_size = static_batching_settings{}.cell_size;
+        step.global_entity.use_component<const static_batching_settings>([&](const static_batching_settings& settings)
+            { cell_size = settings.cell_size; });
+
+        const auto& globals = registry.storage<global_transform>();
+        auto batches = std::unordered_map<batch_key, std::vector<batch>, batch_key_hash>{};
+        for (auto [entity, model, transform] : pending.each())
+        {
+            // batched once propagated, so the batch is built from the world matrix
+            if (hierarchy && !globals.contains(entity))
+            {
+                continue;
+            }
+            auto maybe_visibility = registry.try_get<const visibility>(entity);
+            if (maybe_visibility && !maybe_visibility->visible)
+            {
+                continue;
+            }
+
+            const auto world_matrix = world_matrix_of(registry, entity);
+            const auto center = vec3(world_matrix * vec4(model.mesh.bounds.center, 1.f));
+            const auto key = batch_key{
+                .material_hash = hash_material(model.material),
+                .x = static_cast<std::int32_t>(std::floor(center.x / cell_size)),
+                .y = static_cast<std::int32_t>(std::floor(center.y / cell_size)),
+                .z = static_cast<std::int32_t>(std::floor(center.z / cell_size)),
+            };
+
+            auto& candidates = batches[key];
+            auto it = std::find_if(candidates.begin(), candidates.end(), [&](const batch& batch)
+                { return same_material(*batch.material, model.material); });
+            if (it == candidates.end())
+            {
+                it = candidates.insert(candidates.end(), batch{ .material = &model.material });
+            }
+            it->sources.push_back(entity);
+            append_world_space(it->mesh, model.mesh, world_matrix);
+        }
+
+        for (auto& [key, candidates] : batches)
+        {
+            for (auto& batch : candidates)
+            {
+                batch.mesh.compute_bounds();
+                // models are owned by a group, adding the batch & static_batched components moves them in their pool
+                // so the material is read from a source again instead of through batch.material
+                auto batch_model = fae::model{
+                    .mesh = std::move(batch.mesh),
+                    .material = registry.get<const model>(batch.sources.front()).material,
+                };
+                const auto source_count = batch.sources.size();
+                auto batch_entity = step.ecs_world.create_entity();
+                batch_entity
+                    .set_component<name>(name{ .value = "static batch" })
+                    .set_component<transform>(transform{})
+                    .set_component<static_batch>(static_batch{ .source_count = source_count })
+                    .set_component<model>(std::move(batch_model));
+                for (auto source : batch.sources)
+                {
+                    registry.emplace<static_batched>(source, static_batched{ .batch = batch_entity.id });
+                }
+            }
+        }
+    }
+}
@@ -2,10 +2,36 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 
+#include "fae/filesystem/virtual_file_system.hpp"
 #include "fae/logging.hpp"
 
 namespace fae
 {
+    namespace
+    {
+        auto to_texture(stbi_uc* img_data, int width, int height, int channels) -> texture
+        {
+            auto data = std::vector<color>(width * height);
+            for (int i = 0; i < width * height; ++i)
+            {
+                data[i] = color{
+                    .r = img_data[i * channels + 0],
+                    .g = img_data[i * channels + 1],
+                    .b = img_data[i * channels + 2],
+                    .a = channels == 4 ? img_data[i * channels + 3] : static_cast<std::uint8_t>(255),
+                };
+            }
+
+            stbi_image_free(img_data);
+
+            return texture{
+                .width = static_cast<std::size_t>(width),
+                .height = static_cast<std::size_t>(height),
+                .data = std::move(data),
+            };
+        }
+    }
+
     auto texture::load(std::filesystem::path path) -> std::optional<texture>
     {
         int width, height, channels;
@@ -15,24 +41,26 @@ namespace fae
             fae::log_error(std::format("Failed to load texture {}, {}", path.string(), stbi_failure_reason()));
             return std::nullopt;
         }
+        return to_texture(img_data, width, height, channels);
+    }
 
-        auto data = std::vector<color>(width * height);
-        for (int i = 0; i < width * height; ++i)
+    auto texture::load(const std::filesystem::path& path, const virtual_file_system& vfs) -> std::optional<texture>
+    {
+        auto file = vfs.read(path);
+        if (!file)
         {
-            data[i] = color{
-                .r = img_data[i * channels + 0],
-                .g = img_data[i * channels + 1],
-                .b = img_data[i * channels + 2],
-                .a = channels == 4 ? img_data[i * channels + 3] : static_cast<std::uint8_t>(255),
-            };
+            fae::log_error(std::format("Failed to load texture {}, file not found", path.string()));
+            return std::nullopt;
         }
 
-        stbi_image_free(img_data);
-
-        return texture{
-            .width = static_cast<std::size_t>(width),
-            .height = static_cast<std::size_t>(height),
-            .data = std::move(data),
-        };
+        const auto bytes = file->data();
+        int width, height, channels;
+        auto *img_data = stbi_load_from_memory(bytes.data(), static_cast<int>(bytes.size()), &width, &height, &channels, 0);
+        if (!img_data)
+        {
+            fae::log_error(std::format("Failed to load texture {}, {}", path.string(), stbi_failure_reason()));
+            return std::nullopt;
+        }
+        return to_texture(img_data, width, height, channels);
     }
 }
@@ -1,6 +1,10 @@
 #include "fae/rendering/webgpu_renderer.hpp"
 
+#include <array>
 #include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <utility>
 
 #include "fae/core/vector.hpp"
 #include "fae/rendering/renderer.hpp"
@@ -16,11 +20,132 @@
 #include "fae/rendering/render_pass.hpp"
 #include "fae/rendering/model.hpp"
 #include "fae/ecs_world.hpp"
+#include "fae/flight_recorder.hpp"
+#include "fae/rendering/render_snapshot.hpp"
+#include "fae/rendering/render_thread.hpp"
 
 #include "fae/webgpu/default_render_pipeline.hpp"
 
 namespace fae
 {
+    namespace
+    {
+        /* everything after recording, only reads the pass & the snapshot so it can run on the render thread */
+        auto submit_render_pass(wgpu::Device device, wgpu::Instance instance, wgpu::Surface surface, webgpu::render_pass& render_pass, const webgpu::render_pipeline& render_pipeline, const render_snapshot& snapshot, std::pmr::memory_resource& memory) -> void
+        {
+            if (!render_pass.render_commands.empty())
+            {
+                global_uniforms_t global_uniforms;
+                global_uniforms.camera_world_position = snapshot.camera_position;
+                global_uniforms.time = snapshot.elapsed;
+
+                auto global_uniforms_buffer = create_buffer(device, "fae_global_uniforms_buffer", sizeof(global_uniforms_t), wgpu::BufferUsage::Uniform);
+
+                auto local_uniform_data = std::pmr::vector<std::uint8_t>(render_pass.render_commands.size() * render_pipeline.uniform_stride, 0, &memory);
+                for (std::size_t i = 0; i < render_pass.render_commands.size(); ++i)
+                {
+                    std::memcpy(local_uniform_data.data() + i * render_pipeline.uniform_stride, render_pass.render_commands[i].uniform_data.data(), sizeof(local_uniforms_t));
+                }
+                auto sizeof_uniforms = local_uniform_data.size();
+                auto local_uniforms_buffer = create_buffer(device, "fae_local_uniforms_buffer", sizeof_uniforms, wgpu::BufferUsage::Uniform);
+
+                auto queue = device.GetQueue();
+
+                queue.WriteBuffer(global_uniforms_buffer, 0, &global_uniforms, sizeof(global_uniforms_t));
+                queue.WriteBuffer(local_uniforms_buffer, 0, local_uniform_data.data(), sizeof_data(local_uniform_data));
+
+                auto ambient_light_info_buffer = create_buffer(device, "ambient_light_info_buffer", sizeof(fae::directional_light_info), wgpu::BufferUsage::Uniform);
+                queue.WriteBuffer(ambient_light_info_buffer, 0, &snapshot.ambient_lights, sizeof(fae::ambient_light_info));
+
+                auto directional_light_info_buffer = create_buffer(device, "fae_directional_light_info_buffer", sizeof(fae::directional_light_info), wgpu::BufferUsage::Uniform);
+                queue.WriteBuffer(directional_light_info_buffer, 0, &snapshot.directional_lights, sizeof(fae::directional_light_info));
+                // counted in the frame being recorded when the render thread gets to it, usually the one after the snapshot's
+                count_frame_uploaded_bytes(sizeof(global_uniforms_t) + sizeof_data(local_uniform_data) + sizeof(fae::ambient_light_info) + sizeof(fae::directional_light_info));
+                count_frame_draws(render_pass.render_commands.size());
+
+                std::uint32_t uniform_offset = 0;
+                auto bound_vertex_arena = std::optional<std::size_t>{};
+                auto bound_index_arena = std::optional<std::size_t>{};
+                for (auto& render_command : render_pass.render_commands)
+                {
+                    auto bind_entries = std::array<wgpu::BindGroupEntry, 6>{
+                        wgpu::BindGroupEntry{
+                            .binding = 0,
+                            .buffer = global_uniforms_buffer,
+                            .size = sizeof(global_uniforms_t),
+                        },
+                        wgpu::BindGroupEntry{
+                            .binding = 1,
+                            .buffer = local_uniforms_buffer,
+                            .size = sizeof(local_uniforms_t),
+                        },
+                        wgpu::BindGroupEntry{
+                            .binding = 2,
+                            .textureView = render_command.texture_view,
+                        },
+                        wgpu::BindGroupEntry{
+                            .binding = 3,
+                            .sampler = render_command.sampler,
+                        },
+                        wgpu::BindGroupEntry{
+                            .binding = 4,
+                            .buffer = ambient_light_info_buffer,
+                            .size = sizeof(fae::ambient_light_info),
+                        },
+                        wgpu::BindGroupEntry{
+                            .binding = 5,
+                            .buffer = directional_light_info_buffer,
+                            .size = sizeof(fae::directional_light_info),
+                        },
+                    };
+                    auto bind_group_descriptor = wgpu::BindGroupDescriptor{
+                        .label = "fae_bind_group",
+                        .layout = render_pipeline.render_pipeline.GetBindGroupLayout(0),
+                        .entryCount = static_cast<std::size_t>(bind_entries.size()),
+                        .entries = bind_entries.data(),
+                    };
+
+                    auto uniform_bind_group = device.CreateBindGroup(&bind_group_descriptor);
+                    render_pass.render_pass_encoder.SetBindGroup(0, uniform_bind_group, 1, &uniform_offset);
+                    uniform_offset += render_pipeline.uniform_stride;
+
+                    const auto& geometry = render_command.geometry;
+                    if (bound_vertex_arena != geometry.vertex_arena)
+                    {
+                        render_pass.render_pass_encoder.SetVertexBuffer(0, render_command.vertex_buffer);
+                        bound_vertex_arena = geometry.vertex_arena;
+                    }
+                    if (render_command.index_count > 0)
+                    {
+                        if (bound_index_arena != geometry.index_arena)
+                        {
+                            render_pass.render_pass_encoder.SetIndexBuffer(render_command.index_buffer, wgpu::IndexFormat::Uint32);
+                            bound_index_arena = geometry.index_arena;
+                        }
+                        render_pass.render_pass_encoder.DrawIndexed(
+                            render_command.index_count, 1,
+                            static_cast<std::uint32_t>(geometry.indices.offset) + render_command.first_index,
+                            static_cast<std::int32_t>(geometry.vertices.offset));
+                    }
+                    else
+                    {
+                        render_pass.render_pass_encoder.Draw(
+                            static_cast<std::uint32_t>(geometry.vertices.size), 1,
+                            static_cast<std::uint32_t>(geometry.vertices.offset));
+                    }
+                }
+            }
+
+            render_pass.render_pass_encoder.End();
+            auto command_buffer = render_pass.command_encoder.Finish();
+
+            device.GetQueue().Submit(1, &command_buffer);
+#ifndef FAE_PLATFORM_WEB
+            surface.Present();
+            instance.ProcessEvents();
+#endif
+        }
+    }
     [[nodiscard]] auto
     make_webgpu_renderer(ecs_world& ecs_world, entity_commands& global_entity) noexcept -> renderer
     {
@@ -68,11 +193,11 @@ namespace fae
                     {
                         auto webgpu_render_pass = webgpu::render_pass{
                             .render_pipeline_id = render_pipeline.get_id(),
-                            .render_commands = std::vector<webgpu::render_pass::render_command>(),
+                            .render_commands = std::pmr::vector<webgpu::render_pass::render_command>(ecs_world.frame_allocator()),
                             .label = "fae_render_pass",
                         };
                         id = webgpu.render_passes.size();
-                        webgpu.render_passes.push_back(webgpu_render_pass);
+                        webgpu.render_passes.push_back(std::move(webgpu_render_pass));
                         render_pipeline.prepare_render_pass(id);
 
                         // auto ui_render_pass = webgpu::render_pass{
@@ -98,189 +223,87 @@ namespace fae
                     { global_entity.use_component<fae::webgpu>(
                           [&](webgpu& webgpu)
                           {
-                              auto& render_pass = webgpu.render_passes[id];
-                              auto& render_pipeline = webgpu.render_pipelines[render_pass.render_pipeline_id];
+                              auto render_pass = std::move(webgpu.render_passes[id]);
+                              webgpu.render_passes.erase(webgpu.render_passes.begin() + id);
+                              auto render_pipeline = webgpu.render_pipelines[render_pass.render_pipeline_id];
 
-                              if (!render_pass.render_commands.empty())
+                              // buffers are resolved now, end_frame may move the geometry to new arenas (the old buffers live on until the frame is submitted)
+                              for (auto& render_command : render_pass.render_commands)
                               {
-                                  global_entity.use_component<fae::active_camera>([&](active_camera active_camera)
-                                      {
-                                        auto camera_entity = ecs_world.get_entity(active_camera.camera_entity);
-                                if (!camera_entity.valid())
-                                    return;
-                                    auto maybe_camera = camera_entity.get_component<fae::camera>();
-                            auto &camera = *maybe_camera;
-                            auto maybe_camera_transform = camera_entity.get_component<fae::transform>();
-                            auto &camera_transform = *maybe_camera_transform;
-
-                            global_uniforms_t global_uniforms;
-                            global_uniforms.camera_world_position = camera_transform.position;
-                            auto time = global_entity.get_or_set_component<fae::time>(fae::time{});
-                            auto t = time.elapsed().seconds_f32();
-                            global_uniforms.time = t;
-
-                            auto global_uniforms_buffer = create_buffer(webgpu.device, "fae_global_uniforms_buffer", sizeof(global_uniforms_t), wgpu::BufferUsage::Uniform);
-
-                            std::vector<std::uint8_t> local_uniform_data;
-                            for (auto& render_command : render_pass.render_commands)
-                            {
-                                auto data = std::vector<std::uint8_t>(render_pipeline.uniform_stride, 0);
-                                std::memcpy(data.data(), render_command.uniform_data.data(), sizeof(local_uniforms_t));
-                                local_uniform_data.insert(local_uniform_data.end(), data.begin(), data.end());
-                            }
-                            auto sizeof_uniforms = local_uniform_data.size() * render_pipeline.uniform_stride;
-                            auto local_uniforms_buffer = create_buffer(webgpu.device, "fae_local_uniforms_buffer", sizeof_uniforms, wgpu::BufferUsage::Uniform);
-
-                            auto queue = webgpu.device.GetQueue();
-
-                            queue.WriteBuffer(global_uniforms_buffer, 0, &global_uniforms, sizeof(global_uniforms_t));
-                            queue.WriteBuffer(local_uniforms_buffer, 0, local_uniform_data.data(), sizeof_data(local_uniform_data));
-
-                            auto ambient_light_info_buffer = create_buffer(webgpu.device, "ambient_light_info_buffer", sizeof(fae::directional_light_info), wgpu::BufferUsage::Uniform);
-                            global_entity.use_component<fae::ambient_light_info>([&](fae::ambient_light_info info)
-                                { queue.WriteBuffer(ambient_light_info_buffer, 0, &info, sizeof(fae::ambient_light_info)); });
-
-                            auto directional_light_info_buffer = create_buffer(webgpu.device, "fae_directional_light_info_buffer", sizeof(fae::directional_light_info), wgpu::BufferUsage::Uniform);
-                            global_entity.use_component<fae::directional_light_info>([&](fae::directional_light_info info)
-                                { queue.WriteBuffer(directional_light_info_buffer, 0, &info, sizeof(fae::directional_light_info)); });
-
-                            std::uint32_t uniform_offset = 0;
-                            for (auto& render_command : render_pass.render_commands)
-                            {
-                                auto bind_entries = std::vector<wgpu::BindGroupEntry>{
-                                    wgpu::BindGroupEntry{
-                                        .binding = 0,
-                                        .buffer = global_uniforms_buffer,
-                                        .size = sizeof(global_uniforms_t),
-                                    },
-                                    wgpu::BindGroupEntry{
-                                        .binding = 1,
-                                        .buffer = local_uniforms_buffer,
-                                        .size = sizeof(local_uniforms_t),
-                                    },
-                                    wgpu::BindGroupEntry{
-                                        .binding = 2,
-                                        .textureView = render_command.texture_view,
-                                    },
-                                    wgpu::BindGroupEntry{
-                                        .binding = 3,
-                                        .sampler = render_command.sampler,
-                                    },
-                                    wgpu::BindGroupEntry{
-                                        .binding = 4,
-                                        .buffer = ambient_light_info_buffer,
-                                        .size = sizeof(fae::ambient_light_info),
-                                    },
-                                    wgpu::BindGroupEntry{
-                                        .binding = 5,
-                                        .buffer = directional_light_info_buffer,
-                                        .size = sizeof(fae::directional_light_info),
-                                    },
-                                };
-                                auto bind_group_descriptor = wgpu::BindGroupDescriptor{
-                                    .label = "fae_bind_group",
-                                    .layout = render_pipeline.render_pipeline.GetBindGroupLayout(0),
-                                    .entryCount = static_cast<std::size_t>(bind_entries.size()),
-                                    .entries = bind_entries.data(),
-                                };
-
-                                auto uniform_bind_group = webgpu.device.CreateBindGroup(&bind_group_descriptor);
-                                render_pass.render_pass_encoder.SetBindGroup(0, uniform_bind_group, 1, &uniform_offset);
-                                uniform_offset += render_pipeline.uniform_stride;
-
-                                const auto vertex_buffer = create_buffer_with_data(
-                                    webgpu.device, "indexed_render_data_vertex_buffer", render_command.vertex_data.data(), sizeof_data(render_command.vertex_data),
-                                    wgpu::BufferUsage::Vertex);
-                                render_pass.render_pass_encoder.SetVertexBuffer(0, vertex_buffer);
-                                if (!render_command.index_data.empty())
-                                {
-                                    const auto index_buffer = create_buffer_with_data(
-                                        webgpu.device, "indexed_render_data_index_buffer", render_command.index_data.data(), sizeof_data(render_command.index_data),
-                                        wgpu::BufferUsage::Index);
-                                    render_pass.render_pass_encoder.SetIndexBuffer(index_buffer, wgpu::IndexFormat::Uint32);
-                                    render_pass.render_pass_encoder.DrawIndexed(render_command.index_data.size());
-                                }
-                                else
-                                {
-                                    render_pass.render_pass_encoder.Draw(render_command.vertex_data.size());
-                                }
-                            } });
+                                  render_command.vertex_buffer = webgpu.geometry.vertex_arenas[render_command.geometry.vertex_arena].buffer;
+                                  if (render_command.index_count > 0)
+                                  {
+                                      render_command.index_buffer = webgpu.geometry.index_arenas[render_command.geometry.index_arena].buffer;
+                                  }
                               }
+                              webgpu.geometry.end_frame(webgpu.device);
 
-                              render_pass.render_pass_encoder.End();
-                              auto command_buffer = render_pass.command_encoder.Finish();
-
-                              auto commands = std::vector<wgpu::CommandBuffer>{ command_buffer };
-                              webgpu.device.GetQueue().Submit(commands.size(), commands.data());
-#ifndef FAE_PLATFORM_WEB
-                              webgpu.surface.Present();
-                              webgpu.instance.ProcessEvents();
-#endif
-                              webgpu.render_passes.erase(webgpu.render_passes.begin() + id);
+                              static const auto empty_snapshot = render_snapshot{};
+                              auto maybe_snapshots = global_entity.get_component<render_snapshots>();
+                              const auto* snapshot = maybe_snapshots ? &maybe_snapshots->front() : &empty_snapshot;
+                              auto maybe_render_thread = global_entity.get_component<render_thread>();
+                              if (!maybe_render_thread)
+                              {
+                                  submit_render_pass(webgpu.device, webgpu.instance, webgpu.surface, render_pass, render_pipeline, *snapshot, *ecs_world.frame_allocator());
+                                  return;
+                              }
+                              // only reads the front snapshot & the recorded pass, the main thread waits for it before touching the device again
+                              maybe_render_thread->submit([device = webgpu.device, instance = webgpu.instance, surface = webgpu.surface, render_pass = std::move(render_pass), render_pipeline, snapshot](std::pmr::memory_resource& memory) mutable
+                                  { submit_render_pass(device, instance, surface, render_pass, render_pipeline, *snapshot, memory); });
                           }); },
                     .render_model = [&, id](const fae::render_pass::render_model_args& args)
                     { global_entity.use_component<fae::webgpu>([&, id](fae::webgpu& webgpu)
                           {
-                            auto &render_pass = webgpu.render_passes[id];
+                        auto maybe_snapshots = global_entity.get_component<render_snapshots>();
+                        if (!maybe_snapshots || !maybe_snapshots->front().has_camera)
+                            return;
+                        const auto& snapshot = maybe_snapshots->front();
+                        auto &render_pass = webgpu.render_passes[id];
 
                         local_uniforms_t local_uniforms;
-                        global_entity.use_component<fae::active_camera>([&](active_camera active_camera)
-                        {
-                            auto camera_entity = ecs_world.get_entity(active_camera.camera_entity);
-                            if (!camera_entity.valid())
-                                return;
-                                auto maybe_camera = camera_entity.get_component<fae::camera>();
-                            auto &camera = *maybe_camera;
-                            auto maybe_transform = camera_entity.get_component<fae::transform>();
-                            auto &camera_transform = *maybe_transform;
+                        local_uniforms.view = snapshot.view;
+                        local_uniforms.projection = snapshot.projection;
+                        local_uniforms.model = args.world_matrix;
 
-                            local_uniforms.view = math::lookAt(camera_transform.position, camera_transform.position + camera_transform.forward(), fae::vec3(0.f, 1.f, 0.f));
-                            global_entity.use_component<fae::primary_window>([&](fae::primary_window primary_window)
+                        const auto& diffuse = args.model.material.diffuse;
+                        auto maybe_texture_and_view = webgpu.textures.find(diffuse.id.get());
+                        if (maybe_texture_and_view == webgpu.textures.end())
                         {
-                            if (!global_entity.registry.valid(primary_window.window_entity))
-                                return;
-                            auto maybe_window =  ecs_world.get_entity(primary_window.window_entity).get_component<fae::window>();
-                            auto& window = *maybe_window;
-                            auto window_size = window.get_size();
-                            auto aspect_ratio = static_cast<float>(window_size.width) / static_cast<float>(window_size.height);
-
-                            local_uniforms.projection = math::perspective(math::radians(camera.fov), aspect_ratio, camera.near_plane, camera.far_plane); });
-                            local_uniforms.model = args.transform.to_mat4();
-
-                            static auto cache = std::unordered_map<const texture*, texture_and_view>();
-                            auto maybe_texture_and_view = cache.find(&args.model.material.diffuse);
-                            if (maybe_texture_and_view == cache.end())
-                            {
-                                maybe_texture_and_view = cache.insert({ &args.model.material.diffuse, create_texture_with_mips_and_view(webgpu.device, args.model.material.diffuse) }).first;
-                            }
-                            auto texture_and_view = maybe_texture_and_view->second;
+                            maybe_texture_and_view = webgpu.textures.insert({ diffuse.id.get(), create_texture_with_mips_and_view(webgpu.device, diffuse) }).first;
+                        }
+                        auto texture_and_view = maybe_texture_and_view->second;
 
-                            auto sample_descriptor = wgpu::SamplerDescriptor
-                            {
-                                .addressModeU = wgpu::AddressMode::Repeat,
-                                .addressModeV = wgpu::AddressMode::Repeat,
-                                .addressModeW = wgpu::AddressMode::Repeat,
-                                .magFilter = wgpu::FilterMode::Nearest,
-                                .minFilter = wgpu::FilterMode::Nearest,
-                                .mipmapFilter = wgpu::MipmapFilterMode::Nearest,
-                                .lodMinClamp = 0.f,
-                                .lodMaxClamp = 32.f,
-                                .compare = wgpu::CompareFunction::Undefined,
-                                .maxAnisotropy = 1,
-                            };
+                        auto sample_descriptor = wgpu::SamplerDescriptor
+                        {
+                            .addressModeU = wgpu::AddressMode::Repeat,
+                            .addressModeV = wgpu::AddressMode::Repeat,
+                            .addressModeW = wgpu::AddressMode::Repeat,
+                            .magFilter = wgpu::FilterMode::Nearest,
+                            .minFilter = wgpu::FilterMode::Nearest,
+                            .mipmapFilter = wgpu::MipmapFilterMode::Nearest,
+                            .lodMinClamp = 0.f,
+                            .lodMaxClamp = 32.f,
+                            .compare = wgpu::CompareFunction::Undefined,
+                            .maxAnisotropy = 1,
+                        };
 
-                            auto sampler = webgpu.device.CreateSampler(&sample_descriptor);
+                        auto sampler = webgpu.device.CreateSampler(&sample_descriptor);
 
-                        auto uniform_data = std::vector<std::uint8_t>(sizeof(local_uniforms_t));
+                        const auto maybe_geometry = webgpu.geometry.upload(webgpu.device, args.model.mesh);
+                        if (!maybe_geometry)
+                            return;
+                        const auto lod_indices = args.model.mesh.lod_indices(args.lod);
+                        auto uniform_data = std::pmr::vector<std::uint8_t>(sizeof(local_uniforms_t), ecs_world.frame_allocator());
                         std::memcpy(uniform_data.data(), &local_uniforms, sizeof(local_uniforms_t));
 
                         render_pass.render_commands.push_back(fae::webgpu::render_pass::render_command{
-                            .vertex_data = args.model.mesh.vertices,
-                            .index_data = args.model.mesh.indices,
-                            .uniform_data = uniform_data,
+                            .geometry = *maybe_geometry,
+                            .first_index = static_cast<std::uint32_t>(lod_indices.data() - args.model.mesh.indices.data()),
+                            .index_count = static_cast<std::uint32_t>(lod_indices.size()),
+                            .uniform_data = std::move(uniform_data),
                             .texture_view = texture_and_view.view,
                             .sampler = sampler,
-                  }); }); }); },
+                        }); }); },
                 };
             },
         };
@@ -1,29 +1,85 @@
 #include "fae/time.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 
 #include "fae/application/application.hpp"
+#include "fae/logging.hpp"
 
 namespace fae
 {
-    auto update_time(const update_step& step) noexcept -> void
+    auto update_time(const pre_update_step& step) noexcept -> void
     {
         auto& time = step.global_entity.use_component<fae::time>(
             [](fae::time& time)
             {
-                static auto last_time = std::chrono::high_resolution_clock::now();
-                auto current_time = std::chrono::high_resolution_clock::now();
-                time.unscaled_delta = current_time - last_time;
+                const auto current_time = std::chrono::steady_clock::now();
+                // the first frame has no previous frame to measure from
+                time.unscaled_delta = time.last_update == std::chrono::steady_clock::time_point{}
+                    ? duration{}
+                    : duration{ std::chrono::duration_cast<std::chrono::nanoseconds>(current_time - time.last_update) };
                 time.unscaled_elapsed += time.unscaled_delta;
-                last_time = current_time;
+                time.last_update = current_time;
+                if (time.unscaled_delta > duration{})
+                {
+                    time.frame_times[time.frame_time_count % time::frame_time_window] = time.unscaled_delta;
+                    ++time.frame_time_count;
+                }
             });
     }
 
+    auto store_fixed_step_transforms(const fixed_update_step& step) noexcept -> void
+    {
+        for (auto [id, interpolation, transform] : step.ecs_world.registry.view<fixed_step_interpolation, const fae::transform>().each())
+        {
+            interpolation.previous = transform;
+        }
+    }
+
+    auto fixed_step_interpolation::interpolate(const transform& current, float alpha) const noexcept -> transform
+    {
+        if (!previous)
+        {
+            return current;
+        }
+        return transform{
+            .position = math::mix(previous->position, current.position, alpha),
+            .rotation = math::slerp(previous->rotation, current.rotation, alpha),
+            .scale = math::mix(previous->scale, current.scale, alpha),
+        };
+    }
+
+    auto time::frame_time_percentile(float percentile) const noexcept -> duration
+    {
+        const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(frame_time_count, frame_time_window));
+        if (count == 0)
+        {
+            return duration{};
+        }
+        // nearest rank, selected from a copy so the ring keeps its order
+        auto sorted = frame_times;
+        const auto rank = static_cast<std::size_t>(std::ceil(std::clamp(percentile, 0.f, 1.f) * static_cast<float>(count)));
+        const auto index = rank > 0 ? rank - 1 : 0;
+        std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(index), sorted.begin() + static_cast<std::ptrdiff_t>(count));
+        return sorted[index];
+    }
+
     auto time_plugin::init(application& app) const noexcept -> void
     {
+        auto hz = static_cast<double>(fixed_hz);
+        if (!(hz > 0.0))
+        {
+            fae::log_error("time_plugin::fixed_hz must be positive, fixed steps run at 60hz instead");
+            hz = 60.0;
+        }
         app
-            .set_global_component<time>(time{})
-            .add_system<update_step>(update_time);
+            .set_global_component<time>(time{
+                .fixed_delta = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / hz)),
+                .max_fixed_steps = max_fixed_steps,
+            })
+            .add_system<pre_update_step>(update_time)
+            .add_system<fixed_update_step>(store_fixed_step_transforms);
     }
 
 }
@@ -0,0 +1,328 @@
+#include "fae/transform_batch.hpp"
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FAE_TRANSFORM_BATCH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FAE_TARGET_AVX2
+#else
+#define FAE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace fae
+{
+    // the kernels read transforms as 10 packed floats (the layout to_bytes() produces)
+    static_assert(sizeof(transform) == 10 * sizeof(float), "transform must be 10 packed floats");
+    static_assert(sizeof(mat4) == 16 * sizeof(float), "mat4 must be 16 packed floats");
+    static_assert(offsetof(transform, rotation) == 3 * sizeof(float) && offsetof(transform, scale) == 7 * sizeof(float), "transform layout changed");
+
+    namespace
+    {
+        constexpr std::size_t transform_floats = 10;
+
+        /* offsets of the components in a transform, in the order of transform_soa */
+        enum component : std::size_t
+        {
+            position_x = 0,
+            position_y = 1,
+            position_z = 2,
+            // glm quaternions store x, y, z, w
+            rotation_x = 3,
+            rotation_y = 4,
+            rotation_z = 5,
+            rotation_w = 6,
+            scale_x = 7,
+            scale_y = 8,
+            scale_z = 9,
+        };
+
+#if defined(FAE_TRANSFORM_BATCH_X86)
+        /* the 10 components of 4 transforms, one register per component */
+        struct sse_transforms
+        {
+            __m128 c[transform_floats];
+        };
+
+        auto load_sse(const transform* transforms) noexcept -> sse_transforms
+        {
+            const auto* floats = reinterpret_cast<const float*>(transforms);
+            auto result = sse_transforms{};
+            for (std::size_t i = 0; i < transform_floats; ++i)
+            {
+                result.c[i] = _mm_set_ps(floats[3 * transform_floats + i], floats[2 * transform_floats + i], floats[transform_floats + i], floats[i]);
+            }
+            return result;
+        }
+
+        auto load_sse(const transform_soa& soa, std::size_t first) noexcept -> sse_transforms
+        {
+            return sse_transforms{ .c = {
+                                       _mm_loadu_ps(soa.position_x + first),
+                                       _mm_loadu_ps(soa.position_y + first),
+                                       _mm_loadu_ps(soa.position_z + first),
+                                       _mm_loadu_ps(soa.rotation_x + first),
+                                       _mm_loadu_ps(soa.rotation_y + first),
+                                       _mm_loadu_ps(soa.rotation_z + first),
+                                       _mm_loadu_ps(soa.rotation_w + first),
+                                       _mm_loadu_ps(soa.scale_x + first),
+                                       _mm_loadu_ps(soa.scale_y + first),
+                                       _mm_loadu_ps(soa.scale_z + first),
+                                   } };
+        }
+
+        /* writes column column of 4 matrices, from one register per row */
+        auto store_column_sse(mat4* out, std::size_t column, __m128 x, __m128 y, __m128 z, __m128 w) noexcept -> void
+        {
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            _mm_storeu_ps(&out[0][column][0], x);
+            _mm_storeu_ps(&out[1][column][0], y);
+            _mm_storeu_ps(&out[2][column][0], z);
+            _mm_storeu_ps(&out[3][column][0], w);
+        }
+
+        /* to_mat4 on 4 lanes at once */
+        auto compose_sse(const sse_transforms& t, mat4* out) noexcept -> void
+        {
+            const auto one = _mm_set1_ps(1.f);
+            const auto two = _mm_set1_ps(2.f);
+            const auto zero = _mm_setzero_ps();
+            const auto& x = t.c[rotation_x];
+            const auto& y = t.c[rotation_y];
+            const auto& z = t.c[rotation_z];
+            const auto& w = t.c[rotation_w];
+            const auto xx = _mm_mul_ps(x, x);
+            const auto yy = _mm_mul_ps(y, y);
+            const auto zz = _mm_mul_ps(z, z);
+            const auto xz = _mm_mul_ps(x, z);
+            const auto xy = _mm_mul_ps(x, y);
+            const auto yz = _mm_mul_ps(y, z);
+            const auto wx = _mm_mul_ps(w, x);
+            const auto wy = _mm_mul_ps(w, y);
+            const auto wz = _mm_mul_ps(w, z);
+
+            const auto& sx = t.c[scale_x];
+            const auto& sy = t.c[scale_y];
+            const auto& sz = t.c[scale_z];
+            store_column_sse(out, 0,
+                _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+                zero);
+            store_column_sse(out, 1,
+                _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+                _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+                zero);
+            store_column_sse(out, 2,
+                _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+                _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+                zero);
+            store_column_sse(out, 3, t.c[position_x], t.c[position_y], t.c[position_z], one);
+        }
+
+        /* the 10 components of 8 transforms, one register per component */
+        struct avx2_transforms
+        {
+            __m256 c[transform_floats];
+        };
+
+        FAE_TARGET_AVX2 auto load_avx2(const transform* transforms) noexcept -> avx2_transforms
+        {
+            const auto* floats = reinterpret_cast<const float*>(transforms);
+            const auto stride = _mm256_setr_epi32(0, 10, 20, 30, 40, 50, 60, 70);
+            auto result = avx2_transforms{};
+            for (std::size_t i = 0; i < transform_floats; ++i)
+            {
+                result.c[i] = _mm256_i32gather_ps(floats + i, stride, sizeof(float));
+            }
+            return result;
+        }
+
+        FAE_TARGET_AVX2 auto load_avx2(const transform_soa& soa, std::size_t first) noexcept -> avx2_transforms
+        {
+            return avx2_transforms{ .c = {
+                                        _mm256_loadu_ps(soa.position_x + first),
+                                        _mm256_loadu_ps(soa.position_y + first),
+                                        _mm256_loadu_ps(soa.position_z + first),
+                                        _mm256_loadu_ps(soa.rotation_x + first),
+                                        _mm256_loadu_ps(soa.rotation_y + first),
+                                        _mm256_loadu_ps(soa.rotation_z + first),
+                                        _mm256_loadu_ps(soa.rotation_w + first),
+                                        _mm256_loadu_ps(soa.scale_x + first),
+                                        _mm256_loadu_ps(soa.scale_y + first),
+                                        _mm256_loadu_ps(soa.scale_z + first),
+                                    } };
+        }
+
+        /* writes column column of 8 matrices as two sse transposes */
+        FAE_TARGET_AVX2 auto store_column_avx2(mat4* out, std::size_t column, __m256 x, __m256 y, __m256 z, __m256 w) noexcept -> void
+        {
+            auto x_low = _mm256_castps256_ps128(x);
+            auto y_low = _mm256_castps256_ps128(y);
+            auto z_low = _mm256_castps256_ps128(z);
+            auto w_low = _mm256_castps256_ps128(w);
+            auto x_high = _mm256_extractf128_ps(x, 1);
+            auto y_high = _mm256_extractf128_ps(y, 1);
+            auto z_high = _mm256_extractf128_ps(z, 1);
+            auto w_high = _mm256_extractf128_ps(w, 1);
+            _MM_TRANSPOSE4_PS(x_low, y_low, z_low, w_low);
+            _MM_TRANSPOSE4_PS(x_high, y_high, z_high, w_high);
+            _mm_storeu_ps(&out[0][column][0], x_low);
+            _mm_storeu_ps(&out[1][column][0], y_low);
+            _mm_storeu_ps(&out[2][column][0], z_low);
+            _mm_storeu_ps(&out[3][column][0], w_low);
+            _mm_storeu_ps(&out[4][column][0], x_high);
+            _mm_storeu_ps(&out[5][column][0], y_high);
+            _mm_storeu_ps(&out[6][column][0], z_high);
+            _mm_storeu_ps(&out[7][column][0], w_high);
+        }
+
+        /* to_mat4 on 8 lanes at once */
+        FAE_TARGET_AVX2 auto compose_avx2(const avx2_transforms& t, mat4* out) noexcept -> void
+        {
+            const auto one = _mm256_set1_ps(1.f);
+            const auto two = _mm256_set1_ps(2.f);
+            const auto zero = _mm256_setzero_ps();
+            const auto& x = t.c[rotation_x];
+            const auto& y = t.c[rotation_y];
+            const auto& z = t.c[rotation_z];
+            const auto& w = t.c[rotation_w];
+            const auto xx = _mm256_mul_ps(x, x);
+            const auto yy = _mm256_mul_ps(y, y);
+            const auto zz = _mm256_mul_ps(z, z);
+            const auto xz = _mm256_mul_ps(x, z);
+            const auto xy = _mm256_mul_ps(x, y);
+            const auto yz = _mm256_mul_ps(y, z);
+            const auto wx = _mm256_mul_ps(w, x);
+            const auto wy = _mm256_mul_ps(w, y);
+            const auto wz = _mm256_mul_ps(w, z);
+
+            const auto& sx = t.c[scale_x];
+            const auto& sy = t.c[scale_y];
+            const auto& sz = t.c[scale_z];
+            store_column_avx2(out, 0,
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+                zero);
+            store_column_avx2(out, 1,
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+                zero);
+            store_column_avx2(out, 2,
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz),
+                zero);
+            store_column_avx2(out, 3, t.c[position_x], t.c[position_y], t.c[position_z], one);
+        }
+
+        FAE_TARGET_AVX2 auto compose_avx2(std::span<const transform> transforms, mat4* out) noexcept -> std::size_t
+        {
+            std::size_t i = 0;
+            for (; i + 8 <= transforms.size(); i += 8)
+            {
+                compose_avx2(load_avx2(transforms.data() + i), out + i);
+            }
+            return i;
+        }
+
+        FAE_TARGET_AVX2 auto compose_avx2(const transform_soa& transforms, mat4* out) noexcept -> std::size_t
+        {
+            std::size_t i = 0;
+            for (; i + 8 <= transforms.count; i += 8)
+            {
+                compose_avx2(load_avx2(transforms, i), out + i);
+            }
+            return i;
+        }
+
+        auto cpu_has_avx2() noexcept -> bool
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4]{};
+            __cpuid(info, 0);
+            if (info[0] < 7)
+            {
+                return false;
+            }
+            __cpuid(info, 1);
+            // the os must save the avx registers (osxsave & avx, then xcr0's sse & avx state bits)
+            constexpr int osxsave_and_avx = (1 << 27) | (1 << 28);
+            if ((info[2] & osxsave_and_avx) != osxsave_and_avx || (_xgetbv(0) & 6) != 6)
+            {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+
+        auto use_avx2() noexcept -> bool
+        {
+            static const auto has_avx2 = cpu_has_avx2();
+            return has_avx2;
+        }
+#endif
+
+        auto load(const transform_soa& soa, std::size_t i) noexcept -> transform
+        {
+            return transform{
+                .position = vec3(soa.position_x[i], soa.position_y[i], soa.position_z[i]),
+                .rotation = quat(soa.rotation_w[i], soa.rotation_x[i], soa.rotation_y[i], soa.rotation_z[i]),
+                .scale = vec3(soa.scale_x[i], soa.scale_y[i], soa.scale_z[i]),
+            };
+        }
+    }
+
+    auto compose_trs(std::span<const transform> transforms, std::span<mat4> out) noexcept -> void
+    {
+        std::size_t i = 0;
+#if defined(FAE_TRANSFORM_BATCH_X86)
+        if (use_avx2())
+        {
+            i = compose_avx2(transforms, out.data());
+        }
+        for (; i + 4 <= transforms.size(); i += 4)
+        {
+            compose_sse(load_sse(transforms.data() + i), out.data() + i);
+        }
+#endif
+        compose_trs_scalar(transforms.subspan(i), out.subspan(i));
+    }
+
+    auto compose_trs(const transform_soa& transforms, std::span<mat4> out) noexcept -> void
+    {
+        std::size_t i = 0;
+#if defined(FAE_TRANSFORM_BATCH_X86)
+        if (use_avx2())
+        {
+            i = compose_avx2(transforms, out.data());
+        }
+        for (; i + 4 <= transforms.count; i += 4)
+        {
+            compose_sse(load_sse(transforms, i), out.data() + i);
+        }
+#endif
+        for (; i < transforms.count; ++i)
+        {
+            out[i] = load(transforms, i).to_mat4();
+        }
+    }
+
+    auto compose_trs_scalar(std::span<const transform> transforms, std::span<mat4> out) noexcept -> void
+    {
+        for (std::size_t i = 0; i < transforms.size(); ++i)
+        {
+            out[i] = transforms[i].to_mat4();
+        }
+    }
+}
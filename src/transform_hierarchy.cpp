@@ -0,0 +1,351 @@
+#include "fae/transform_hierarchy.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "fae/application/application.hpp"
+#include "fae/logging.hpp"
+#include "fae/transform_batch.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        /* position of an entity when iterating the pool, entt iterates packed arrays back to front (& sorts that order) */
+        auto position_of(const entt::sparse_set& pool, entity id) noexcept -> std::size_t
+        {
+            return pool.size() - 1 - pool.index(id);
+        }
+
+        auto entity_at(const entt::sparse_set& pool, std::size_t position) noexcept -> entity
+        {
+            return pool.data()[pool.size() - 1 - position];
+        }
+
+        /* spreads the low 21 bits of value 3 bits apart */
+        auto spread_bits(std::uint64_t value) noexcept -> std::uint64_t
+        {
+            value &= 0x1fffff;
+            value = (value | value << 32) & 0x1f00000000ffff;
+            value = (value | value << 16) & 0x1f0000ff0000ff;
+            value = (value | value << 8) & 0x100f00f00f00f00f;
+            value = (value | value << 4) & 0x10c30c30c30c30c3;
+            value = (value | value << 2) & 0x1249249249249249;
+            return value;
+        }
+
+        auto morton_code(const vec3& position, float cell_size) noexcept -> std::uint64_t
+        {
+            constexpr auto half_range = static_cast<float>(1 << 20);
+            auto cell = [&](float value)
+            {
+                const auto clamped = std::clamp(std::floor(value / cell_size), -half_range, half_range - 1.f);
+                return static_cast<std::uint64_t>(static_cast<std::int64_t>(clamped) + (1 << 20));
+            };
+            return spread_bits(cell(position.x)) | spread_bits(cell(position.y)) << 1 | spread_bits(cell(position.z)) << 2;
+        }
+
+        auto sort_by_depth(entity_registry_t& registry, transform_hierarchy& hierarchy) -> void
+        {
+            auto& globals = registry.storage<global_transform>();
+            auto& locals = registry.storage<transform>();
+            auto& parents = registry.storage<fae::parent>();
+            const auto cell_size = hierarchy.spatial_cell_size > 0.f ? hierarchy.spatial_cell_size : 1.f;
+            for (auto [id, global] : globals.each())
+            {
+                global.spatial_key = 0;
+                if (hierarchy.spatial_order)
+                {
+                    // the world position of the last propagation, entities that were never propagated only have their local one
+                    const auto position = global.updated_pass > 0 ? global.position() : (locals.contains(id) ? locals.get(id).position : vec3(0.f));
+                    global.spatial_key = morton_code(position, cell_size);
+                }
+
+                // the chain ends at the first ancestor without a global_transform, bounded in case of a cycle
+                global.depth = 0;
+                auto ancestor = id;
+                while (global.depth < globals.size() && parents.contains(ancestor))
+                {
+                    ancestor = parents.get(ancestor).value;
+                    if (!globals.contains(ancestor))
+                    {
+                        break;
+                    }
+                    ++global.depth;
+                }
+            }
+            registry.sort<global_transform>([](const global_transform& lhs, const global_transform& rhs)
+                { return lhs.depth != rhs.depth ? lhs.depth < rhs.depth : lhs.spatial_key < rhs.spatial_key; });
+            // transforms in the same order, so propagation walks both pools front to back
+            registry.sort<transform, global_transform>();
+
+            hierarchy.level_ends.clear();
+            std::size_t index = 0;
+            for (auto it = globals.begin(); it != globals.end(); ++it, ++index)
+            {
+                const auto depth = globals.get(*it).depth;
+                if (index > 0 && depth != globals.get(*(it - 1)).depth)
+                {
+                    hierarchy.level_ends.push_back(index);
+                }
+            }
+            if (index > 0)
+            {
+                hierarchy.level_ends.push_back(index);
+            }
+
+            // children by pool position, so propagation can walk down from the entities that changed
+            hierarchy.child_offsets.assign(globals.size() + 1, 0);
+            hierarchy.child_indices.resize(globals.size());
+            auto parent_index = [&](entity id) -> std::size_t
+            {
+                if (!parents.contains(id))
+                    return globals.size();
+                const auto parent_id = parents.get(id).value;
+                return globals.contains(parent_id) ? position_of(globals, parent_id) : globals.size();
+            };
+            for (auto id : globals)
+            {
+                if (const auto parent = parent_index(id); parent < globals.size())
+                {
+                    ++hierarchy.child_offsets[parent + 1];
+                }
+            }
+            std::partial_sum(hierarchy.child_offsets.begin(), hierarchy.child_offsets.end(), hierarchy.child_offsets.begin());
+            // filling moves every offset to the end of its children, the start of the next entity's, shifted back after
+            for (std::size_t child = 0; child < globals.size(); ++child)
+            {
+                if (const auto parent = parent_index(entity_at(globals, child)); parent < globals.size())
+                {
+                    hierarchy.child_indices[hierarchy.child_offsets[parent]++] = child;
+                }
+            }
+            std::shift_right(hierarchy.child_offsets.begin(), hierarchy.child_offsets.end(), 1);
+            hierarchy.child_offsets.front() = 0;
+            hierarchy.needs_sort = false;
+            ++hierarchy.order;
+        }
+    }
+
+    auto set_parent(entity_registry_t& registry, entity child, entity parent) -> void
+    {
+        if (parent != entt::null)
+        {
+            if (parent == child)
+            {
+                fae::log_error("set_parent: an entity cannot be its own parent");
+                return;
+            }
+            // bounded in case parents were emplaced into a cycle without set_parent
+            const auto& parents = registry.storage<fae::parent>();
+            auto ancestor = parent;
+            for (std::size_t depth = 0; depth <= parents.size() && parents.contains(ancestor); ++depth)
+            {
+                ancestor = parents.get(ancestor).value;
+                if (ancestor == child)
+                {
+                    fae::log_error("set_parent: the parent is a descendant of the child, parenting it would make a cycle");
+                    return;
+                }
+            }
+        }
+        if (const auto* current = registry.try_get<fae::parent>(child))
+        {
+            if (auto* siblings = registry.try_get<children>(current->value))
+            {
+                std::erase(siblings->value, child);
+            }
+        }
+        if (parent == entt::null)
+        {
+            registry.remove<fae::parent>(child);
+            return;
+        }
+        registry.emplace_or_replace<fae::parent>(child, fae::parent{ .value = parent });
+        registry.get_or_emplace<children>(parent).value.push_back(child);
+    }
+
+    auto world_matrix_of(const entity_registry_t& registry, entity id) noexcept -> mat4
+    {
+        if (const auto* global = registry.try_get<global_transform>(id))
+        {
+            return global->matrix;
+        }
+        if (const auto* local = registry.try_get<transform>(id))
+        {
+            return local->to_mat4();
+        }
+        return mat4{ 1.f };
+    }
+
+    auto propagate_transforms(const post_update_step& step) noexcept -> void
+    {
+        auto& world = step.ecs_world;
+        auto& registry = world.registry;
+        auto* hierarchy = world.resources.get<transform_hierarchy>();
+        if (!hierarchy)
+        {
+            return;
+        }
+
+        // entities given a transform since the last propagation get a global_transform (which sorts the pool again)
+        auto& globals = registry.storage<global_transform>();
+        auto& locals = registry.storage<transform>();
+        for (auto id : hierarchy->dirty)
+        {
+            if (locals.contains(id) && !globals.contains(id))
+            {
+                globals.emplace(id);
+            }
+        }
+
+        // after a sort every matrix is recomputed, parents may have changed
+        const auto recompute_all = hierarchy->needs_sort;
+        if (hierarchy->needs_sort)
+        {
+            sort_by_depth(registry, *hierarchy);
+        }
+        const auto pass = ++hierarchy->pass;
+
+        // the dirty entities & their descendants, marked as updated in this pass so shared subtrees are walked once
+        auto& pending = hierarchy->pending;
+        pending.clear();
+        if (recompute_all)
+        {
+            pending.resize(globals.size());
+            std::iota(pending.begin(), pending.end(), std::size_t{ 0 });
+        }
+        else
+        {
+            for (auto id : hierarchy->dirty)
+            {
+                if (globals.contains(id))
+                {
+                    pending.push_back(position_of(globals, id));
+                }
+            }
+            for (std::size_t i = 0; i < pending.size(); ++i)
+            {
+                const auto index = pending[i];
+                auto& global = globals.get(entity_at(globals, index));
+                if (global.updated_pass == pass)
+                {
+                    continue;
+                }
+                global.updated_pass = pass;
+                for (auto child = hierarchy->child_offsets[index]; child < hierarchy->child_offsets[index + 1]; ++child)
+                {
+                    pending.push_back(hierarchy->child_indices[child]);
+                }
+            }
+            // parents come before their children in the pool, so in pool order every level only depends on the levels before it
+            std::ranges::sort(pending);
+            const auto [first, last] = std::ranges::unique(pending);
+            pending.erase(first, last);
+        }
+        hierarchy->dirty.clear();
+        hierarchy->pending_moved.assign(pending.size(), 0);
+
+        auto& parents = registry.storage<fae::parent>();
+        // local matrices are composed in batches (see compose_trs), then combined with their parent's
+        constexpr std::size_t batch_size = 64;
+        struct pending_update
+        {
+            global_transform* global;
+            const global_transform* parent_global;
+        };
+        auto update_batch = [&](std::size_t begin, std::size_t end)
+        {
+            auto updates = std::array<pending_update, batch_size>{};
+            auto pending_locals = std::array<transform, batch_size>{};
+            auto local_matrices = std::array<mat4, batch_size>{};
+            const auto count = end - begin;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto id = entity_at(globals, pending[begin + i]);
+                const global_transform* parent_global = nullptr;
+                if (parents.contains(id))
+                {
+                    const auto parent_id = parents.get(id).value;
+                    if (globals.contains(parent_id))
+                    {
+                        parent_global = &globals.get(parent_id);
+                    }
+                }
+                updates[i] = pending_update{ .global = &globals.get(id), .parent_global = parent_global };
+                pending_locals[i] = locals.contains(id) ? locals.get(id) : transform{};
+            }
+            compose_trs(std::span<const transform>(pending_locals.data(), count), local_matrices);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                auto& global = *updates[i].global;
+                const auto matrix = updates[i].parent_global ? updates[i].parent_global->matrix * local_matrices[i] : local_matrices[i];
+                hierarchy->pending_moved[begin + i] = matrix != global.matrix;
+                global.matrix = matrix;
+                global.updated_pass = pass;
+            }
+        };
+
+        // a level only reads the matrices of the levels before it, so its pending entities are updated in parallel
+        auto level_begin = pending.begin();
+        for (const auto level_end_index : hierarchy->level_ends)
+        {
+            const auto level_end = std::lower_bound(level_begin, pending.end(), level_end_index);
+            const auto offset = static_cast<std::size_t>(level_begin - pending.begin());
+            auto update_range = [&](std::size_t begin, std::size_t end)
+            {
+                for (auto i = begin; i < end; i += batch_size)
+                {
+                    update_batch(offset + i, offset + std::min(end, i + batch_size));
+                }
+            };
+            const auto count = static_cast<std::size_t>(level_end - level_begin);
+            if (world.jobs && count > 256)
+            {
+                world.jobs->parallel_for(count, 256, update_range);
+            }
+            else
+            {
+                update_range(0, count);
+            }
+            level_begin = level_end;
+        }
+
+        hierarchy->moved.clear();
+        for (std::size_t i = 0; i < pending.size(); ++i)
+        {
+            if (hierarchy->pending_moved[i])
+            {
+                hierarchy->moved.push_back(entity_at(globals, pending[i]));
+            }
+        }
+    }
+
+    auto transform_hierarchy_plugin::init(application& app) const noexcept -> void
+    {
+        app.set_global_component<transform_hierarchy>(transform_hierarchy{
+            .spatial_order = spatial_order,
+            .spatial_cell_size = spatial_cell_size,
+        });
+        auto* hierarchy = app.ecs_world.resources.get<transform_hierarchy>();
+        auto& registry = app.ecs_world.registry;
+        registry.on_construct<fae::parent>().connect<&transform_hierarchy::mark_unsorted>(*hierarchy);
+        registry.on_update<fae::parent>().connect<&transform_hierarchy::mark_unsorted>(*hierarchy);
+        registry.on_destroy<fae::parent>().connect<&transform_hierarchy::mark_unsorted>(*hierarchy);
+        registry.on_construct<global_transform>().connect<&transform_hierarchy::mark_unsorted>(*hierarchy);
+        registry.on_destroy<global_transform>().connect<&transform_hierarchy::mark_unsorted>(*hierarchy);
+        registry.on_construct<transform>().connect<&transform_hierarchy::mark_dirty>(*hierarchy);
+        registry.on_update<transform>().connect<&transform_hierarchy::mark_dirty>(*hierarchy);
+        registry.on_destroy<transform>().connect<&transform_hierarchy::mark_dirty>(*hierarchy);
+        for (auto id : registry.view<transform>())
+        {
+            hierarchy->dirty.push_back(id);
+        }
+        app.add_system<post_update_step>(propagate_transforms);
+    }
+}
@@ -17,7 +17,7 @@ auto fae::create_default_render_pipeline(fae::ecs_world& ecs_world, fae::entity_
         fae::log_fatal("webgpu resource not found");
     }
     auto& webgpu = *maybe_webgpu;
-    auto maybe_default_shader_module = create_shader_module_from_path(webgpu.device, "default_shader_module", assets.resolve_path("default.wgsl"));
+    auto maybe_default_shader_module = create_shader_module_from_path(webgpu.device, "default_shader_module", "default.wgsl", assets.vfs);
     if (!maybe_default_shader_module)
     {
         fae::log_fatal("failed to load shader module");
@@ -0,0 +1,229 @@
+#include "fae/webgpu/geometry_buffers.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "fae/core/vector.hpp"
+#include "fae/flight_recorder.hpp"
+#include "fae/rendering/mesh.hpp"
+#include "fae/webgpu/utils.hpp"
+
+namespace fae
+{
+    namespace
+    {
+        auto allocate_from(std::vector<geometry_buffers::arena>& arenas,
+            const wgpu::Device& device,
+            std::string_view label,
+            wgpu::BufferUsage usage,
+            std::size_t element_size,
+            std::size_t arena_capacity,
+            std::size_t count) -> std::pair<std::size_t, free_list_allocator::allocation>
+        {
+            for (std::size_t i = 0; i < arenas.size(); ++i)
+            {
+                if (auto allocation = arenas[i].allocator.allocate(count))
+                {
+                    return { i, *allocation };
+                }
+            }
+
+            const auto capacity = std::max(arena_capacity, count);
+            arenas.push_back(geometry_buffers::arena{
+                .buffer = create_buffer(device, label, capacity * element_size, usage | wgpu::BufferUsage::CopySrc),
+                .allocator = free_list_allocator(capacity),
+            });
+            return { arenas.size() - 1, *arenas.back().allocator.allocate(count) };
+        }
+
+        auto compact(std::vector<geometry_buffers::arena>& arenas,
+            std::size_t arena_index,
+            std::vector<free_list_allocator::allocation*> allocations,
+            const wgpu::Device& device,
+            wgpu::CommandEncoder& encoder,
+            std::string_view label,
+            wgpu::BufferUsage usage,
+            std::size_t element_size) -> void
+        {
+            auto& arena = arenas[arena_index];
+            const auto capacity = arena.allocator.capacity();
+            auto compacted = geometry_buffers::arena{
+                .buffer = create_buffer(device, label, capacity * element_size, usage | wgpu::BufferUsage::CopySrc),
+                .allocator = free_list_allocator(capacity),
+            };
+
+            std::ranges::sort(allocations, {}, &free_list_allocator::allocation::offset);
+            for (auto* allocation : allocations)
+            {
+                const auto moved = *compacted.allocator.allocate(allocation->size);
+                encoder.CopyBufferToBuffer(arena.buffer, allocation->offset * element_size,
+                    compacted.buffer, moved.offset * element_size,
+                    allocation->size * element_size);
+                *allocation = moved;
+            }
+            arena = std::move(compacted);
+        }
+    }
+
+    auto geometry_buffers::upload(const wgpu::Device& device, const mesh& mesh) -> std::optional<allocation>
+    {
+        if (auto it = m_allocations.find(mesh.id.get()); it != m_allocations.end())
+        {
+            auto& existing = it->second;
+            if (existing.source_vertices == mesh.vertices.data() && existing.vertices.size == mesh.vertices.size() &&
+                existing.source_indices == mesh.indices.data() && existing.indices.size == mesh.indices.size())
+            {
+                existing.last_used_frame = m_frame;
+                return existing;
+            }
+            release(existing);
+            m_allocations.erase(it);
+        }
+
+        if (mesh.vertices.empty())
+        {
+            return std::nullopt;
+        }
+
+        auto result = allocation{
+            .source_vertices = mesh.vertices.data(),
+            .source_indices = mesh.indices.data(),
+            .last_used_frame = m_frame,
+        };
+        auto queue = device.GetQueue();
+
+        std::tie(result.vertex_arena, result.vertices) = allocate_from(vertex_arenas, device, "fae_vertex_arena",
+            wgpu::BufferUsage::Vertex, sizeof(vertex), vertex_arena_capacity, mesh.vertices.size());
+        queue.WriteBuffer(vertex_arenas[result.vertex_arena].buffer, result.vertices.offset * sizeof(vertex),
+            mesh.vertices.data(), sizeof_data(mesh.vertices));
+        count_frame_uploaded_bytes(sizeof_data(mesh.vertices));
+
+        if (mesh.has_indices())
+        {
+            std::tie(result.index_arena, result.indices) = allocate_from(index_arenas, device, "fae_index_arena",
+                wgpu::BufferUsage::Index, sizeof(std::uint32_t), index_arena_capacity, mesh.indices.size());
+            queue.WriteBuffer(index_arenas[result.index_arena].buffer, result.indices.offset * sizeof(std::uint32_t),
+                mesh.indices.data(), sizeof_data(mesh.indices));
+            count_frame_uploaded_bytes(sizeof_data(mesh.indices));
+        }
+
+        m_allocations.insert_or_assign(mesh.id.get(), result);
+        return result;
+    }
+
+    auto geometry_buffers::release(const mesh& mesh) noexcept -> void
+    {
+        if (auto it = m_allocations.find(mesh.id.get()); it != m_allocations.end())
+        {
+            release(it->second);
+            m_allocations.erase(it);
+        }
+    }
+
+    auto geometry_buffers::end_frame(const wgpu::Device& device) -> void
+    {
+        std::erase_if(m_allocations, [&](const auto& entry)
+            {
+                const auto evict = m_frame - entry.second.last_used_frame > eviction_frames;
+                if (evict)
+                {
+                    release(entry.second);
+                }
+                return evict; });
+        ++m_frame;
+
+        auto is_fragmented = [&](const arena& arena)
+        {
+            return arena.allocator.fragmentation() > defragmentation_threshold;
+        };
+        if (std::ranges::any_of(vertex_arenas, is_fragmented) || std::ranges::any_of(index_arenas, is_fragmented))
+        {
+            defragment(device);
+        }
+    }
+
+    auto geometry_buffers::defragment(const wgpu::Device& device) -> void
+    {
+        auto encoder = device.CreateCommandEncoder();
+        auto has_copies = false;
+
+        for (std::size_t i = 0; i < vertex_arenas.size(); ++i)
+        {
+            if (vertex_arenas[i].allocator.fragmentation() <= defragmentation_threshold)
+            {
+                continue;
+            }
+            auto allocations = std::vector<free_list_allocator::allocation*>{};
+            for (auto& [source, allocation] : m_allocations)
+            {
+                if (allocation.vertex_arena == i)
+                {
+                    allocations.push_back(&allocation.vertices);
+                }
+            }
+            compact(vertex_arenas, i, std::move(allocations), device, encoder, "fae_vertex_arena", wgpu::BufferUsage::Vertex, sizeof(vertex));
+            has_copies = true;
+        }
+
+        for (std::size_t i = 0; i < index_arenas.size(); ++i)
+        {
+            if (index_arenas[i].allocator.fragmentation() <= defragmentation_threshold)
+            {
+                continue;
+            }
+            auto allocations = std::vector<free_list_allocator::allocation*>{};
+            for (auto& [source, allocation] : m_allocations)
+            {
+                if (allocation.index_arena == i && allocation.indices.size > 0)
+                {
+                    allocations.push_back(&allocation.indices);
+                }
+            }
+            compact(index_arenas, i, std::move(allocations), device, encoder, "fae_index_arena", wgpu::BufferUsage::Index, sizeof(std::uint32_t));
+            has_copies = true;
+        }
+
+        if (has_copies)
+        {
+            auto command_buffer = encoder.Finish();
+            device.GetQueue().Submit(1, &command_buffer);
+        }
+    }
+
+    auto geometry_buffers::get_statistics() const noexcept -> statistics
+    {
+        auto result = statistics{
+            .mesh_count = m_allocations.size(),
+            .vertex_arena_count = vertex_arenas.size(),
+            .index_arena_count = index_arenas.size(),
+        };
+
+        for (const auto& arena : vertex_arenas)
+        {
+            result.vertex_capacity += arena.allocator.capacity();
+            result.vertices_used += arena.allocator.used();
+            result.vertex_fragmentation = std::max(result.vertex_fragmentation, arena.allocator.fragmentation());
+        }
+        for (const auto& arena : index_arenas)
+        {
+            result.index_capacity += arena.allocator.capacity();
+            result.indices_used += arena.allocator.used();
+            result.index_fragmentation = std::max(result.index_fragmentation, arena.allocator.fragmentation());
+        }
+        return result;
+    }
+
+    auto geometry_buffers::release(const allocation& value) noexcept -> void
+    {
+        if (value.vertices.size > 0)
+        {
+            vertex_arenas[value.vertex_arena].allocator.free(value.vertices);
+        }
+        if (value.indices.size > 0)
+        {
+            index_arenas[value.index_arena].allocator.free(value.indices);
+        }
+    }
+}
@@ -8,6 +8,7 @@
 #include <emscripten/emscripten.h>
 #endif
 
+#include "fae/filesystem/virtual_file_system.hpp"
 #include "fae/logging.hpp"
 
 namespace fae
@@ -162,6 +163,21 @@ namespace fae
         return create_shader_module_from_str(device, label, shader_src);
     }
 
+    std::optional<wgpu::ShaderModule> create_shader_module_from_path(const wgpu::Device& device,
+        std::string_view label,
+        const std::filesystem::path& path,
+        const virtual_file_system& vfs)
+    {
+        auto file = vfs.read(path);
+        if (!file)
+        {
+            return std::nullopt;
+        }
+        // the wgsl source is read as a null terminated string, which a view into an archive is not
+        const auto shader_src = std::string(file->as_string_view());
+        return create_shader_module_from_str(device, label, shader_src);
+    }
+
     wgpu::Texture create_texture(const wgpu::Device& device,
         std::string_view label,
         wgpu::Extent3D extent,
@@ -11,6 +11,7 @@
 #include "fae/sdl.hpp"
 #include "fae/windowing.hpp"
 #include "fae/rendering/mesh.hpp"
+#include "fae/rendering/render_thread.hpp"
 #include "fae/lighting.hpp"
 #include "fae/webgpu/default_render_pipeline.hpp"
 
@@ -64,6 +65,9 @@ namespace fae
 
     auto reconfigure_on_window_resized(const fae::window_resized& e) noexcept -> void
     {
+        // the surface can't be reconfigured while the render thread presents to it
+        e.global_entity.use_component<fae::render_thread>([&](fae::render_thread& render_thread)
+            { render_thread.wait(); });
         e.global_entity.use_component<fae::webgpu>([&](webgpu& webgpu)
             {
             auto window_width = e.width;
@@ -16,7 +16,7 @@ namespace fae
 
     auto update_windows(const update_step& step) noexcept -> void
     {
-        for (auto [entity, window] : step.ecs_world.query<fae::window>())
+        for (auto [entity, window] : step.ecs_world.view<fae::window>())
         {
             window.update();
         }
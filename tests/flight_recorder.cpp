@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fae/flight_recorder.hpp"
+#include "test.hpp"
+
+namespace
+{
+    constexpr std::size_t ring_size = 16;
+    constexpr std::uint32_t frames_after_hitch = 4;
+
+    /* generous, so only the frames that sleep past it are hitches on a busy machine */
+    constexpr auto budget = std::chrono::milliseconds(50);
+    constexpr auto hitch_time = std::chrono::milliseconds(120);
+
+    [[nodiscard]] auto make_recorder(const std::filesystem::path& directory, std::uint32_t max_dumps) -> fae::flight_recorder
+    {
+        auto recorder = fae::flight_recorder{
+            .budget = std::chrono::nanoseconds(budget),
+            .frames_after_hitch = frames_after_hitch,
+            .directory = directory,
+            .max_dumps = max_dumps,
+        };
+        recorder.frames = std::vector<fae::flight_recorder::frame>(ring_size);
+        return recorder;
+    }
+
+    /* closes frames until frame_index is end, the frames in hitches sleep past the budget first */
+    auto record_frames(fae::flight_recorder& recorder, std::uint64_t end, const std::vector<std::uint64_t>& hitches) -> void
+    {
+        while (recorder.frame_index < end)
+        {
+            if (std::ranges::find(hitches, recorder.frame_index) != hitches.end())
+            {
+                std::this_thread::sleep_for(hitch_time);
+            }
+            recorder.end_frame(0, 0);
+        }
+    }
+
+    [[nodiscard]] auto read_file(const std::filesystem::path& path) -> std::string
+    {
+        auto file = std::ifstream(path);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    [[nodiscard]] auto has_frame(const std::string& dump, std::uint64_t index) -> bool
+    {
+        return dump.contains(std::format(R"({{"frame":{},)", index));
+    }
+}
+
+auto main() -> int
+{
+    const auto directory = std::filesystem::temp_directory_path() / "fae_test_flight_recorder";
+    std::filesystem::remove_all(directory);
+
+    // a hitch after the ring wrapped is dumped once the frames after it are recorded, with the ring's complete frames oldest first
+    {
+        auto recorder = make_recorder(directory / "window", 16);
+        record_frames(recorder, 30 + frames_after_hitch, { 30 });
+        fae::tests::check(recorder.hitches == 1, "the slow frame is a hitch");
+        fae::tests::check(recorder.dumps == 0, "no dump before the frames after the hitch are recorded");
+
+        record_frames(recorder, 30 + frames_after_hitch + 1, {});
+        recorder.wait_for_dumps();
+        fae::tests::check(recorder.dumps == 1, "the hitch is dumped once its window is complete");
+        const auto dump = read_file(directory / "window" / "hitch_30.json");
+        fae::tests::check(dump.contains(R"("hitch_frame":30)"), "the dump points out the hitch");
+        fae::tests::check(!has_frame(dump, 19) && has_frame(dump, 20), "the dump starts at the oldest frame still in the ring");
+        fae::tests::check(has_frame(dump, 30 + frames_after_hitch) && !has_frame(dump, 30 + frames_after_hitch + 1), "the dump ends at the last complete frame");
+
+        record_frames(recorder, 60, { 40 });
+        recorder.wait_for_dumps();
+        fae::tests::check(recorder.hitches == 2 && recorder.dumps == 2, "a later hitch gets a dump of its own");
+        fae::tests::check(std::filesystem::exists(directory / "window" / "hitch_40.json"), "the later hitch is written");
+    }
+
+    // hitches inside a pending window are part of its dump, max_dumps caps the dumps & not the hitches counted
+    {
+        auto recorder = make_recorder(directory / "capped", 1);
+        record_frames(recorder, 40, { 5, 7, 20 });
+        recorder.wait_for_dumps();
+        fae::tests::check(recorder.hitches == 3, "every slow frame is counted");
+        fae::tests::check(recorder.dumps == 1, "one dump at most");
+        const auto dump = read_file(directory / "capped" / "hitch_5.json");
+        fae::tests::check(has_frame(dump, 5) && has_frame(dump, 7), "the second hitch is in the first one's dump");
+        fae::tests::check(!std::filesystem::exists(directory / "capped" / "hitch_7.json"), "the second hitch has no dump of its own");
+        fae::tests::check(!std::filesystem::exists(directory / "capped" / "hitch_20.json"), "hitches past max_dumps are not written");
+    }
+
+    // a window longer than the ring is shortened, so the hitch is still in the ring when it is dumped
+    {
+        auto recorder = make_recorder(directory / "long_window", 16);
+        recorder.frames_after_hitch = 100;
+        recorder.format = fae::flight_recorder_format::csv;
+        record_frames(recorder, 40, { 20 });
+        recorder.wait_for_dumps();
+        const auto dump = read_file(directory / "long_window" / "hitch_20.csv");
+        fae::tests::check(dump.starts_with("frame,category,name,value\n"), "csv dumps start with their header");
+        fae::tests::check(dump.contains("\n20,frame_ms,,"), "the hitch is in the dump");
+    }
+
+    std::filesystem::remove_all(directory);
+    return fae::tests::exit_code();
+}
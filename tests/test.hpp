@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <print>
+#include <source_location>
+#include <string_view>
+
+namespace fae::tests
+{
+    /* exit code of a test that needs something this build does not have (e.g. a cmake option), ctest reports it as skipped */
+    constexpr int skipped = 77;
+
+    [[nodiscard]] inline auto failures() noexcept -> std::size_t&
+    {
+        static auto count = std::size_t{ 0 };
+        return count;
+    }
+
+    /* prints where & what failed if condition is false, main returns exit_code() once every check ran */
+    inline auto check(bool condition, std::string_view what, std::source_location location = std::source_location::current()) -> bool
+    {
+        if (!condition)
+        {
+            ++failures();
+            std::println(stderr, "{}:{}: check failed: {}", location.file_name(), location.line(), what);
+        }
+        return condition;
+    }
+
+    [[nodiscard]] inline auto exit_code() noexcept -> int
+    {
+        return failures() == 0 ? 0 : 1;
+    }
+}
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "fae/math.hpp"
+#include "fae/transform_batch.hpp"
+#include "test.hpp"
+
+namespace
+{
+    auto random_transforms(std::mt19937& random, std::size_t count) -> std::vector<fae::transform>
+    {
+        auto position = std::uniform_real_distribution<float>(-1000.f, 1000.f);
+        auto component = std::uniform_real_distribution<float>(-1.f, 1.f);
+        auto scale = std::uniform_real_distribution<float>(0.01f, 100.f);
+        auto transforms = std::vector<fae::transform>(count);
+        for (auto& transform : transforms)
+        {
+            transform.position = { position(random), position(random), position(random) };
+            auto rotation = fae::quat(component(random), component(random), component(random), component(random));
+            transform.rotation = fae::math::length(rotation) > 0.f ? fae::math::normalize(rotation) : fae::quat(1.f, 0.f, 0.f, 0.f);
+            // negative scales mirror, the kernels have no special case for them
+            transform.scale = { scale(random), -scale(random), scale(random) };
+        }
+        return transforms;
+    }
+
+    /* glm's own translate * rotate * scale, independent of transform::to_mat4 */
+    auto reference_matrix(const fae::transform& transform) -> fae::mat4
+    {
+        return fae::math::translate(fae::mat4{ 1.f }, transform.position) * fae::math::mat4_cast(transform.rotation) * fae::math::scale(fae::mat4{ 1.f }, transform.scale);
+    }
+
+    /* the matrices differ by rounding only, relative to the largest element */
+    auto nearly_equal(const fae::mat4& lhs, const fae::mat4& rhs) -> bool
+    {
+        auto largest = 1.f;
+        for (int column = 0; column < 4; ++column)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                largest = std::max(largest, std::abs(rhs[column][row]));
+            }
+        }
+        for (int column = 0; column < 4; ++column)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                if (std::abs(lhs[column][row] - rhs[column][row]) > 1e-5f * largest)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+auto main() -> int
+{
+    auto random = std::mt19937(42);
+    // counts around the 4 & 8 wide kernels, so every tail length is covered
+    for (std::size_t count = 0; count <= 35; ++count)
+    {
+        const auto transforms = random_transforms(random, count);
+        auto soa_floats = std::vector<std::vector<float>>(10, std::vector<float>(count));
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& transform = transforms[i];
+            const float components[] = {
+                transform.position.x, transform.position.y, transform.position.z,
+                transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w,
+                transform.scale.x, transform.scale.y, transform.scale.z
+            };
+            for (std::size_t component = 0; component < 10; ++component)
+            {
+                soa_floats[component][i] = components[component];
+            }
+        }
+        const auto soa = fae::transform_soa{
+            .position_x = soa_floats[0].data(),
+            .position_y = soa_floats[1].data(),
+            .position_z = soa_floats[2].data(),
+            .rotation_x = soa_floats[3].data(),
+            .rotation_y = soa_floats[4].data(),
+            .rotation_z = soa_floats[5].data(),
+            .rotation_w = soa_floats[6].data(),
+            .scale_x = soa_floats[7].data(),
+            .scale_y = soa_floats[8].data(),
+            .scale_z = soa_floats[9].data(),
+            .count = count,
+        };
+
+        auto packed = std::vector<fae::mat4>(count);
+        auto structure_of_arrays = std::vector<fae::mat4>(count);
+        auto scalar = std::vector<fae::mat4>(count);
+        fae::compose_trs(std::span<const fae::transform>(transforms), packed);
+        fae::compose_trs(soa, structure_of_arrays);
+        fae::compose_trs_scalar(transforms, scalar);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto where = std::format("transform {} of {}", i, count);
+            fae::tests::check(packed[i] == scalar[i], std::format("packed kernel matches compose_trs_scalar exactly, {}", where));
+            fae::tests::check(structure_of_arrays[i] == scalar[i], std::format("structure of arrays kernel matches compose_trs_scalar exactly, {}", where));
+            fae::tests::check(nearly_equal(packed[i], reference_matrix(transforms[i])), std::format("packed kernel matches glm, {}", where));
+            fae::tests::check(nearly_equal(transforms[i].to_mat4(), reference_matrix(transforms[i])), std::format("to_mat4 matches glm, {}", where));
+        }
+    }
+    return fae::tests::exit_code();
+}
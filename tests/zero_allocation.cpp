@@ -0,0 +1,80 @@
+#include <cstddef>
+#include <cstdint>
+
+#include "fae/allocation_tracker.hpp"
+#include "fae/application/application.hpp"
+#include "fae/math.hpp"
+#include "fae/time.hpp"
+#include "fae/transform_hierarchy.hpp"
+#include "test.hpp"
+
+namespace
+{
+    constexpr std::uint32_t warmup_frames = 30;
+    constexpr std::size_t frames = 300;
+    constexpr std::size_t entity_count = 2'000;
+
+    struct velocity
+    {
+        fae::vec3 value{ 0.f, 1.f, 0.f };
+    };
+
+    /* the kinds of work a frame does (hierarchy propagation, parallel iteration, frame queries, deferred commands), none of which should allocate once warm */
+    auto move(const fae::update_step& step) noexcept -> void
+    {
+        auto& world = step.ecs_world;
+        world.par_each<fae::transform, const velocity>([](fae::entity, fae::transform& transform, const velocity& velocity)
+            { transform.position += velocity.value * 0.01f; });
+        for (auto entity : world.registry.view<const fae::transform, const velocity>())
+        {
+            world.registry.patch<fae::transform>(entity);
+        }
+
+        auto& commands = world.commands();
+        for (auto& [entity, velocity] : world.query_frame<const velocity>())
+        {
+            commands.get_entity(entity.id).set_component(::velocity{ .value = -velocity.value });
+        }
+    }
+}
+
+// steps an application with the engine's simulation plugins & fails if frames allocate after warming up
+auto main() -> int
+{
+    if constexpr (!fae::is_tracking_allocations())
+    {
+        return fae::tests::skipped;
+    }
+
+    auto app = fae::application{};
+    app.add_plugin(fae::time_plugin{})
+        .add_plugin(fae::transform_hierarchy_plugin{})
+        .add_plugin(fae::allocation_tracking_plugin{ .zero_allocation_after_frames = warmup_frames })
+        .add_system<fae::update_step>(move);
+
+    auto parent = fae::entity{ entt::null };
+    for (std::size_t i = 0; i < entity_count; ++i)
+    {
+        auto entity = app.ecs_world.create_entity();
+        entity
+            .set_component<fae::transform>(fae::transform{ .position = { static_cast<float>(i), 0.f, 0.f } })
+            .set_component<velocity>(velocity{});
+        // chains of 10, so propagation walks a few levels
+        if (i % 10 != 0)
+        {
+            fae::set_parent(app.ecs_world.registry, entity.id, parent);
+        }
+        parent = entity.id;
+    }
+
+    app.is_running = true;
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        app.step();
+    }
+
+    const auto* budget = app.ecs_world.resources.get<const fae::allocation_budget>();
+    fae::tests::check(budget != nullptr, "allocation_tracking_plugin adds an allocation_budget");
+    fae::tests::check(budget && budget->violations == 0, "no frame allocates after the warmup (the logged errors list the tags that did)");
+    return fae::tests::exit_code();
+}